@@ -0,0 +1,70 @@
+# ============================================
+# 无界面基准测试程序：驱动N路Model解码本地文件或RTSP回环流
+# 统计帧率、每路CPU占用、帧延迟p50/p99及峰值内存，以JSON输出
+# ============================================
+QT       += core gui
+QT       -= widgets
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = rtsp_bench
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# 解决FFmpeg与标准库冲突的关键宏定义
+DEFINES += __STDC_CONSTANT_MACROS __STDC_FORMAT_MACROS
+
+# ============================================
+# 源代码目录定义（直接复用主程序模型层源码）
+# ============================================
+SOURCES_DIR = $$PWD/../src
+MODEL_DIR = $$SOURCES_DIR/model
+CONTROLLER_DIR = $$SOURCES_DIR/controller
+
+INCLUDEPATH += $$MODEL_DIR $$CONTROLLER_DIR
+
+SOURCES += \
+    $$PWD/main.cpp \
+    $$MODEL_DIR/model.cpp \
+    $$MODEL_DIR/DecodeEngine.cpp \
+    $$MODEL_DIR/FramePool.cpp \
+    $$MODEL_DIR/FrameMailbox.cpp \
+    $$MODEL_DIR/PacketRingBuffer.cpp \
+    $$MODEL_DIR/ReconnectScheduler.cpp \
+    $$MODEL_DIR/YuvConvert.cpp \
+    $$CONTROLLER_DIR/DetectionProtocol.cpp
+
+HEADERS += \
+    $$MODEL_DIR/model.h \
+    $$MODEL_DIR/DecodeEngine.h \
+    $$MODEL_DIR/FramePool.h \
+    $$MODEL_DIR/FrameMailbox.h \
+    $$MODEL_DIR/PacketRingBuffer.h \
+    $$MODEL_DIR/StreamConfig.h \
+    $$MODEL_DIR/ReconnectScheduler.h \
+    $$MODEL_DIR/StreamStats.h \
+    $$MODEL_DIR/YuvConvert.h \
+    $$CONTROLLER_DIR/DetectionProtocol.h
+
+# ============================================
+# 平台相关配置
+# ============================================
+
+# Windows 平台配置
+win32 {
+    FFMPEG_PATH = D:/Qt/ffmpeg-7.1.1-full_build-shared
+    INCLUDEPATH += $$FFMPEG_PATH/include
+    LIBS += -L$$FFMPEG_PATH/lib
+    LIBS += -lavcodec -lavformat -lavutil -lswscale
+
+    # 进程内存统计（GetProcessMemoryInfo）
+    LIBS += -lpsapi
+}
+
+# Linux 平台配置
+unix:!macx {
+    INCLUDEPATH += /usr/include/x86_64-linux-gnu
+    LIBS += -L/usr/lib/x86_64-linux-gnu
+    LIBS += -lavcodec -lavformat -lavutil -lswscale
+}
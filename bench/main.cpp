@@ -0,0 +1,601 @@
+// 无界面基准测试：驱动N路Model，模拟View::updateVideoFrame + presentVideoFrames的合成渲染路径
+// 用法示例：rtsp_bench --streams 9 --duration 30 --tile 640x360 sample.mp4 rtsp://127.0.0.1:8554/test
+//          rtsp_bench --convert-micro --tile 640x360 （色彩转换微基准，不需要输入源）
+//          rtsp_bench --protocol-micro --objects 30 （检测数据协议解析微基准，文本与二进制帧对比，不需要输入源）
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPixmap>
+#include <QPainter>
+#include <QTimer>
+#include <QFile>
+#include <QVector>
+#include <QDebug>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include "model.h"
+#include "YuvConvert.h"
+#include "DetectionProtocol.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// 每路视频流的统计数据
+struct BenchStream {
+    Model* model = nullptr;
+    QString source;                 // 输入源（本地文件或RTSP地址）
+    QVector<qint64> latenciesNs;    // 帧延迟样本（读包到渲染完成）
+    int displayedFrames = 0;        // 渲染帧数
+    qint64 renderTimeNs = 0;        // 累计渲染耗时
+    qint64 firstFrameMs = -1;       // 首帧耗时
+    QImage tileFrame;               // 模拟VideoLabel持有的帧拷贝
+    QRect tileRect;                 // 在合成画布中的位置
+    qint64 pendingTimestampNs = 0;  // 本次帧时钟内待合成帧的时间戳（0表示无新帧）
+};
+
+// 模拟VideoLabel::setFrame：尺寸格式不变时复用缓冲区
+static void copyFrame(QImage& dst, const QImage& src)
+{
+    if (!dst.isNull() && dst.size() == src.size() && dst.format() == src.format()) {
+        int bytes = qMin(dst.bytesPerLine(), src.bytesPerLine());
+        for (int y = 0; y < src.height(); ++y)
+            memcpy(dst.scanLine(y), src.constScanLine(y), static_cast<size_t>(bytes));
+    } else {
+        dst = src.copy();
+    }
+}
+
+// 进程累计CPU时间（用户态+内核态，毫秒）
+static qint64 processCpuTimeMs()
+{
+#ifdef Q_OS_WIN
+    FILETIME creation, exitTime, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernel, &user))
+        return 0;
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return static_cast<qint64>((k.QuadPart + u.QuadPart) / 10000); // 100ns -> ms
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return static_cast<qint64>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000
+         + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+#endif
+}
+
+// 进程峰值常驻内存（KB）
+static qint64 peakRssKb()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return 0;
+    return static_cast<qint64>(pmc.PeakWorkingSetSize / 1024);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef Q_OS_MACOS
+    return static_cast<qint64>(usage.ru_maxrss / 1024); // macOS单位为字节
+#else
+    return static_cast<qint64>(usage.ru_maxrss);        // Linux单位为KB
+#endif
+#endif
+}
+
+// 计算百分位数（毫秒），samples会被排序
+static double percentileMs(QVector<qint64>& samples, double percentile)
+{
+    if (samples.isEmpty())
+        return 0.0;
+    std::sort(samples.begin(), samples.end());
+    int index = qBound(0, static_cast<int>(percentile * (samples.size() - 1) + 0.5), samples.size() - 1);
+    return samples[index] / 1e6;
+}
+
+// 色彩转换微基准：合成YUV420P帧，对比sws_scale路径与SIMD快速路径
+// 每条路径统计转换耗时和QPixmap::fromImage耗时（RGB888需在此再转换一次，RGB32直接拷贝）
+static QJsonObject runConvertMicroBenchmark(const QSize& sourceSize, const QSize& tileSize, int iterations)
+{
+    AVFrame* frame = av_frame_alloc();
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width = sourceSize.width();
+    frame->height = sourceSize.height();
+    if (av_frame_get_buffer(frame, 32) < 0) {
+        av_frame_free(&frame);
+        return QJsonObject();
+    }
+    // 填充渐变图案，避免全零数据让缓存和分支预测过于理想
+    for (int plane = 0; plane < 3; ++plane) {
+        int w = plane == 0 ? frame->width : (frame->width + 1) / 2;
+        int h = plane == 0 ? frame->height : (frame->height + 1) / 2;
+        for (int y = 0; y < h; ++y) {
+            uint8_t* row = frame->data[plane] + y * frame->linesize[plane];
+            for (int x = 0; x < w; ++x)
+                row[x] = static_cast<uint8_t>((x * 3 + y * 7 + plane * 61) & 0xFF);
+        }
+    }
+
+    QSize targetSize = sourceSize.scaled(tileSize, Qt::KeepAspectRatio).boundedTo(sourceSize);
+    targetSize.setWidth(qMax(2, targetSize.width() & ~1));
+    targetSize.setHeight(qMax(2, targetSize.height() & ~1));
+
+    struct Path {
+        const char* name;
+        AVPixelFormat swsFormat;        // AV_PIX_FMT_NONE表示使用YuvConverter
+        QImage::Format imageFormat;
+    };
+    const Path paths[] = {
+        { "sws_rgb24", AV_PIX_FMT_RGB24, QImage::Format_RGB888 },
+        { "sws_rgb32", AV_PIX_FMT_RGB32, QImage::Format_RGB32 },
+        { "yuv_simd", AV_PIX_FMT_NONE, QImage::Format_RGB32 },
+    };
+
+    QJsonObject result;
+    result["source"] = QString("%1x%2").arg(sourceSize.width()).arg(sourceSize.height());
+    result["target"] = QString("%1x%2").arg(targetSize.width()).arg(targetSize.height());
+    result["iterations"] = iterations;
+    result["simd"] = YuvConverter::simdName();
+
+    QJsonArray pathArray;
+    for (const Path& path : paths) {
+        QImage image(targetSize, path.imageFormat);
+        SwsContext* sws_ctx = nullptr;
+        YuvConverter converter;
+        if (path.swsFormat != AV_PIX_FMT_NONE) {
+            sws_ctx = sws_getContext(frame->width, frame->height, AV_PIX_FMT_YUV420P,
+                                     targetSize.width(), targetSize.height(), path.swsFormat,
+                                     SWS_BILINEAR, nullptr, nullptr, nullptr);
+            if (!sws_ctx)
+                continue;
+        } else {
+            converter.configure(frame->width, frame->height, targetSize.width(), targetSize.height());
+        }
+
+        qint64 convertNs = 0;
+        qint64 uploadNs = 0;
+        QElapsedTimer timer;
+        for (int i = 0; i < iterations; ++i) {
+            timer.start();
+            if (sws_ctx) {
+                uint8_t* dstData[4] = { image.bits(), nullptr, nullptr, nullptr };
+                int dstLinesize[4] = { image.bytesPerLine(), 0, 0, 0 };
+                sws_scale(sws_ctx, frame->data, frame->linesize, 0, frame->height, dstData, dstLinesize);
+            } else {
+                converter.convert(frame, image.bits(), image.bytesPerLine());
+            }
+            convertNs += timer.nsecsElapsed();
+
+            timer.start();
+            QPixmap pixmap = QPixmap::fromImage(image);
+            uploadNs += timer.nsecsElapsed();
+        }
+        if (sws_ctx)
+            sws_freeContext(sws_ctx);
+
+        QJsonObject item;
+        item["path"] = path.name;
+        item["convert_ms"] = convertNs / 1e6 / iterations;
+        item["from_image_ms"] = uploadNs / 1e6 / iterations;
+        item["total_ms"] = (convertNs + uploadNs) / 1e6 / iterations;
+        pathArray.append(item);
+    }
+    result["paths"] = pathArray;
+
+    av_frame_free(&frame);
+    return result;
+}
+
+// 旧的解析方式：整块数据当作一条消息，转为QString后三层split
+static int legacyParseDetections(const QByteArray& data)
+{
+    QString trimmedData = QString::fromUtf8(data).trimmed();
+    if (!trimmedData.startsWith("DETECTIONS"))
+        return -1;
+    int pipe = trimmedData.indexOf('|');
+    QStringList objectParts = trimmedData.mid(pipe + 1).split("|");
+    int objects = 0;
+    for (const QString& objectInfo : objectParts) {
+        if (objectInfo.split(":").size() >= 2)
+            ++objects;
+    }
+    return objects;
+}
+
+// 按TCP分段大小切块送入分帧缓冲并解析（文本行或二进制帧），统计每秒消息数
+static QJsonObject runFramedParse(const QByteArray& stream, int chunkBytes, bool binary)
+{
+    DetectionFramer framer;
+    framer.setBinaryEnabled(binary);
+    DetectionFrame frame;
+    qint64 parsedMessages = 0;
+    qint64 parsedObjects = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int offset = 0; offset < stream.size(); offset += chunkBytes) {
+        framer.append(stream.constData() + offset, qMin(chunkBytes, stream.size() - offset));
+        FramedMessage message;
+        while (framer.nextMessage(&message)) {
+            bool ok = message.binary ? parseBinaryDetections(message.data, message.size, &frame)
+                                     : parseDetections(message.text(), &frame);
+            if (ok) {
+                ++parsedMessages;
+                parsedObjects += frame.objects.size();
+            }
+        }
+    }
+    qint64 elapsedNs = qMax<qint64>(1, timer.nsecsElapsed());
+    QJsonObject result;
+    result["bytes"] = stream.size();
+    result["parsed_messages"] = parsedMessages;
+    result["parsed_objects"] = parsedObjects;
+    result["messages_per_sec"] = parsedMessages * 1e9 / elapsedNs;
+    result["mb_per_sec"] = stream.size() * 1e3 / elapsedNs;
+    return result;
+}
+
+// 检测数据协议微基准：合成同样内容的DETECTIONS文本消息流和二进制帧流，分别分帧解析
+// 另对比旧方式（假设每次readyRead恰好一条消息，QString + split解析）
+static QJsonObject runProtocolMicroBenchmark(int messageCount, int objectsPerMessage, int chunkBytes)
+{
+    QByteArray textStream;
+    QByteArray binaryStream;
+    QVector<Detection> objects(objectsPerMessage);
+    for (int i = 0; i < messageCount; ++i) {
+        QByteArray message = "DETECTIONS:" + QByteArray::number(objectsPerMessage);
+        for (int j = 0; j < objectsPerMessage; ++j) {
+            Detection& detection = objects[j];
+            detection.classId = j % 80;
+            detection.className = QLatin1String("person");
+            detection.x = (i * 7 + j * 13) % 1920;
+            detection.y = (i * 5 + j * 11) % 1080;
+            detection.width = 40 + j % 200;
+            detection.height = 80 + j % 300;
+            detection.confidence = (500 + (i + j) % 499) / 1000.0f;
+            message += QString("|%1:%2:%3:%4:%5:%6:%7").arg(detection.classId).arg(detection.className)
+                           .arg(detection.x).arg(detection.y).arg(detection.width).arg(detection.height)
+                           .arg(detection.confidence, 0, 'f', 3).toLatin1();
+        }
+        textStream += message + "\r\n";
+        appendBinaryDetections(&binaryStream, 1 + i % 16, i * 33333LL, i * 3000LL,
+                               objects.constData(), objects.size());
+    }
+
+    QJsonObject result;
+    result["messages"] = messageCount;
+    result["objects_per_message"] = objectsPerMessage;
+    result["chunk_bytes"] = chunkBytes;
+    result["text"] = runFramedParse(textStream, chunkBytes, false);
+    result["binary"] = runFramedParse(binaryStream, chunkBytes, true);
+
+    // 旧方式：为了可比，按消息边界逐条送入（实际网络中分段会导致丢失或错误解析）
+    qint64 legacyMessages = 0;
+    QElapsedTimer timer;
+    timer.start();
+    int begin = 0;
+    while (begin < textStream.size()) {
+        int end = textStream.indexOf('\n', begin);
+        if (legacyParseDetections(textStream.mid(begin, end - begin + 1)) >= 0)
+            ++legacyMessages;
+        begin = end + 1;
+    }
+    qint64 legacyNs = qMax<qint64>(1, timer.nsecsElapsed());
+    QJsonObject legacy;
+    legacy["parsed_messages"] = legacyMessages;
+    legacy["messages_per_sec"] = legacyMessages * 1e9 / legacyNs;
+    result["legacy_split"] = legacy;
+    return result;
+}
+
+// 输出JSON到文件或标准输出
+static bool writeJson(const QJsonObject& result, const QString& fileName)
+{
+    QByteArray json = QJsonDocument(result).toJson(QJsonDocument::Indented);
+    if (!fileName.isEmpty()) {
+        QFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCritical() << "无法写入结果文件:" << file.fileName();
+            return false;
+        }
+        file.write(json);
+    } else {
+        fwrite(json.constData(), 1, static_cast<size_t>(json.size()), stdout);
+        fflush(stdout);
+    }
+    return true;
+}
+
+// 解析"WxH"格式的尺寸
+static QSize parseSize(const QString& text)
+{
+    const QStringList parts = text.split('x');
+    if (parts.size() != 2)
+        return QSize();
+    return QSize(parts[0].toInt(), parts[1].toInt());
+}
+
+// 解析解码策略名称
+static bool parsePolicy(const QString& name, DecodePolicy& policy)
+{
+    if (name == "full") policy = DecodePolicy::Full;
+    else if (name == "nth") policy = DecodePolicy::EveryNth;
+    else if (name == "keyframes") policy = DecodePolicy::KeyframesOnly;
+    else if (name == "demux") policy = DecodePolicy::DemuxOnly;
+    else return false;
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    // 无显示环境下使用offscreen平台插件，QPixmap仍走与界面相同的光栅路径
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QGuiApplication app(argc, argv);
+    QGuiApplication::setApplicationName("rtsp_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "解码-转换-渲染流水线基准测试，结果以JSON输出。\n"
+        "本地文件按解码速度读取（不按时间戳限速），读到结尾后经重连流程从头播放。");
+    parser.addHelpOption();
+    parser.addPositionalArgument("sources", "输入源（本地文件或RTSP地址），多路时循环分配", "<source...>");
+    QCommandLineOption streamsOption("streams", "视频流路数", "N", "4");
+    QCommandLineOption durationOption("duration", "测试时长（秒）", "S", "20");
+    QCommandLineOption warmupOption("warmup", "预热时长（秒），预热期间不计入统计", "S", "2");
+    QCommandLineOption tileOption("tile", "模拟的显示区域尺寸", "WxH", "640x360");
+    QCommandLineOption policyOption("policy", "解码策略：full/nth/keyframes/demux", "policy", "full");
+    QCommandLineOption tickOption("tick-ms", "帧时钟间隔（毫秒，模拟屏幕刷新）", "ms", "16");
+    QCommandLineOption outputOption("output", "JSON结果输出文件（默认输出到标准输出）", "file");
+    QCommandLineOption convertMicroOption("convert-micro", "只运行色彩转换微基准（sws_scale与SIMD快速路径对比）");
+    QCommandLineOption sourceSizeOption("source-size", "微基准的合成源帧尺寸", "WxH", "1920x1080");
+    QCommandLineOption iterationsOption("iterations", "微基准每条路径的迭代次数", "N", "300");
+    QCommandLineOption protocolMicroOption("protocol-micro", "只运行检测数据协议解析微基准（文本、二进制帧与旧split解析对比）");
+    QCommandLineOption messagesOption("messages", "协议微基准的消息条数", "N", "200000");
+    QCommandLineOption objectsOption("objects", "协议微基准每条消息的目标数", "N", "30");
+    QCommandLineOption chunkOption("chunk", "协议微基准每次送入的字节数（模拟TCP分段）", "bytes", "1448");
+    parser.addOption(streamsOption);
+    parser.addOption(durationOption);
+    parser.addOption(warmupOption);
+    parser.addOption(tileOption);
+    parser.addOption(policyOption);
+    parser.addOption(tickOption);
+    parser.addOption(outputOption);
+    parser.addOption(convertMicroOption);
+    parser.addOption(sourceSizeOption);
+    parser.addOption(iterationsOption);
+    parser.addOption(protocolMicroOption);
+    parser.addOption(messagesOption);
+    parser.addOption(objectsOption);
+    parser.addOption(chunkOption);
+    parser.process(app);
+
+    const int streamCount = qMax(1, parser.value(streamsOption).toInt());
+    const int durationSec = qMax(1, parser.value(durationOption).toInt());
+    const int warmupSec = qMax(0, parser.value(warmupOption).toInt());
+    const int tickMs = qMax(1, parser.value(tickOption).toInt());
+    const QSize tileSize = parseSize(parser.value(tileOption));
+    if (tileSize.isEmpty()) {
+        qCritical() << "无效的显示区域尺寸:" << parser.value(tileOption);
+        return 1;
+    }
+
+    if (parser.isSet(protocolMicroOption)) {
+        QJsonObject result = runProtocolMicroBenchmark(qMax(1, parser.value(messagesOption).toInt()),
+                                                       qMax(0, parser.value(objectsOption).toInt()),
+                                                       qMax(1, parser.value(chunkOption).toInt()));
+        return writeJson(result, parser.value(outputOption)) ? 0 : 1;
+    }
+
+    if (parser.isSet(convertMicroOption)) {
+        const QSize sourceSize = parseSize(parser.value(sourceSizeOption));
+        if (sourceSize.isEmpty()) {
+            qCritical() << "无效的源帧尺寸:" << parser.value(sourceSizeOption);
+            return 1;
+        }
+        QJsonObject result = runConvertMicroBenchmark(sourceSize, tileSize,
+                                                      qMax(1, parser.value(iterationsOption).toInt()));
+        return writeJson(result, parser.value(outputOption)) ? 0 : 1;
+    }
+
+    const QStringList sources = parser.positionalArguments();
+    if (sources.isEmpty()) {
+        qCritical() << "未指定输入源";
+        parser.showHelp(1);
+    }
+    DecodePolicy policy = DecodePolicy::Full;
+    if (!parsePolicy(parser.value(policyOption), policy)) {
+        qCritical() << "无效的解码策略:" << parser.value(policyOption);
+        return 1;
+    }
+
+    // 本地文件读到结尾按断线处理，缩短退避时间以便尽快从头播放
+    ReconnectScheduler::instance().setBackoff(50, 200);
+
+    QVector<BenchStream> streams(streamCount);
+    QElapsedTimer benchTimer;
+    benchTimer.start();
+    for (int i = 0; i < streamCount; ++i) {
+        BenchStream& stream = streams[i];
+        stream.source = sources[i % sources.size()];
+        stream.model = new Model;
+        stream.model->setOutputSize(tileSize);
+        stream.model->setDecodePolicy(policy);
+        QObject::connect(stream.model, &Model::firstFrameDecoded, [&streams, i](qint64, qint64 firstFrameMs) {
+            if (streams[i].firstFrameMs < 0)
+                streams[i].firstFrameMs = firstFrameMs;
+        });
+        stream.model->startStream(stream.source);
+    }
+
+    // 统计区间起点（预热结束时记录）
+    bool measuring = false;
+    QElapsedTimer measureTimer;
+    qint64 cpuStartMs = 0;
+    QVector<StreamCounters> startCounters(streamCount);
+
+    // 合成画布：按网格排列各路视频块，模拟videoContainer
+    const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(streamCount))));
+    const int rows = (streamCount + columns - 1) / columns;
+    QImage canvas(columns * tileSize.width(), rows * tileSize.height(), QImage::Format_RGB32);
+    canvas.fill(Qt::black);
+    for (int i = 0; i < streamCount; ++i) {
+        streams[i].tileRect = QRect(QPoint((i % columns) * tileSize.width(), (i / columns) * tileSize.height()),
+                                    tileSize);
+    }
+    qint64 compositeNs = 0;
+    int compositeCount = 0;
+
+    // 帧时钟：与Controller::onFrameTick相同，按固定节奏轮询各路最新帧，最后统一合成一次
+    QTimer frameTimer;
+    frameTimer.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&frameTimer, &QTimer::timeout, [&]() {
+        QElapsedTimer renderTimer;
+        int dirtyCount = 0;
+        for (BenchStream& stream : streams) {
+            FrameHandle frame;
+            if (!stream.model->takeLatestFrame(frame))
+                continue;
+            // 模拟View::updateVideoFrame：拷贝到视频块自有缓冲区，句柄随即归还帧池
+            renderTimer.start();
+            copyFrame(stream.tileFrame, frame.image());
+            stream.renderTimeNs += measuring ? renderTimer.nsecsElapsed() : 0;
+            stream.pendingTimestampNs = frame.timestampNs() > 0 ? frame.timestampNs() : -1;
+            ++dirtyCount;
+        }
+        if (dirtyCount == 0)
+            return;
+
+        // 模拟presentVideoFrames：所有有新帧的视频块在一次绘制中完成
+        renderTimer.start();
+        QPainter painter(&canvas);
+        for (BenchStream& stream : streams) {
+            if (stream.pendingTimestampNs == 0)
+                continue;
+            QSize size = stream.tileFrame.size();
+            QSize fitted = size.scaled(stream.tileRect.size(), Qt::KeepAspectRatio);
+            if (qAbs(fitted.width() - size.width()) > 2 || qAbs(fitted.height() - size.height()) > 2)
+                size = fitted;
+            QRect target(QPoint(0, 0), size);
+            target.moveCenter(stream.tileRect.center());
+            painter.setRenderHint(QPainter::SmoothPixmapTransform, target.size() != stream.tileFrame.size());
+            painter.drawImage(target, stream.tileFrame);
+        }
+        painter.end();
+        qint64 passNs = renderTimer.nsecsElapsed();
+
+        const qint64 nowNs = FrameHandle::monotonicNs();
+        for (BenchStream& stream : streams) {
+            if (stream.pendingTimestampNs == 0)
+                continue;
+            if (measuring) {
+                ++stream.displayedFrames;
+                stream.renderTimeNs += passNs / dirtyCount; // 合成耗时按参与的视频块均摊
+                if (stream.pendingTimestampNs > 0)
+                    stream.latenciesNs.append(nowNs - stream.pendingTimestampNs);
+            }
+            stream.pendingTimestampNs = 0;
+        }
+        if (measuring) {
+            compositeNs += passNs;
+            ++compositeCount;
+        }
+    });
+    frameTimer.start(tickMs);
+
+    QTimer::singleShot(warmupSec * 1000, [&]() {
+        for (int i = 0; i < streamCount; ++i)
+            startCounters[i] = streams[i].model->counters();
+        cpuStartMs = processCpuTimeMs();
+        measureTimer.start();
+        measuring = true;
+    });
+
+    QTimer::singleShot((warmupSec + durationSec) * 1000, [&]() {
+        frameTimer.stop();
+        const qint64 elapsedMs = qMax<qint64>(1, measureTimer.elapsed());
+        const double seconds = elapsedMs / 1000.0;
+        const qint64 cpuMs = processCpuTimeMs() - cpuStartMs;
+
+        QJsonArray streamArray;
+        QVector<qint64> allLatencies;
+        double totalDecodeFps = 0.0;
+        double totalDisplayFps = 0.0;
+        for (int i = 0; i < streamCount; ++i) {
+            BenchStream& stream = streams[i];
+            StreamCounters current = stream.model->counters();
+            StreamStats stats = StreamStats::fromCounters(current, startCounters[i], elapsedMs);
+            double displayFps = stream.displayedFrames / seconds;
+            totalDecodeFps += stats.decodeFps;
+            totalDisplayFps += displayFps;
+            allLatencies += stream.latenciesNs;
+
+            QJsonObject item;
+            item["id"] = i;
+            item["source"] = stream.source;
+            item["decode_fps"] = stats.decodeFps;
+            item["display_fps"] = displayFps;
+            item["dropped_frames"] = static_cast<qint64>(current.droppedFrames - startCounters[i].droppedFrames);
+            item["reconnects"] = static_cast<qint64>(current.reconnects - startCounters[i].reconnects);
+            item["bitrate_kbps"] = stats.bitrateKbps;
+            item["decode_time_ms"] = stats.decodeTimeMs;
+            item["scale_time_ms"] = stats.scaleTimeMs;
+            item["render_time_ms"] = stream.displayedFrames > 0
+                ? stream.renderTimeNs / 1e6 / stream.displayedFrames : 0.0;
+            item["first_frame_ms"] = stream.firstFrameMs;
+            item["latency_p50_ms"] = percentileMs(stream.latenciesNs, 0.50);
+            item["latency_p99_ms"] = percentileMs(stream.latenciesNs, 0.99);
+            streamArray.append(item);
+        }
+
+        QJsonObject summary;
+        summary["decode_fps"] = totalDecodeFps;
+        summary["display_fps"] = totalDisplayFps;
+        summary["cpu_percent"] = 100.0 * cpuMs / elapsedMs;
+        summary["cpu_percent_per_stream"] = 100.0 * cpuMs / elapsedMs / streamCount;
+        summary["latency_p50_ms"] = percentileMs(allLatencies, 0.50);
+        summary["latency_p99_ms"] = percentileMs(allLatencies, 0.99);
+        summary["composite_ms"] = compositeCount > 0 ? compositeNs / 1e6 / compositeCount : 0.0;
+        summary["peak_rss_kb"] = peakRssKb();
+        summary["decode_workers"] = DecodeEngine::instance().workerCount();
+        summary["decode_steals"] = static_cast<qint64>(DecodeEngine::instance().stolenCount());
+
+        QJsonObject config;
+        config["streams"] = streamCount;
+        config["duration_s"] = durationSec;
+        config["warmup_s"] = warmupSec;
+        config["tile"] = QString("%1x%2").arg(tileSize.width()).arg(tileSize.height());
+        config["policy"] = parser.value(policyOption);
+        config["tick_ms"] = tickMs;
+
+        QJsonObject result;
+        result["config"] = config;
+        result["summary"] = summary;
+        result["streams"] = streamArray;
+        QCoreApplication::exit(writeJson(result, parser.value(outputOption)) ? 0 : 1);
+    });
+
+    int ret = app.exec();
+
+    // 停止所有解码线程后再退出
+    for (BenchStream& stream : streams)
+        stream.model->stopStream();
+    for (BenchStream& stream : streams) {
+        stream.model->wait();
+        delete stream.model;
+    }
+    return ret;
+}
@@ -28,16 +28,33 @@ INCLUDEPATH += $$MODEL_DIR \
 SOURCES += \
     $$SOURCES_DIR/main.cpp \
     $$MODEL_DIR/model.cpp \
+    $$MODEL_DIR/DecodeEngine.cpp \
+    $$MODEL_DIR/FramePool.cpp \
+    $$MODEL_DIR/FrameMailbox.cpp \
+    $$MODEL_DIR/PacketRingBuffer.cpp \
+    $$MODEL_DIR/AlarmClipWriter.cpp \
+    $$MODEL_DIR/SegmentRecorder.cpp \
+    $$MODEL_DIR/SnapshotWriter.cpp \
+    $$MODEL_DIR/CameraConfigStore.cpp \
+    $$MODEL_DIR/ReconnectScheduler.cpp \
+    $$MODEL_DIR/StreamRegistry.cpp \
+    $$MODEL_DIR/YuvConvert.cpp \
     $$VIEW_DIR/mainwindow.cpp \
     $$VIEW_DIR/Picture.cpp \
     $$VIEW_DIR/VideoLabel.cpp \
+    $$VIEW_DIR/TileScaler.cpp \
     $$VIEW_DIR/detectlist.cpp \
     $$VIEW_DIR/plan.cpp \
     $$VIEW_DIR/view.cpp \
+    $$VIEW_DIR/EventLogModel.cpp \
+    $$VIEW_DIR/EventLogView.cpp \
     $$VIEW_DIR/AddCameraDialog.cpp \
+    $$VIEW_DIR/DecoderOptionsDialog.cpp \
     $$VIEW_DIR/DeviceDiscoveryDialog.cpp \
     $$CONTROLLER_DIR/controller.cpp \
     $$CONTROLLER_DIR/Tcpserver.cpp \
+    $$CONTROLLER_DIR/DetectionProtocol.cpp \
+    $$CONTROLLER_DIR/TcpNetworkWorker.cpp \
     $$CONTROLLER_DIR/DeviceDiscovery.cpp
 
 # ============================================
@@ -45,17 +62,36 @@ SOURCES += \
 # ============================================
 HEADERS += \
     $$MODEL_DIR/model.h \
+    $$MODEL_DIR/DecodeEngine.h \
+    $$MODEL_DIR/FramePool.h \
+    $$MODEL_DIR/FrameMailbox.h \
+    $$MODEL_DIR/PacketRingBuffer.h \
+    $$MODEL_DIR/AlarmClipWriter.h \
+    $$MODEL_DIR/SegmentRecorder.h \
+    $$MODEL_DIR/SnapshotWriter.h \
+    $$MODEL_DIR/StreamConfig.h \
+    $$MODEL_DIR/CameraConfigStore.h \
+    $$MODEL_DIR/ReconnectScheduler.h \
+    $$MODEL_DIR/StreamRegistry.h \
+    $$MODEL_DIR/StreamStats.h \
+    $$MODEL_DIR/YuvConvert.h \
     $$MODEL_DIR/common.h \
     $$VIEW_DIR/mainwindow.h \
     $$VIEW_DIR/Picture.h \
     $$VIEW_DIR/VideoLabel.h \
+    $$VIEW_DIR/TileScaler.h \
     $$VIEW_DIR/detectlist.h \
     $$VIEW_DIR/plan.h \
     $$VIEW_DIR/view.h \
+    $$VIEW_DIR/EventLogModel.h \
+    $$VIEW_DIR/EventLogView.h \
     $$VIEW_DIR/AddCameraDialog.h \
+    $$VIEW_DIR/DecoderOptionsDialog.h \
     $$VIEW_DIR/DeviceDiscoveryDialog.h \
     $$CONTROLLER_DIR/controller.h \
     $$CONTROLLER_DIR/Tcpserver.h \
+    $$CONTROLLER_DIR/DetectionProtocol.h \
+    $$CONTROLLER_DIR/TcpNetworkWorker.h \
     $$CONTROLLER_DIR/DeviceDiscovery.h
 
 # ============================================
@@ -0,0 +1,334 @@
+#include "DetectionProtocol.h"
+#include <QIODevice>
+#include <QStringList>
+#include <QtEndian>
+#include <qfloat16.h>
+#include <cstring>
+
+namespace {
+
+// 在[begin, end)中查找分隔符，找不到时返回end
+const char* findChar(const char* begin, const char* end, char c)
+{
+    const void* found = memchr(begin, c, static_cast<size_t>(end - begin));
+    return found ? static_cast<const char*>(found) : end;
+}
+
+// 解析十进制整数（可带负号），必须占满整个字段
+bool parseInt(const char* begin, const char* end, int* value)
+{
+    bool negative = begin < end && *begin == '-';
+    if (negative) {
+        ++begin;
+    }
+    if (begin == end || end - begin > 9) {
+        return false;
+    }
+    int result = 0;
+    for (const char* p = begin; p < end; ++p) {
+        if (*p < '0' || *p > '9') {
+            return false;
+        }
+        result = result * 10 + (*p - '0');
+    }
+    *value = negative ? -result : result;
+    return true;
+}
+
+// 解析置信度这类简单小数（[-]整数[.小数]），必须占满整个字段
+bool parseFloat(const char* begin, const char* end, float* value)
+{
+    bool negative = begin < end && *begin == '-';
+    if (negative) {
+        ++begin;
+    }
+    double result = 0.0;
+    double scale = 1.0;
+    bool digits = false;
+    bool fraction = false;
+    for (const char* p = begin; p < end; ++p) {
+        if (*p == '.' && !fraction) {
+            fraction = true;
+        } else if (*p >= '0' && *p <= '9') {
+            digits = true;
+            if (fraction) {
+                scale *= 0.1;
+                result += (*p - '0') * scale;
+            } else {
+                result = result * 10.0 + (*p - '0');
+            }
+        } else {
+            return false;
+        }
+    }
+    if (!digits) {
+        return false;
+    }
+    *value = static_cast<float>(negative ? -result : result);
+    return true;
+}
+
+// 解析一个目标：class_id:class_name:x:y:width:height:confidence
+bool parseObject(const char* begin, const char* end, Detection* detection)
+{
+    const char* starts[7];
+    const char* ends[7];
+    int count = 0;
+    starts[0] = begin;
+    for (const char* p = begin; p < end; ++p) {
+        if (*p == ':') {
+            if (count == 6) {
+                return false; // 字段过多
+            }
+            ends[count++] = p;
+            starts[count] = p + 1;
+        }
+    }
+    if (count != 6) {
+        return false;
+    }
+    ends[6] = end;
+
+    detection->className = QLatin1String(starts[1], static_cast<int>(ends[1] - starts[1]));
+    return parseInt(starts[0], ends[0], &detection->classId)
+        && parseInt(starts[2], ends[2], &detection->x)
+        && parseInt(starts[3], ends[3], &detection->y)
+        && parseInt(starts[4], ends[4], &detection->width)
+        && parseInt(starts[5], ends[5], &detection->height)
+        && parseFloat(starts[6], ends[6], &detection->confidence);
+}
+
+} // namespace
+
+QString DetectionFrame::summary() const
+{
+    if (objects.isEmpty()) {
+        return QString("%1个物体").arg(total);
+    }
+    QStringList categories;
+    categories.reserve(objects.size());
+    for (int i = 0; i < objects.size(); ++i) {
+        const Detection& detection = objects[i];
+        if (detection.className.size() > 0) {
+            categories.append(QString("%1:%2").arg(i + 1).arg(detection.className));
+        } else {
+            categories.append(QString("%1:类别%2").arg(i + 1).arg(detection.classId));
+        }
+    }
+    return QString("%1个物体,%2").arg(total).arg(categories.join(";"));
+}
+
+DetectionFramer::DetectionFramer()
+    : m_readPos(0), m_scanPos(0), m_binaryEnabled(false), m_overflows(0)
+{
+}
+
+qint64 DetectionFramer::readFrom(QIODevice* device)
+{
+    qint64 available = device->bytesAvailable();
+    if (available <= 0) {
+        return 0;
+    }
+    compact();
+    int oldSize = m_buffer.size();
+    int chunk = static_cast<int>(qMin<qint64>(available, MaxMessageBytes * 4));
+    m_buffer.resize(oldSize + chunk);
+    qint64 bytesRead = device->read(m_buffer.data() + oldSize, chunk);
+    m_buffer.resize(oldSize + static_cast<int>(qMax<qint64>(0, bytesRead)));
+    return qMax<qint64>(0, bytesRead);
+}
+
+void DetectionFramer::append(const char* data, int size)
+{
+    compact();
+    m_buffer.append(data, size);
+}
+
+bool DetectionFramer::nextMessage(FramedMessage* message)
+{
+    while (true) {
+        const char* base = m_buffer.constData();
+        const char* end = base + m_buffer.size();
+        if (m_binaryEnabled && m_readPos < m_buffer.size()
+            && static_cast<quint8>(base[m_readPos]) == DetectionBinary::Magic) {
+            // 二进制帧：等帧头和负载全部到达
+            const char* header = base + m_readPos;
+            if (end - header < DetectionBinary::HeaderBytes) {
+                return false;
+            }
+            quint32 length = qFromLittleEndian<quint32>(header + 4);
+            if (static_cast<quint8>(header[1]) != DetectionBinary::Version || length > MaxMessageBytes) {
+                // 帧头错误：丢弃到下一个行尾，由后续的文本行或帧头重新同步
+                ++m_overflows;
+                const char* newline = findChar(header + 1, end, '\n');
+                m_readPos = m_scanPos = static_cast<int>(newline - base) + (newline < end ? 1 : 0);
+                continue;
+            }
+            if (end - header < DetectionBinary::HeaderBytes + static_cast<qint64>(length)) {
+                return false;
+            }
+            message->binary = true;
+            message->type = static_cast<quint8>(header[2]);
+            message->data = header + DetectionBinary::HeaderBytes;
+            message->size = static_cast<int>(length);
+            m_readPos = m_scanPos = m_readPos + DetectionBinary::HeaderBytes + static_cast<int>(length);
+            return true;
+        }
+
+        const char* newline = findChar(base + m_scanPos, end, '\n');
+        if (newline == end) {
+            m_scanPos = m_buffer.size();
+            if (m_scanPos - m_readPos > MaxMessageBytes) {
+                // 对端发送了没有行尾的超长数据：丢弃，等下一个行尾重新同步
+                ++m_overflows;
+                m_readPos = m_scanPos;
+            }
+            return false;
+        }
+
+        const char* begin = base + m_readPos;
+        const char* lineEnd = newline;
+        if (lineEnd > begin && lineEnd[-1] == '\r') {
+            --lineEnd;
+        }
+        m_readPos = m_scanPos = static_cast<int>(newline - base) + 1;
+        if (lineEnd > begin) {
+            message->binary = false;
+            message->type = 0;
+            message->data = begin;
+            message->size = static_cast<int>(lineEnd - begin);
+            return true;
+        }
+        // 空行跳过
+    }
+}
+
+void DetectionFramer::clear()
+{
+    m_buffer.clear();
+    m_readPos = 0;
+    m_scanPos = 0;
+    m_binaryEnabled = false;
+}
+
+void DetectionFramer::compact()
+{
+    if (m_readPos == 0) {
+        return;
+    }
+    // 只移动未取出的尾部（通常为空或不足一条消息），缓冲区容量保留
+    int remaining = m_buffer.size() - m_readPos;
+    if (remaining > 0) {
+        memmove(m_buffer.data(), m_buffer.constData() + m_readPos, static_cast<size_t>(remaining));
+    }
+    m_buffer.resize(remaining);
+    m_scanPos -= m_readPos;
+    m_readPos = 0;
+}
+
+bool parseDetections(QLatin1String message, DetectionFrame* frame)
+{
+    static const char Prefix[] = "DETECTIONS:";
+    static const int PrefixLength = sizeof(Prefix) - 1;
+
+    frame->clear();
+    // 兼容首尾带空白的旧客户端
+    const char* begin = message.data();
+    const char* end = begin + message.size();
+    while (begin < end && (*begin == ' ' || *begin == '\t')) {
+        ++begin;
+    }
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) {
+        --end;
+    }
+    if (end - begin < PrefixLength || memcmp(begin, Prefix, PrefixLength) != 0) {
+        return false;
+    }
+    begin += PrefixLength;
+
+    const char* field = findChar(begin, end, '|');
+    if (!parseInt(begin, field, &frame->total) || frame->total < 0) {
+        return false;
+    }
+    while (field < end) {
+        const char* objectBegin = field + 1;
+        field = findChar(objectBegin, end, '|');
+        Detection detection;
+        if (parseObject(objectBegin, field, &detection)) {
+            frame->objects.append(detection);
+        } else {
+            ++frame->malformed;
+        }
+    }
+    return true;
+}
+
+bool parseBinaryDetections(const char* data, int size, DetectionFrame* frame)
+{
+    frame->clear();
+    if (size < DetectionBinary::DetectionsHeaderBytes) {
+        return false;
+    }
+    const uchar* p = reinterpret_cast<const uchar*>(data);
+    int count = qFromLittleEndian<quint16>(p + 2);
+    if (size != DetectionBinary::DetectionsHeaderBytes + count * DetectionBinary::BoxBytes) {
+        return false;
+    }
+    frame->cameraId = qFromLittleEndian<quint16>(p);
+    frame->total = count;
+    frame->timestampUs = qFromLittleEndian<qint64>(p + 4);
+    frame->pts = qFromLittleEndian<qint64>(p + 12);
+    frame->objects.resize(count);
+
+    p += DetectionBinary::DetectionsHeaderBytes;
+    for (int i = 0; i < count; ++i, p += DetectionBinary::BoxBytes) {
+        Detection& detection = frame->objects[i];
+        detection.classId = qFromLittleEndian<quint16>(p);
+        detection.className = QLatin1String();
+        detection.x = qFromLittleEndian<qint16>(p + 2);
+        detection.y = qFromLittleEndian<qint16>(p + 4);
+        detection.width = qFromLittleEndian<qint16>(p + 6);
+        detection.height = qFromLittleEndian<qint16>(p + 8);
+        qfloat16 confidence;
+        quint16 bits = qFromLittleEndian<quint16>(p + 10);
+        memcpy(&confidence, &bits, sizeof(bits));
+        detection.confidence = confidence;
+    }
+    return true;
+}
+
+void appendBinaryDetections(QByteArray* out, int cameraId, qint64 timestampUs, qint64 pts,
+                            const Detection* objects, int count)
+{
+    count = qBound(0, count, 0xFFFF);
+    const int payloadBytes = DetectionBinary::DetectionsHeaderBytes + count * DetectionBinary::BoxBytes;
+    const int offset = out->size();
+    out->resize(offset + DetectionBinary::HeaderBytes + payloadBytes);
+    uchar* p = reinterpret_cast<uchar*>(out->data()) + offset;
+
+    p[0] = DetectionBinary::Magic;
+    p[1] = DetectionBinary::Version;
+    p[2] = DetectionBinary::TypeDetections;
+    p[3] = 0;
+    qToLittleEndian<quint32>(static_cast<quint32>(payloadBytes), p + 4);
+    p += DetectionBinary::HeaderBytes;
+
+    qToLittleEndian<quint16>(static_cast<quint16>(qBound(0, cameraId, 0xFFFF)), p);
+    qToLittleEndian<quint16>(static_cast<quint16>(count), p + 2);
+    qToLittleEndian<qint64>(timestampUs, p + 4);
+    qToLittleEndian<qint64>(pts, p + 12);
+    p += DetectionBinary::DetectionsHeaderBytes;
+
+    for (int i = 0; i < count; ++i, p += DetectionBinary::BoxBytes) {
+        const Detection& detection = objects[i];
+        qToLittleEndian<quint16>(static_cast<quint16>(qBound(0, detection.classId, 0xFFFF)), p);
+        qToLittleEndian<qint16>(static_cast<qint16>(qBound(-32768, detection.x, 32767)), p + 2);
+        qToLittleEndian<qint16>(static_cast<qint16>(qBound(-32768, detection.y, 32767)), p + 4);
+        qToLittleEndian<qint16>(static_cast<qint16>(qBound(-32768, detection.width, 32767)), p + 6);
+        qToLittleEndian<qint16>(static_cast<qint16>(qBound(-32768, detection.height, 32767)), p + 8);
+        qfloat16 confidence(detection.confidence);
+        quint16 bits;
+        memcpy(&bits, &confidence, sizeof(bits));
+        qToLittleEndian<quint16>(bits, p + 10);
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <QByteArray>
+#include <QLatin1String>
+#include <QString>
+#include <QVarLengthArray>
+
+class QIODevice;
+
+// 检测数据协议，同一连接上文本消息和二进制帧可以混合出现：
+// 文本消息：每条以\r\n结尾（与DEVICE_x:OP_y:VALUE_z等控制指令格式相同）
+//   DETECTIONS:总数|class_id:class_name:x:y:width:height:confidence|...
+//   例：DETECTIONS:2|0:person:209:2:506:475:0.843|62:tv:633:313:57:62:0.774
+// 二进制帧：客户端先发送文本握手"HELLO:DETBIN/1"，服务端回复"HELLO_OK:DETBIN/1"后才可发送
+//   帧头8字节：0xB5 0x01 | 消息类型(1) | 保留(1) | 负载长度(uint32)
+//   检测消息负载：摄像头ID(uint16) | 目标数(uint16) | 时间戳微秒(int64) | 帧PTS(int64)
+//                 | 每个目标12字节：class_id(uint16) x y width height(int16) 置信度(float16)
+//   多字节字段均为小端序；帧头首字节不是ASCII字符，可与文本消息区分
+// • DetectionFramer切分TCP字节流，消息跨多次readyRead或一次收到多条时都能正确分帧
+// • 解析直接在接收缓冲上进行，不分配内存（类别名为指向缓冲区的视图）
+
+// 单个检测目标
+struct Detection {
+    int classId = 0;
+    QLatin1String className;   // 指向接收缓冲区，仅在解析该消息期间有效（二进制帧没有类别名）
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    float confidence = 0.0f;
+};
+
+// 一条检测消息的解析结果（反复使用同一对象时不重新分配内存）
+struct DetectionFrame {
+    int total = 0;                            // 消息声明的目标总数
+    int malformed = 0;                        // 格式错误被跳过的目标数
+    int cameraId = 0;                         // 消息携带的摄像头ID（仅二进制帧，0表示未指定）
+    qint64 timestampUs = 0;                   // 检测时间（仅二进制帧，微秒，0表示未指定）
+    qint64 pts = -1;                          // 对应视频帧的PTS（仅二进制帧，-1表示未指定）
+    QVarLengthArray<Detection, 64> objects;   // 解析出的目标
+
+    void clear()
+    {
+        total = 0;
+        malformed = 0;
+        cameraId = 0;
+        timestampUs = 0;
+        pts = -1;
+        objects.resize(0); // 保留已分配的容量
+    }
+    QString summary() const; // 事件消息用的摘要："N个物体,1:person;2:tv"（二进制帧为类别号）
+};
+
+// 分帧得到的一条消息（视图，在下一次读入数据前有效）
+struct FramedMessage {
+    bool binary = false;       // 二进制帧还是文本行
+    quint8 type = 0;           // 二进制帧的消息类型
+    const char* data = nullptr; // 文本行（不含行尾）或二进制帧负载
+    int size = 0;
+
+    QLatin1String text() const { return QLatin1String(data, size); }
+};
+
+// 二进制帧格式
+namespace DetectionBinary {
+const quint8 Magic = 0xB5;
+const quint8 Version = 0x01;
+const quint8 TypeDetections = 0x01;
+const int HeaderBytes = 8;
+const int DetectionsHeaderBytes = 20;   // 摄像头ID、目标数、时间戳、PTS
+const int BoxBytes = 12;
+const char Hello[] = "HELLO:DETBIN/1";  // 客户端请求使用二进制帧
+const char HelloReply[] = "HELLO_OK:DETBIN/1\r\n";
+}
+
+// 切分TCP字节流的分帧缓冲（每个连接一个）
+class DetectionFramer {
+public:
+    static const int MaxMessageBytes = 64 * 1024; // 单条消息上限，超过时丢弃
+
+    DetectionFramer();
+
+    // 从设备读出当前可读的全部数据追加到缓冲；返回读到的字节数
+    qint64 readFrom(QIODevice* device);
+    void append(const char* data, int size);
+    // 取出下一条完整消息（文本行兼容只有\n的行尾），返回的视图在下一次读入数据前有效
+    bool nextMessage(FramedMessage* message);
+    void clear();
+
+    // 握手成功后允许二进制帧；未握手时以帧头开始的数据按文本行处理
+    void setBinaryEnabled(bool enabled) { m_binaryEnabled = enabled; }
+    bool binaryEnabled() const { return m_binaryEnabled; }
+    quint64 overflowCount() const { return m_overflows; } // 因超长或帧头错误被丢弃的次数
+
+private:
+    void compact(); // 移除已取出的消息，为新数据腾出空间
+
+    QByteArray m_buffer;
+    int m_readPos;        // 尚未取出的数据起点
+    int m_scanPos;        // 查找行尾的起点（已扫描过的部分不再重复扫描）
+    bool m_binaryEnabled;
+    quint64 m_overflows;
+};
+
+// 解析一条文本消息；不是DETECTIONS消息或总数字段无效时返回false
+bool parseDetections(QLatin1String message, DetectionFrame* frame);
+// 解析二进制检测消息的负载；长度与目标数不符时返回false
+bool parseBinaryDetections(const char* data, int size, DetectionFrame* frame);
+// 编码一条二进制检测消息（含帧头），追加到out；坐标超出int16范围时截断
+void appendBinaryDetections(QByteArray* out, int cameraId, qint64 timestampUs, qint64 pts,
+                            const Detection* objects, int count);
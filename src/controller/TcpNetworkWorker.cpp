@@ -0,0 +1,213 @@
+#include "TcpNetworkWorker.h"
+#include <QDebug>
+
+TcpNetworkWorker::TcpNetworkWorker(QObject* parent)
+    : QObject(parent), m_server(new QTcpServer(this)), m_flushTimer(this), m_omittedTexts(0)
+{
+    qRegisterMetaType<DetectionEvent>("DetectionEvent");
+    qRegisterMetaType<TcpTextMessage>("TcpTextMessage");
+    qRegisterMetaType<QVector<DetectionEvent>>("QVector<DetectionEvent>");
+    qRegisterMetaType<QVector<TcpTextMessage>>("QVector<TcpTextMessage>");
+
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(FlushIntervalMs);
+    connect(&m_flushTimer, &QTimer::timeout, this, &TcpNetworkWorker::flush);
+    connect(m_server, &QTcpServer::newConnection, this, &TcpNetworkWorker::onNewConnection);
+}
+
+TcpNetworkWorker::~TcpNetworkWorker()
+{
+    stopListening();
+}
+
+void TcpNetworkWorker::startListening(const QHostAddress& address, quint16 port)
+{
+    if (m_server->isListening()) {
+        m_server->close();
+    }
+    bool ok = m_server->listen(address, port);
+    emit listenStateChanged(ok, ok ? QString() : m_server->errorString());
+}
+
+void TcpNetworkWorker::stopListening()
+{
+    m_server->close();
+    flush(); // 已收到的数据先于断开通知投递
+    // 断开并删除所有已连接的客户端socket，逐个通知界面线程
+    for (QTcpSocket* socket : m_sockets) {
+        socket->disconnect(this);
+        if (socket->state() == QAbstractSocket::ConnectedState) {
+            socket->disconnectFromHost();
+        }
+        socket->deleteLater();
+        emit clientDisconnected(m_connections.value(socket).ip);
+    }
+    m_sockets.clear();
+    m_ipToSocket.clear();
+    m_connections.clear();
+}
+
+void TcpNetworkWorker::sendTo(const QString& ip, const QByteArray& data)
+{
+    if (ip.isEmpty() || ip == "all") {
+        for (QTcpSocket* socket : m_sockets) {
+            if (socket->state() == QAbstractSocket::ConnectedState) {
+                socket->write(data);
+                socket->flush(); // 立即发送数据
+            }
+        }
+        return;
+    }
+    QTcpSocket* socket = m_ipToSocket.value(ip, nullptr);
+    if (socket && socket->state() == QAbstractSocket::ConnectedState) {
+        socket->write(data);
+        socket->flush();
+    } else {
+        addText(ip, QString("IP[%1]未连接，消息未发送").arg(ip), "warning");
+    }
+}
+
+void TcpNetworkWorker::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        QString ip = peerIp(socket);
+        m_sockets << socket;
+        m_ipToSocket.insert(ip, socket);
+        m_connections[socket].ip = ip;
+        connect(socket, &QTcpSocket::readyRead, this, &TcpNetworkWorker::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, &TcpNetworkWorker::onDisconnected);
+        emit clientConnected(ip, socket->peerPort());
+    }
+}
+
+void TcpNetworkWorker::onDisconnected()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) {
+        return;
+    }
+    QString ip = m_connections.value(socket).ip;
+    m_sockets.removeOne(socket);
+    if (m_ipToSocket.value(ip) == socket) {
+        m_ipToSocket.remove(ip);
+    }
+    m_connections.remove(socket);
+    socket->deleteLater(); // 延迟删除，避免在socket自身的信号中释放
+    flush();               // 断开前收到的数据先于断开通知到达界面线程
+    emit clientDisconnected(ip);
+}
+
+void TcpNetworkWorker::onReadyRead()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket || !m_connections.contains(socket)) {
+        return;
+    }
+
+    // 读入该连接的分帧缓冲，逐条取出完整消息（TCP可能把一条消息拆开，也可能把多条合并）
+    // 每次最多读入一块，取完消息后再读，直到socket中没有剩余数据
+    Connection& connection = m_connections[socket];
+    FramedMessage message;
+    while (connection.framer.readFrom(socket) > 0) {
+        while (connection.framer.nextMessage(&message)) {
+            handleMessage(socket, connection, message);
+        }
+    }
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void TcpNetworkWorker::handleMessage(QTcpSocket* socket, Connection& connection, const FramedMessage& message)
+{
+    const QString& ip = connection.ip;
+    if (message.binary) {
+        // 二进制帧不回显，直接解析
+        if (message.type != DetectionBinary::TypeDetections) {
+            return; // 未知的消息类型（新版本客户端），跳过
+        }
+        if (parseBinaryDetections(message.data, message.size, &m_frame)) {
+            addDetection(ip);
+        } else {
+            addText(ip, QString("二进制检测数据长度错误（%1字节）").arg(message.size), "warning");
+        }
+        return;
+    }
+
+    if (message.text() == QLatin1String(DetectionBinary::Hello)) {
+        // 客户端请求二进制检测帧：之后该连接上文本和二进制帧都可以接收
+        connection.framer.setBinaryEnabled(true);
+        socket->write(DetectionBinary::HelloReply);
+        addText(ip, QString("客户端[IP:%1]已切换为二进制检测数据").arg(ip), "info");
+        return;
+    }
+
+    // 文本消息回显（受每批条数限制），检测数据解析后加入批次
+    if (m_texts.size() < MaxTextPerFlush) {
+        addText(ip, QString::fromUtf8(message.data, message.size), "receive");
+    } else {
+        ++m_omittedTexts;
+    }
+    if (parseDetections(message.text(), &m_frame)) {
+        if (m_frame.malformed > 0) {
+            addText(ip, QString("检测数据中有%1个目标格式错误，已跳过").arg(m_frame.malformed), "warning");
+        }
+        addDetection(ip);
+    } else if (message.text().trimmed().startsWith(QLatin1String("DETECTIONS"))) {
+        addText(ip, "检测数据格式错误：" + QString::fromUtf8(message.data, message.size), "warning");
+    }
+}
+
+void TcpNetworkWorker::addDetection(const QString& ip)
+{
+    DetectionEvent event;
+    event.ip = ip;
+    event.sourceCameraId = m_frame.cameraId;
+    event.timestampUs = m_frame.timestampUs;
+    event.pts = m_frame.pts;
+    event.total = m_frame.total;
+    event.objects.reserve(m_frame.objects.size());
+    for (const Detection& detection : m_frame.objects) {
+        DetectedObject object;
+        object.classId = detection.classId;
+        object.className = detection.className;
+        object.box = QRect(detection.x, detection.y, detection.width, detection.height);
+        object.confidence = detection.confidence;
+        event.objects.append(object);
+    }
+    event.summary = m_frame.summary();
+    m_detections.append(event);
+}
+
+void TcpNetworkWorker::addText(const QString& ip, const QString& text, const QString& type)
+{
+    TcpTextMessage message;
+    message.ip = ip;
+    message.text = text;
+    message.type = type;
+    m_texts.append(message);
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void TcpNetworkWorker::flush()
+{
+    m_flushTimer.stop();
+    if (m_texts.isEmpty() && m_detections.isEmpty() && m_omittedTexts == 0) {
+        return;
+    }
+    emit batchReady(m_texts, m_omittedTexts, m_detections);
+    m_texts.clear();
+    m_detections.clear();
+    m_omittedTexts = 0;
+}
+
+QString TcpNetworkWorker::peerIp(QTcpSocket* socket)
+{
+    QString ip = socket->peerAddress().toString();
+    if (ip.startsWith("::ffff:")) {
+        ip = ip.mid(7); // 去掉"::ffff:"前缀
+    }
+    return ip;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QHash>
+#include <QMap>
+#include <QRect>
+#include <QTimer>
+#include <QVector>
+#include <QMetaType>
+#include "DetectionProtocol.h"
+
+// 一个检测目标（持有自己的数据，可跨线程传递）
+struct DetectedObject {
+    int classId = 0;
+    QString className;          // 二进制帧没有类别名，为空
+    QRect box;
+    float confidence = 0.0f;
+};
+
+// 一条检测消息（网络线程解析，批量交给界面线程）
+struct DetectionEvent {
+    QString ip;                 // 发送端IP
+    int sourceCameraId = 0;     // 消息携带的摄像头ID（仅二进制帧，0表示未指定）
+    int cameraId = -1;          // 最终归属的摄像头ID（界面线程按IP绑定确定，-1表示未绑定）
+    qint64 timestampUs = 0;     // 检测时间（仅二进制帧）
+    qint64 pts = -1;            // 对应视频帧的PTS（仅二进制帧）
+    int total = 0;              // 消息声明的目标总数
+    QVector<DetectedObject> objects;
+    QString summary;            // 事件消息用的摘要："N个物体,1:person;2:tv"
+};
+
+// 一条要显示的文本（收到的消息或网络线程的提示）
+struct TcpTextMessage {
+    QString ip;
+    QString text;
+    QString type = "receive";   // 日志类型：receive为客户端发来的消息，info/warning为提示（连接状态、格式错误等）
+};
+
+Q_DECLARE_METATYPE(DetectionEvent)
+Q_DECLARE_METATYPE(TcpTextMessage)
+
+// TCP网络线程：持有QTcpServer和所有客户端socket，在自己的线程中收发、分帧和解析
+// • 界面线程只通过排队调用发起监听和发送，不直接访问socket
+// • 收到的消息攒成批次，每FlushIntervalMs向界面线程投递一次；检测消息全部投递，
+//   回显文本每批最多MaxTextPerFlush条，超出部分只计数，消息洪泛时界面线程的负担有上限
+class TcpNetworkWorker : public QObject {
+    Q_OBJECT
+
+public:
+    static const int FlushIntervalMs = 50;   // 批次投递间隔
+    static const int MaxTextPerFlush = 20;   // 每批最多回显的文本条数
+
+    explicit TcpNetworkWorker(QObject* parent = nullptr);
+    ~TcpNetworkWorker();
+
+public slots:
+    void startListening(const QHostAddress& address, quint16 port);
+    void stopListening();                                  // 关闭服务器并断开所有客户端（逐个发出断开通知）
+    void sendTo(const QString& ip, const QByteArray& data); // ip为空或"all"时广播
+
+signals:
+    void listenStateChanged(bool listening, const QString& error);
+    void clientConnected(const QString& ip, quint16 port);
+    void clientDisconnected(const QString& ip);
+    // 一批收到的数据；omittedTexts为因限流未回显的文本条数
+    void batchReady(const QVector<TcpTextMessage>& texts, int omittedTexts,
+                    const QVector<DetectionEvent>& detections);
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+    void flush();
+
+private:
+    // 每个客户端连接的状态
+    struct Connection {
+        QString ip;                                // 连接时记录（断开后socket不再提供对端地址）
+        DetectionFramer framer;                    // 分帧缓冲
+    };
+
+    static QString peerIp(QTcpSocket* socket);     // 去掉IPv6映射前缀的IPv4地址
+    void handleMessage(QTcpSocket* socket, Connection& connection, const FramedMessage& message);
+    void addDetection(const QString& ip);          // 把m_frame转为事件加入批次
+    void addText(const QString& ip, const QString& text, const QString& type);
+
+    QTcpServer* m_server;
+    QList<QTcpSocket*> m_sockets;                  // 已连接的客户端
+    QMap<QString, QTcpSocket*> m_ipToSocket;       // IP地址到socket的映射
+    QHash<QTcpSocket*, Connection> m_connections;
+    DetectionFrame m_frame;                        // 解析结果（反复使用）
+
+    // 待投递的批次
+    QTimer m_flushTimer;
+    QVector<TcpTextMessage> m_texts;
+    int m_omittedTexts;
+    QVector<DetectionEvent> m_detections;
+};
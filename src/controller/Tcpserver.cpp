@@ -5,13 +5,11 @@
 #include <QDebug>
 
 Tcpserver::Tcpserver(QWidget* parent)
-    : QWidget(parent), tcpServer(nullptr), serverThread(nullptr), m_currentCameraId(-1)
+    : QWidget(parent), m_currentCameraId(-1), m_worker(nullptr), serverThread(nullptr)
 {
     this->setWindowTitle("Tcpserver");
     this->resize(800, 480);
 
-    tcpServer = new QTcpServer(this);
-
     pushButton[0] = new QPushButton("开始监听");
     pushButton[1] = new QPushButton("停止监听");
     pushButton[2] = new QPushButton("清空文本");
@@ -35,7 +33,7 @@ Tcpserver::Tcpserver(QWidget* parent)
     spinBox = new QSpinBox();
     spinBox->setRange(8890, 99999);
     spinBox->setValue(8890); // 设置默认端口为8890
-    textBrowser = new QTextBrowser();
+    logView = new EventLogView(2000);
 
     hBoxLayout[0] = new QHBoxLayout();
     hBoxLayout[1] = new QHBoxLayout();
@@ -65,7 +63,7 @@ Tcpserver::Tcpserver(QWidget* parent)
     hBoxLayout[2]->addWidget(pushButton[3]);
     hWidget[2]->setLayout(hBoxLayout[2]);
 
-    vBoxLayout->addWidget(textBrowser);
+    vBoxLayout->addWidget(logView);
     vBoxLayout->addWidget(hWidget[1]);
     vBoxLayout->addWidget(hWidget[0]);
     vBoxLayout->addWidget(hWidget[2]);
@@ -74,14 +72,28 @@ Tcpserver::Tcpserver(QWidget* parent)
 
     connect(pushButton[0], &QPushButton::clicked, this, &Tcpserver::startListen);
     connect(pushButton[1], &QPushButton::clicked, this, &Tcpserver::stopListen);
-    connect(pushButton[2], &QPushButton::clicked, this, &Tcpserver::clearTextBrowser);
+    connect(pushButton[2], &QPushButton::clicked, this, &Tcpserver::clearLog);
     connect(pushButton[3], &QPushButton::clicked, this, &Tcpserver::sendMessages);
     connect(pushButton[4], &QPushButton::clicked, this, &Tcpserver::lockip);
-    connect(tcpServer, &QTcpServer::newConnection, this, &Tcpserver::clientConnected);
+
+    // 网络线程：持有服务器和所有socket，收发、分帧和解析都不在界面线程进行
+    m_worker = new TcpNetworkWorker();
+    serverThread = new TcpServerThread(this, this);
+    m_worker->moveToThread(serverThread);
+    connect(serverThread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &TcpNetworkWorker::listenStateChanged, this, &Tcpserver::onListenStateChanged);
+    connect(m_worker, &TcpNetworkWorker::clientConnected, this, &Tcpserver::onClientConnected);
+    connect(m_worker, &TcpNetworkWorker::clientDisconnected, this, &Tcpserver::onClientDisconnected);
+    connect(m_worker, &TcpNetworkWorker::batchReady, this, &Tcpserver::onBatchReady);
+    serverThread->start();
 }
 
 Tcpserver::~Tcpserver() {
     stopListen();
+    // 等网络线程关闭所有连接后退出，线程结束时删除网络对象
+    QMetaObject::invokeMethod(m_worker, "stopListening", Qt::BlockingQueuedConnection);
+    serverThread->quit();
+    serverThread->wait();
 }
 
 // 获取本机首选的IPv4地址（排除回环地址）
@@ -194,8 +206,12 @@ void Tcpserver::startListen()
 
     // 检查IP地址输入框内容是否有效（此处原代码判断条件有误，应该判断IP地址是否为空）
     if (!Ip_lineEdit->text().isEmpty()) {
-        // 开始监听指定IP和端口
-        tcpServer->listen(hostAddress, spinBox->value());
+        // 在网络线程中开始监听指定IP和端口，结果在onListenStateChanged中处理
+        TcpNetworkWorker* worker = m_worker;
+        quint16 port = static_cast<quint16>(spinBox->value());
+        QMetaObject::invokeMethod(m_worker, [worker, hostAddress, port]() {
+            worker->startListening(hostAddress, port);
+        }, Qt::QueuedConnection);
         // 设置“开始监听”按钮不可用
         pushButton[0]->setEnabled(false);
         // 设置“停止监听”按钮可用
@@ -203,29 +219,16 @@ void Tcpserver::startListen()
         // 禁用端口号输入框
         spinBox->setEnabled(false);
         // 在文本浏览器中显示服务器IP地址
-        textBrowser->append("服务器IP地址：" + Ip_lineEdit->text());
+        logView->addMessage("info", "服务器IP地址：" + Ip_lineEdit->text());
         // 在文本浏览器中显示正在监听的端口
-        textBrowser->append("正在监听端口：" + spinBox->text());
-        // 启动服务器线程（如果未启动）
-        if (!serverThread) {
-            serverThread = new TcpServerThread(this);
-            serverThread->start();
-        }
+        logView->addMessage("info", "正在监听端口：" + spinBox->text());
     }
 }
 
 void Tcpserver::stopListen()
 {
-    // 关闭TCP服务器
-    tcpServer->close();
-
-    // 断开并删除所有已连接的客户端socket
-    foreach (QTcpSocket* sock, clientSockets) {
-        if (sock->state() == QAbstractSocket::ConnectedState)
-            sock->disconnectFromHost(); // 断开连接
-        sock->deleteLater(); // 延迟删除socket对象
-    }
-    clientSockets.clear(); // 清空客户端socket列表
+    // 在网络线程中关闭TCP服务器，断开所有已连接的客户端（逐个发出断开通知，在onClientDisconnected中清理）
+    QMetaObject::invokeMethod(m_worker, "stopListening", Qt::QueuedConnection);
 
     // 更新按钮和控件状态
     pushButton[1]->setEnabled(false); // 停止监听按钮不可用
@@ -234,20 +237,24 @@ void Tcpserver::stopListen()
     spinBox->setEnabled(true);        // 端口号输入框可用
 
     // 在文本浏览器中显示已停止监听信息
-    textBrowser->append("已停止监听端口：" + spinBox->text());
-
-    // 关闭并销毁服务器线程
-    if (serverThread) {
-        serverThread->quit();
-        serverThread->wait();
-        delete serverThread;
-        serverThread = nullptr;
+    logView->addMessage("info", "已停止监听端口：" + spinBox->text());
+}
+
+void Tcpserver::onListenStateChanged(bool listening, const QString& error)
+{
+    if (listening) {
+        return;
     }
+    // 监听失败（端口被占用、地址无效等），恢复控件状态
+    logView->addMessage("error", "监听失败：" + error);
+    pushButton[1]->setEnabled(false);
+    pushButton[0]->setEnabled(true);
+    spinBox->setEnabled(true);
 }
 
-void Tcpserver::clearTextBrowser()
+void Tcpserver::clearLog()
 {
-    textBrowser->clear();
+    logView->clear();
 }
 
 // 发送消息给所有已连接的客户端
@@ -257,25 +264,12 @@ void Tcpserver::sendMessages()
     QString msg = Sent_lineEdit->text() + "\r\n"; // 每次发送信息添加换行符号\r\n
     QString selectedIp = comboBox->currentText();
     
-    // 遍历所有客户端socket
-    for (QTcpSocket* sock : clientSockets) {
-        // 如果socket处于已连接状态
-        if (sock->state() == QAbstractSocket::ConnectedState) {
-            QString ip = sock->peerAddress().toString();
-            if (ip.startsWith("::ffff:")) {
-                ip = ip.mid(7); // 去掉"::ffff:"前缀
-            }
-            
-            // 如果选择"all"或IP地址匹配，则发送消息
-            if (selectedIp == "all" || selectedIp == ip) {
-                sock->write(msg.toUtf8());
-            }
-        }
-    }
+    // 如果选择"all"则广播，否则只发送给该IP
+    postSend(selectedIp, msg);
     
     // 在文本浏览器中显示服务端发送的消息
     if (selectedIp == "all") {
-        textBrowser->append("服务端[全部]：" + Sent_lineEdit->text() + "\r\n");
+        logView->addMessage("send", "服务端[全部]：" + Sent_lineEdit->text());
     } else {
         // 显示IP和对应的摄像头ID（如果有）
         QString target;
@@ -285,67 +279,18 @@ void Tcpserver::sendMessages()
         } else {
             target = QString("IP:%1|未绑定").arg(selectedIp);
         }
-        textBrowser->append(QString("服务端[%1]：%2\r\n").arg(target).arg(Sent_lineEdit->text()));
+        logView->addMessage("send", QString("服务端[%1]：%2").arg(target).arg(Sent_lineEdit->text()),
+                            ipToCameraMap.value(selectedIp, -1));
     }
 }
 
-void Tcpserver::clientConnected()
+void Tcpserver::onClientConnected(const QString& ip, quint16 port)
 {
-    // 获取下一个待处理的客户端连接
-    QTcpSocket* clientSocket = tcpServer->nextPendingConnection();
-    // 将新连接的客户端socket添加到clientSockets列表
-    clientSockets << clientSocket;
-    // 获取客户端IP地址（去掉IPv6前缀，只保留IPv4）
-    QString ip = clientSocket->peerAddress().toString();
-    if (ip.startsWith("::ffff:")) {
-        ip = ip.mid(7); // 去掉"::ffff:"前缀
-    }
-    // 获取客户端端口号
-    quint16 port = clientSocket->peerPort();
-    
-    // 保存IP到Socket的映射
-    ipToSocketMap.insert(ip, clientSocket);
-    
-    // 在文本浏览器中显示客户端已连接的信息
-    textBrowser->append("========================================");
-    textBrowser->append("✓ 新客户端连接");
-    textBrowser->append("  IP地址: " + ip);
-    textBrowser->append("  端口: " + QString::number(port));
-    textBrowser->append("========================================");
+    // 记录已连接的客户端（socket由网络线程持有）
+    m_connectedClients.insert(ip, port);
     
-    // 连接readyRead信号，用于接收客户端消息
-    connect(clientSocket, &QTcpSocket::readyRead, this, &Tcpserver::receiveMessages);
-    // 连接stateChanged信号，用于监控socket状态变化
-    connect(clientSocket, &QTcpSocket::stateChanged, this, &Tcpserver::socketStateChange);
-    // 连接disconnected信号，用于清理断开的连接
-    connect(clientSocket, &QTcpSocket::disconnected, this, [this, ip]() {
-        QTcpSocket* sender = qobject_cast<QTcpSocket*>(QObject::sender());
-        
-        textBrowser->append("========================================");
-        textBrowser->append("✗ 客户端断开连接: " + ip);
-        textBrowser->append("========================================");
-        
-        // 清理映射关系
-        ipToSocketMap.remove(ip);
-        if (ipToCameraMap.contains(ip)) {
-            int cameraId = ipToCameraMap.value(ip);
-            cameraToIpMap.remove(cameraId);
-            ipToCameraMap.remove(ip);
-            textBrowser->append(QString("  已解除IP[%1]与摄像头[%2]的绑定").arg(ip).arg(cameraId));
-        }
-        
-        // 从comboBox移除该IP
-        int index = comboBox->findText(ip);
-        if (index > 0) { // 保留"all"选项
-            comboBox->removeItem(index);
-        }
-        
-        // 安全地移除socket
-        if (sender) {
-            clientSockets.removeOne(sender);
-            sender->deleteLater();  // 延迟删除，避免立即释放导致问题
-        }
-    });
+    // 在日志中显示客户端已连接的信息
+    logView->addMessage("success", QString("✓ 新客户端连接 IP地址: %1 端口: %2").arg(ip).arg(port));
 
     // 新增：将IP地址添加到comboBox（避免重复）
     if (comboBox->findText(ip) == -1) {
@@ -356,35 +301,58 @@ void Tcpserver::clientConnected()
     emit tcpClientConnected(ip, port);
 }
 
-void Tcpserver::receiveMessages()
+void Tcpserver::onClientDisconnected(const QString& ip)
 {
-    // 获取发送消息的客户端socket
-    QTcpSocket* senderSocket = qobject_cast<QTcpSocket*>(sender());
-    if (!senderSocket) return; // 如果获取失败则直接返回
-    
-    // 获取客户端IP地址
-    QString ip = senderSocket->peerAddress().toString();
-    if (ip.startsWith("::ffff:")) {
-        ip = ip.mid(7); // 去掉"::ffff:"前缀
-    }
-    
-    // 读取客户端发送的全部数据
-    QByteArray data = senderSocket->readAll();
-    QString message = QString::fromUtf8(data);
+    logView->addMessage("warning", "✗ 客户端断开连接: " + ip);
     
-    // 格式化显示消息，包含IP和对应的摄像头ID（如果有绑定）
-    QString displayMessage;
+    // 清理映射关系
+    m_connectedClients.remove(ip);
     if (ipToCameraMap.contains(ip)) {
         int cameraId = ipToCameraMap.value(ip);
-        displayMessage = QString("客户端[IP:%1|摄像头%2]：%3").arg(ip).arg(cameraId).arg(message);
-    } else {
-        displayMessage = QString("客户端[IP:%1|未绑定]：%2").arg(ip).arg(message);
+        cameraToIpMap.remove(cameraId);
+        ipToCameraMap.remove(ip);
+        logView->addMessage("info", QString("已解除IP[%1]与摄像头[%2]的绑定").arg(ip).arg(cameraId), cameraId);
     }
-    textBrowser->append(displayMessage);
     
-    // 检查是否为检测数据并进行处理（传递摄像头ID）
-    int cameraId = ipToCameraMap.value(ip, -1); // 获取摄像头ID，未绑定则为-1
-    processDetectionData(cameraId, message);
+    // 从comboBox移除该IP
+    int index = comboBox->findText(ip);
+    if (index > 0) { // 保留"all"选项
+        comboBox->removeItem(index);
+    }
+}
+
+// 网络线程投递的一批数据：回显文本，按IP绑定确定检测消息所属的摄像头后交给controller
+void Tcpserver::onBatchReady(const QVector<TcpTextMessage>& texts, int omittedTexts,
+                             const QVector<DetectionEvent>& detections)
+{
+    for (const TcpTextMessage& message : texts) {
+        int cameraId = ipToCameraMap.value(message.ip, -1);
+        if (message.type != "receive") {
+            logView->addMessage(message.type, message.text, cameraId);
+        } else if (cameraId != -1) {
+            // 格式化显示消息，包含IP和对应的摄像头ID（如果有绑定）
+            logView->addMessage(message.type, QString("客户端[IP:%1|摄像头%2]：%3")
+                                .arg(message.ip).arg(cameraId).arg(message.text), cameraId);
+        } else {
+            logView->addMessage(message.type, QString("客户端[IP:%1|未绑定]：%2").arg(message.ip).arg(message.text));
+        }
+    }
+    if (omittedTexts > 0) {
+        logView->addMessage("warning", QString("……另有%1条消息未显示").arg(omittedTexts));
+    }
+    if (detections.isEmpty()) {
+        return;
+    }
+
+    // 连接未绑定摄像头时使用二进制帧中携带的摄像头ID
+    QVector<DetectionEvent> events = detections;
+    for (DetectionEvent& event : events) {
+        event.cameraId = ipToCameraMap.value(event.ip, -1);
+        if (event.cameraId == -1 && event.sourceCameraId > 0) {
+            event.cameraId = event.sourceCameraId;
+        }
+    }
+    emit detectionsReceived(events);
 }
 
 void Tcpserver::lockip()
@@ -401,290 +369,145 @@ void Tcpserver::lockip()
     }
 }
 
-void Tcpserver::socketStateChange(QAbstractSocket::SocketState state)
-{
-    switch (state) {
-    case QAbstractSocket::UnconnectedState:
-        textBrowser->append("scoket状态：UnconnectedState");
-        break;
-    case QAbstractSocket::ConnectedState:
-        textBrowser->append("scoket状态：ConnectedState");
-        break;
-    case QAbstractSocket::ConnectingState:
-        textBrowser->append("scoket状态：ConnectingState");
-        break;
-    case QAbstractSocket::HostLookupState:
-        textBrowser->append("scoket状态：HostLookupState");
-        break;
-    case QAbstractSocket::ClosingState:
-        textBrowser->append("scoket状态：ClosingState");
-        break;
-    case QAbstractSocket::ListeningState:
-        textBrowser->append("scoket状态：ListeningState");
-        break;
-    case QAbstractSocket::BoundState:
-        textBrowser->append("scoket状态：BoundState");
-        break;
-    default:
-        break;
-    }
-}
-
 // TcpServerThread 构造函数，初始化线程并保存服务器指针
 TcpServerThread::TcpServerThread(Tcpserver* server, QObject* parent)
     : QThread(parent), m_server(server) {}
 
 void TcpServerThread::run()
 {
-    // 这里可以扩展为后台处理任务
+    // 网络对象（TcpNetworkWorker）在本线程的事件循环中处理所有socket
     exec(); // 保持线程事件循环
 } 
 
-// ========== TCP传输函数（通过摄像头ID指定目标） ==========
+// ========== 发送（实际写入在网络线程中进行） ==========
 
-void Tcpserver::Tcp_sent_info(int targetCameraId, int deviceId, int operationId, int operationValue)
+// 把消息交给网络线程发送，ip为"all"时广播
+void Tcpserver::postSend(const QString& ip, const QString& message)
 {
-    // 构造固定格式的字符串：DEVICE_ID:OPERATION_ID:OPERATION_VALUE，并添加换行符
-    QString message = QString("DEVICE_%1:OP_%2:VALUE_%3\r\n")
-                     .arg(deviceId)
-                     .arg(operationId)
-                     .arg(operationValue);
-    
-    // targetCameraId = 0 表示广播到所有客户端
-    if (targetCameraId == 0) {
-        int sentCount = 0;
-        for (QTcpSocket* sock : clientSockets) {
-            if (sock->state() == QAbstractSocket::ConnectedState) {
-                sock->write(message.toUtf8());
-                sock->flush();  // 立即发送数据
-                sentCount++;
-            }
-        }
-        textBrowser->append(QString("→ [广播到%1个客户端] %2")
-                           .arg(sentCount)
-                           .arg(message.trimmed()));
-        return;
-    }
-    
-    // 发送给指定摄像头ID对应的IP
-    if (cameraToIpMap.contains(targetCameraId)) {
-        QString targetIp = cameraToIpMap.value(targetCameraId);
-        
-        if (ipToSocketMap.contains(targetIp)) {
-            QTcpSocket* sock = ipToSocketMap.value(targetIp);
-            if (sock->state() == QAbstractSocket::ConnectedState) {
-                sock->write(message.toUtf8());
-                sock->flush();  // 立即发送数据
-                textBrowser->append(QString("→ [摄像头%1|IP:%2] %3")
-                                   .arg(targetCameraId)
-                                   .arg(targetIp)
-                                   .arg(message.trimmed()));
-            } else {
-                textBrowser->append(QString("⚠️ 摄像头%1对应的IP[%2]未连接")
-                                   .arg(targetCameraId)
-                                   .arg(targetIp));
-            }
-        } else {
-            textBrowser->append(QString("⚠️ 未找到摄像头%1对应的IP[%2]的连接")
-                               .arg(targetCameraId)
-                               .arg(targetIp));
-        }
-    } else {
-        textBrowser->append(QString("⚠️ 摄像头%1未绑定TCP客户端").arg(targetCameraId));
-    }
+    TcpNetworkWorker* worker = m_worker;
+    QByteArray data = message.toUtf8();
+    QMetaObject::invokeMethod(m_worker, [worker, ip, data]() {
+        worker->sendTo(ip, data);
+    }, Qt::QueuedConnection);
 }
 
-void Tcpserver::Tcp_sent_rect(int targetCameraId, int x, int y, int width, int height)
+// 发送给摄像头ID对应的客户端，targetCameraId = 0 表示广播到所有客户端
+void Tcpserver::sendToCamera(int targetCameraId, const QString& message)
 {
-    // 构造绝对坐标矩形框信息的字符串
-    QString message = QString("RECT_ABS:%1:%2:%3:%4\r\n")
-                         .arg(x)
-                         .arg(y)
-                         .arg(width)
-                         .arg(height);
-    
-    // targetCameraId = 0 表示广播到所有客户端
     if (targetCameraId == 0) {
-        for (QTcpSocket* sock : clientSockets) {
-            if (sock->state() == QAbstractSocket::ConnectedState) {
-                sock->write(message.toUtf8());
-                sock->flush();  // 立即发送数据
-            }
-        }
-        textBrowser->append("→ [广播] " + message.trimmed());
+        sendToIp("all", message);
         return;
     }
-    
-    // 发送给指定摄像头ID对应的IP
-    if (cameraToIpMap.contains(targetCameraId)) {
-        QString targetIp = cameraToIpMap.value(targetCameraId);
-        
-        if (ipToSocketMap.contains(targetIp)) {
-            QTcpSocket* sock = ipToSocketMap.value(targetIp);
-            if (sock->state() == QAbstractSocket::ConnectedState) {
-                sock->write(message.toUtf8());
-                sock->flush();  // 立即发送数据
-                textBrowser->append(QString("→ [摄像头%1|IP:%2] %3")
-                                   .arg(targetCameraId)
-                                   .arg(targetIp)
-                                   .arg(message.trimmed()));
-            }
-        }
-    } else {
-        textBrowser->append(QString("⚠️ 摄像头%1未绑定TCP客户端").arg(targetCameraId));
+    if (!cameraToIpMap.contains(targetCameraId)) {
+        logView->addMessage("warning", QString("摄像头%1未绑定TCP客户端").arg(targetCameraId), targetCameraId);
+        return;
+    }
+    QString targetIp = cameraToIpMap.value(targetCameraId);
+    if (!m_connectedClients.contains(targetIp)) {
+        logView->addMessage("warning", QString("未找到摄像头%1对应的IP[%2]的连接")
+                            .arg(targetCameraId)
+                            .arg(targetIp), targetCameraId);
+        return;
     }
+    postSend(targetIp, message);
+    logView->addMessage("send", QString("→ [摄像头%1|IP:%2] %3")
+                        .arg(targetCameraId)
+                        .arg(targetIp)
+                        .arg(message.trimmed()), targetCameraId);
 }
 
-void Tcpserver::Tcp_sent_rect(int targetCameraId, float x, float y, float width, float height)
+// 发送给指定IP的客户端，targetIp为空或"all"时广播到所有客户端
+void Tcpserver::sendToIp(const QString& targetIp, const QString& message)
 {
-    // 构造归一化矩形框信息的字符串，保留4位小数
-    QString message = QString("RECT:%1:%2:%3:%4\r\n")
-                         .arg(QString::number(x, 'f', 4))
-                         .arg(QString::number(y, 'f', 4))
-                         .arg(QString::number(width, 'f', 4))
-                         .arg(QString::number(height, 'f', 4));
-    
-    // targetCameraId = 0 表示广播到所有客户端
-    if (targetCameraId == 0) {
-        for (QTcpSocket* sock : clientSockets) {
-            if (sock->state() == QAbstractSocket::ConnectedState) {
-                sock->write(message.toUtf8());
-                sock->flush();  // 立即发送数据
-            }
-        }
-        textBrowser->append("→ [广播] " + message.trimmed());
+    if (targetIp.isEmpty() || targetIp == "all") {
+        postSend("all", message);
+        logView->addMessage("send", QString("→ [广播到%1个客户端] %2")
+                            .arg(m_connectedClients.size())
+                            .arg(message.trimmed()));
         return;
     }
-    
-    // 发送给指定摄像头ID对应的IP
-    if (cameraToIpMap.contains(targetCameraId)) {
-        QString targetIp = cameraToIpMap.value(targetCameraId);
-        
-        if (ipToSocketMap.contains(targetIp)) {
-            QTcpSocket* sock = ipToSocketMap.value(targetIp);
-            if (sock->state() == QAbstractSocket::ConnectedState) {
-                sock->write(message.toUtf8());
-                sock->flush();  // 立即发送数据
-                textBrowser->append(QString("→ [摄像头%1|IP:%2] %3")
-                                   .arg(targetCameraId)
-                                   .arg(targetIp)
-                                   .arg(message.trimmed()));
-            }
-        }
+    if (!m_connectedClients.contains(targetIp)) {
+        logView->addMessage("warning", QString("IP[%1]未连接").arg(targetIp));
+        return;
+    }
+    postSend(targetIp, message);
+    int cameraId = ipToCameraMap.value(targetIp, -1);
+    if (cameraId > 0) {
+        logView->addMessage("send", QString("→ [IP:%1|摄像头%2] %3")
+                            .arg(targetIp)
+                            .arg(cameraId)
+                            .arg(message.trimmed()), cameraId);
     } else {
-        textBrowser->append(QString("⚠️ 摄像头%1未绑定TCP客户端").arg(targetCameraId));
+        logView->addMessage("send", QString("→ [IP:%1|未绑定] %2")
+                            .arg(targetIp)
+                            .arg(message.trimmed()));
     }
 }
 
-void Tcpserver::Tcp_sent_list(int targetCameraId, const QSet<int>& objectIds)
+// 构造固定格式的字符串：DEVICE_ID:OPERATION_ID:OPERATION_VALUE，并添加换行符
+static QString deviceInfoMessage(int deviceId, int operationId, int operationValue)
+{
+    return QString("DEVICE_%1:OP_%2:VALUE_%3\r\n")
+           .arg(deviceId)
+           .arg(operationId)
+           .arg(operationValue);
+}
+
+// 构造绝对坐标矩形框信息的字符串
+static QString absoluteRectMessage(int x, int y, int width, int height)
+{
+    return QString("RECT_ABS:%1:%2:%3:%4\r\n")
+           .arg(x)
+           .arg(y)
+           .arg(width)
+           .arg(height);
+}
+
+// 构造归一化矩形框信息的字符串，保留4位小数
+static QString normalizedRectMessage(float x, float y, float width, float height)
+{
+    return QString("RECT:%1:%2:%3:%4\r\n")
+           .arg(QString::number(x, 'f', 4))
+           .arg(QString::number(y, 'f', 4))
+           .arg(QString::number(width, 'f', 4))
+           .arg(QString::number(height, 'f', 4));
+}
+
+// 构造对象列表信息的字符串：LIST:objectId1,objectId2,objectId3...，并添加换行符
+static QString objectListMessage(const QSet<int>& objectIds)
 {
-    // 构造对象列表信息的字符串：LIST:objectId1,objectId2,objectId3...，并添加换行符
     QStringList idList;
     for (int id : objectIds) {
         idList.append(QString::number(id));
     }
-    
-    QString message = QString("LIST:%1\r\n").arg(idList.join(","));
-    
-    // targetCameraId = 0 表示广播到所有客户端
-    if (targetCameraId == 0) {
-        for (QTcpSocket* sock : clientSockets) {
-            if (sock->state() == QAbstractSocket::ConnectedState) {
-                sock->write(message.toUtf8());
-                sock->flush();  // 立即发送数据
-            }
-        }
-        textBrowser->append("→ [广播] " + message.trimmed());
-        return;
-    }
-    
-    // 发送给指定摄像头ID对应的IP
-    if (cameraToIpMap.contains(targetCameraId)) {
-        QString targetIp = cameraToIpMap.value(targetCameraId);
-        
-        if (ipToSocketMap.contains(targetIp)) {
-            QTcpSocket* sock = ipToSocketMap.value(targetIp);
-            if (sock->state() == QAbstractSocket::ConnectedState) {
-                sock->write(message.toUtf8());
-                sock->flush();  // 立即发送数据
-                textBrowser->append(QString("→ [摄像头%1|IP:%2] %3")
-                                   .arg(targetCameraId)
-                                   .arg(targetIp)
-                                   .arg(message.trimmed()));
-            }
-        }
-    } else {
-        textBrowser->append(QString("⚠️ 摄像头%1未绑定TCP客户端").arg(targetCameraId));
-    }
-} 
+    return QString("LIST:%1\r\n").arg(idList.join(","));
+}
 
-bool Tcpserver::hasConnectedClients() const
+// ========== TCP传输函数（通过摄像头ID指定目标） ==========
+
+void Tcpserver::Tcp_sent_info(int targetCameraId, int deviceId, int operationId, int operationValue)
 {
-    for (QTcpSocket* sock : clientSockets) {
-        if (sock && sock->state() == QAbstractSocket::ConnectedState) {
-            return true;
-        }
-    }
-    return false;
+    sendToCamera(targetCameraId, deviceInfoMessage(deviceId, operationId, operationValue));
 }
 
-// 处理检测数据的函数，当接收到DETECTIONS格式的数据时触发图像保存
-// 参数：cameraId - 发送数据的摄像头ID，-1表示未绑定
-void Tcpserver::processDetectionData(int cameraId, const QString& data)
+void Tcpserver::Tcp_sent_rect(int targetCameraId, int x, int y, int width, int height)
 {
-    // 去除首尾空白字符并检查数据是否以DETECTIONS开头
-    QString trimmedData = data.trimmed();
-    if (!trimmedData.startsWith("DETECTIONS")) {
-        return; // 不是检测数据格式，直接返回
-    }
-    
-    // 解析检测数据格式：DETECTIONS:6|0:person:209:2:506:475:0.843|62:tv:633:313:57:62:0.774|...
-    QStringList parts = trimmedData.split(":");
-    if (parts.size() < 2) {
-        // 数据格式不正确，记录错误信息
-        textBrowser->append("⚠️ 检测数据格式错误：" + trimmedData);
-        return;
-    }
-    
-    // 提取检测对象数量和详细信息
-    QString detectionInfo = parts[1]; // 获取"6|0:person:209:2:506:475:0.843|62:tv:..."部分
-    QStringList objectParts = detectionInfo.split("|");
-    
-    if (objectParts.isEmpty()) {
-        textBrowser->append("⚠️ 检测数据为空");
-        return;
-    }
-    
-    // 第一个部分是对象总数
-    int totalObjects = objectParts[0].toInt();
-    
-    // 解析每个检测对象的信息
-    QStringList categories;
-    int objectIndex = 1;
-    
-    for (int i = 1; i < objectParts.size(); ++i) {
-        QString objectInfo = objectParts[i];
-        QStringList objectDetails = objectInfo.split(":");
-        
-        // 格式：class_id:class_name:x:y:width:height:confidence
-        if (objectDetails.size() >= 2) {
-            QString className = objectDetails[1]; // 获取类别名称
-            categories.append(QString("%1:%2").arg(objectIndex).arg(className));
-            objectIndex++;
-        }
-    }
-    
-    // 构建处理后的数据格式
-    QString processedData;
-    if (!categories.isEmpty()) {
-        processedData = QString("%1个物体,%2").arg(totalObjects).arg(categories.join(";"));
-    } else {
-        processedData = QString("%1个物体").arg(totalObjects);
-    }
-    
-    
-    // 发射信号给controller，传递摄像头ID和处理后的数据
-    emit detectionDataReceived(cameraId, processedData);
+    sendToCamera(targetCameraId, absoluteRectMessage(x, y, width, height));
+}
+
+void Tcpserver::Tcp_sent_rect(int targetCameraId, float x, float y, float width, float height)
+{
+    sendToCamera(targetCameraId, normalizedRectMessage(x, y, width, height));
+}
+
+void Tcpserver::Tcp_sent_list(int targetCameraId, const QSet<int>& objectIds)
+{
+    sendToCamera(targetCameraId, objectListMessage(objectIds));
+}
+
+bool Tcpserver::hasConnectedClients() const
+{
+    return !m_connectedClients.isEmpty();
 }
 
 // ========== IP与摄像头ID映射管理函数 ==========
@@ -696,23 +519,21 @@ void Tcpserver::bindIpToCamera(const QString& ip, int cameraId)
     if (cameraToIpMap.contains(cameraId)) {
         QString oldIp = cameraToIpMap.value(cameraId);
         ipToCameraMap.remove(oldIp);
-        textBrowser->append(QString("⚠️ 摄像头%1已从IP[%2]解绑").arg(cameraId).arg(oldIp));
+        logView->addMessage("warning", QString("摄像头%1已从IP[%2]解绑").arg(cameraId).arg(oldIp), cameraId);
     }
     
     // 如果该IP已经绑定了其他摄像头，先解绑
     if (ipToCameraMap.contains(ip)) {
         int oldCameraId = ipToCameraMap.value(ip);
         cameraToIpMap.remove(oldCameraId);
-        textBrowser->append(QString("⚠️ IP[%1]已从摄像头%2解绑").arg(ip).arg(oldCameraId));
+        logView->addMessage("warning", QString("IP[%1]已从摄像头%2解绑").arg(ip).arg(oldCameraId), oldCameraId);
     }
     
     // 建立新的绑定关系
     ipToCameraMap.insert(ip, cameraId);
     cameraToIpMap.insert(cameraId, ip);
     
-    textBrowser->append("========================================");
-    textBrowser->append(QString("✓ 摄像头%1已成功连接到IP地址%2").arg(cameraId).arg(ip));
-    textBrowser->append("========================================");
+    logView->addMessage("success", QString("✓ 摄像头%1已成功连接到IP地址%2").arg(cameraId).arg(ip), cameraId);
 }
 
 // 解绑IP地址
@@ -723,9 +544,7 @@ void Tcpserver::unbindIpFromCamera(const QString& ip)
         ipToCameraMap.remove(ip);
         cameraToIpMap.remove(cameraId);
         
-        textBrowser->append("========================================");
-        textBrowser->append(QString("✓ 已解绑: IP[%1] ⇔ 摄像头%2").arg(ip).arg(cameraId));
-        textBrowser->append("========================================");
+        logView->addMessage("info", QString("✓ 已解绑: IP[%1] ⇔ 摄像头%2").arg(ip).arg(cameraId), cameraId);
     }
 }
 
@@ -773,164 +592,27 @@ int Tcpserver::getCurrentCameraId() const
 // 获取所有已连接的IP地址列表
 QStringList Tcpserver::getConnectedIps() const
 {
-    return ipToSocketMap.keys();
+    return m_connectedClients.keys();
 }
 
 // ========== TCP传输函数（通过IP地址指定目标） ==========
 
 void Tcpserver::Tcp_sent_info(const QString& targetIp, int deviceId, int operationId, int operationValue)
 {
-    QString message = QString("DEVICE_%1:OP_%2:VALUE_%3\r\n")
-                     .arg(deviceId)
-                     .arg(operationId)
-                     .arg(operationValue);
-    
-    if (targetIp.isEmpty() || targetIp == "all") {
-        // 广播到所有客户端
-        int sentCount = 0;
-        for (QTcpSocket* sock : clientSockets) {
-            if (sock->state() == QAbstractSocket::ConnectedState) {
-                sock->write(message.toUtf8());
-                sock->flush();  // 立即发送数据
-                sentCount++;
-            }
-        }
-        textBrowser->append(QString("→ [广播到%1个客户端] %2")
-                           .arg(sentCount)
-                           .arg(message.trimmed()));
-    } else if (ipToSocketMap.contains(targetIp)) {
-        QTcpSocket* sock = ipToSocketMap.value(targetIp);
-        if (sock->state() == QAbstractSocket::ConnectedState) {
-            sock->write(message.toUtf8());
-                sock->flush();  // 立即发送数据
-            int cameraId = ipToCameraMap.value(targetIp, -1);
-            if (cameraId > 0) {
-                textBrowser->append(QString("→ [IP:%1|摄像头%2] %3")
-                                   .arg(targetIp)
-                                   .arg(cameraId)
-                                   .arg(message.trimmed()));
-            } else {
-                textBrowser->append(QString("→ [IP:%1|未绑定] %2")
-                                   .arg(targetIp)
-                                   .arg(message.trimmed()));
-            }
-        }
-    } else {
-        textBrowser->append(QString("⚠️ IP[%1]未连接").arg(targetIp));
-    }
+    sendToIp(targetIp, deviceInfoMessage(deviceId, operationId, operationValue));
 }
 
 void Tcpserver::Tcp_sent_rect(const QString& targetIp, int x, int y, int width, int height)
 {
-    QString message = QString("RECT_ABS:%1:%2:%3:%4\r\n")
-                         .arg(x)
-                         .arg(y)
-                         .arg(width)
-                         .arg(height);
-    
-    if (targetIp.isEmpty() || targetIp == "all") {
-        for (QTcpSocket* sock : clientSockets) {
-            if (sock->state() == QAbstractSocket::ConnectedState) {
-                sock->write(message.toUtf8());
-                sock->flush();  // 立即发送数据
-            }
-        }
-        textBrowser->append("→ [广播] " + message.trimmed());
-    } else if (ipToSocketMap.contains(targetIp)) {
-        QTcpSocket* sock = ipToSocketMap.value(targetIp);
-        if (sock->state() == QAbstractSocket::ConnectedState) {
-            sock->write(message.toUtf8());
-                sock->flush();  // 立即发送数据
-            int cameraId = ipToCameraMap.value(targetIp, -1);
-            if (cameraId > 0) {
-                textBrowser->append(QString("→ [IP:%1|摄像头%2] %3")
-                                   .arg(targetIp)
-                                   .arg(cameraId)
-                                   .arg(message.trimmed()));
-            } else {
-                textBrowser->append(QString("→ [IP:%1] %2")
-                                   .arg(targetIp)
-                                   .arg(message.trimmed()));
-            }
-        }
-    } else {
-        textBrowser->append(QString("⚠️ IP[%1]未连接").arg(targetIp));
-    }
+    sendToIp(targetIp, absoluteRectMessage(x, y, width, height));
 }
 
 void Tcpserver::Tcp_sent_rect(const QString& targetIp, float x, float y, float width, float height)
 {
-    QString message = QString("RECT:%1:%2:%3:%4\r\n")
-                         .arg(QString::number(x, 'f', 4))
-                         .arg(QString::number(y, 'f', 4))
-                         .arg(QString::number(width, 'f', 4))
-                         .arg(QString::number(height, 'f', 4));
-    
-    if (targetIp.isEmpty() || targetIp == "all") {
-        for (QTcpSocket* sock : clientSockets) {
-            if (sock->state() == QAbstractSocket::ConnectedState) {
-                sock->write(message.toUtf8());
-                sock->flush();  // 立即发送数据
-            }
-        }
-        textBrowser->append("→ [广播] " + message.trimmed());
-    } else if (ipToSocketMap.contains(targetIp)) {
-        QTcpSocket* sock = ipToSocketMap.value(targetIp);
-        if (sock->state() == QAbstractSocket::ConnectedState) {
-            sock->write(message.toUtf8());
-                sock->flush();  // 立即发送数据
-            int cameraId = ipToCameraMap.value(targetIp, -1);
-            if (cameraId > 0) {
-                textBrowser->append(QString("→ [IP:%1|摄像头%2] %3")
-                                   .arg(targetIp)
-                                   .arg(cameraId)
-                                   .arg(message.trimmed()));
-            } else {
-                textBrowser->append(QString("→ [IP:%1] %2")
-                                   .arg(targetIp)
-                                   .arg(message.trimmed()));
-            }
-        }
-    } else {
-        textBrowser->append(QString("⚠️ IP[%1]未连接").arg(targetIp));
-    }
+    sendToIp(targetIp, normalizedRectMessage(x, y, width, height));
 }
 
 void Tcpserver::Tcp_sent_list(const QString& targetIp, const QSet<int>& objectIds)
 {
-    QStringList idList;
-    for (int id : objectIds) {
-        idList.append(QString::number(id));
-    }
-    
-    QString message = QString("LIST:%1\r\n").arg(idList.join(","));
-    
-    if (targetIp.isEmpty() || targetIp == "all") {
-        for (QTcpSocket* sock : clientSockets) {
-            if (sock->state() == QAbstractSocket::ConnectedState) {
-                sock->write(message.toUtf8());
-                sock->flush();  // 立即发送数据
-            }
-        }
-        textBrowser->append("→ [广播] " + message.trimmed());
-    } else if (ipToSocketMap.contains(targetIp)) {
-        QTcpSocket* sock = ipToSocketMap.value(targetIp);
-        if (sock->state() == QAbstractSocket::ConnectedState) {
-            sock->write(message.toUtf8());
-                sock->flush();  // 立即发送数据
-            int cameraId = ipToCameraMap.value(targetIp, -1);
-            if (cameraId > 0) {
-                textBrowser->append(QString("→ [IP:%1|摄像头%2] %3")
-                                   .arg(targetIp)
-                                   .arg(cameraId)
-                                   .arg(message.trimmed()));
-            } else {
-                textBrowser->append(QString("→ [IP:%1] %2")
-                                   .arg(targetIp)
-                                   .arg(message.trimmed()));
-            }
-        }
-    } else {
-        textBrowser->append(QString("⚠️ IP[%1]未连接").arg(targetIp));
-    }
+    sendToIp(targetIp, objectListMessage(objectIds));
 }
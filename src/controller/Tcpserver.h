@@ -1,19 +1,20 @@
 #pragma once
 #include <QWidget>
-#include <QTcpServer>
-#include <QTcpSocket>
 #include <QThread>
 #include <QPushButton>
 #include <QLabel>
 #include <QLineEdit>
 #include <QComboBox>
 #include <QSpinBox>
-#include <QTextBrowser>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QList>
 #include <QNetworkInterface>
 #include <QNetworkAddressEntry>
+#include <QMap>
+#include <QVector>
+#include "TcpNetworkWorker.h"
+#include "EventLogView.h"
 
 // 设备ID枚举定义
 enum DeviceID {
@@ -71,28 +72,31 @@ public:
     int getCurrentCameraId() const;                           // 获取当前选中的摄像头ID
     QStringList getConnectedIps() const;                      // 获取所有已连接的IP地址列表
 
-    // 公有成员：文本显示区（为了让Controller能够访问）
-    QTextBrowser* textBrowser;         // 文本显示区
+    // 公有成员：通信日志（为了让Controller能够访问）
+    EventLogView* logView;             // 通信日志（固定容量，可按类型和摄像头筛选）
 
 signals:
     void tcpClientConnected(const QString& ip, quint16 port); // 新增：客户端连接成功信号
-    void detectionDataReceived(int cameraId, const QString& detectionData); // 新增：检测数据接收信号（含摄像头ID）
+    // 一批检测消息（网络线程每50 ms投递一次，cameraId已按IP绑定确定，-1表示未绑定）
+    void detectionsReceived(const QVector<DetectionEvent>& events);
 
 private slots:
-    void clearTextBrowser();           // 清空文本显示
+    void clearLog();                   // 清空通信日志
     void sendMessages();               // 发送消息给客户端
-    void clientConnected();            // 有客户端连接
-    void receiveMessages();            // 接收客户端消息
     void lockip();                     // 锁定/解锁IP输入框
-    void socketStateChange(QAbstractSocket::SocketState state); // socket状态变化处理
+    void onListenStateChanged(bool listening, const QString& error); // 监听结果（失败时恢复控件）
+    void onClientConnected(const QString& ip, quint16 port);         // 有客户端连接
+    void onClientDisconnected(const QString& ip);                    // 客户端断开
+    void onBatchReady(const QVector<TcpTextMessage>& texts, int omittedTexts,
+                      const QVector<DetectionEvent>& detections);    // 网络线程投递的一批数据
 
 private:
     QString getLocalIPAddress();       // 获取本机首选IPv4地址（自动选择最佳IP）
     void getLocalHostIP();             // 获取本地所有IP
-    void processDetectionData(int cameraId, const QString& data); // 新增：处理检测数据（含摄像头ID）
-    QTcpServer* tcpServer;             // TCP服务器对象
-    QList<QTcpSocket*> clientSockets;  // 已连接的客户端socket列表
-    QMap<QString, QTcpSocket*> ipToSocketMap;  // IP地址到Socket的映射
+    void postSend(const QString& ip, const QString& message);           // 交给网络线程发送
+    void sendToCamera(int targetCameraId, const QString& message);      // 发送并记录（0表示广播）
+    void sendToIp(const QString& targetIp, const QString& message);     // 发送并记录（空或"all"表示广播）
+    QMap<QString, quint16> m_connectedClients; // 已连接客户端的IP和端口（socket由网络线程持有）
     QMap<QString, int> ipToCameraMap;  // IP地址到摄像头ID的映射
     QMap<int, QString> cameraToIpMap;  // 摄像头ID到IP地址的映射
     int m_currentCameraId;             // 当前选中的摄像头ID
@@ -107,6 +111,7 @@ private:
     QWidget* hWidget[3];               // 水平布局用的widget
     QWidget* vWidget;                  // 主widget
     QList<QHostAddress> IPlist;        // 本地IP列表
+    TcpNetworkWorker* m_worker;        // 网络对象（在服务器线程中运行）
     TcpServerThread* serverThread;     // 服务器线程指针
 
 };
@@ -8,11 +8,17 @@
 #include <QCoreApplication>
 #include <QRegExp>
 #include <QUrl>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QScreen>
+#include <QGuiApplication>
 #include "Picture.h"
 #include "Tcpserver.h" // Added for Tcpserver
 #include "plan.h"      // Added for Plan and PlanData
 #include "common.h"
+#include "AlarmClipWriter.h"
 #include "../view/AddCameraDialog.h" // 添加摄像头对话框
+#include "../view/DecoderOptionsDialog.h" // 解码设置对话框
 
 Controller::Controller(Model* model, View* view, QObject* parent)
     : QObject(parent), m_model(model), m_view(view), m_nextStreamId(1)
@@ -32,15 +38,21 @@ Controller::Controller(Model* model, View* view, QObject* parent)
     for(QPushButton* btn : funBtns) {
         connect(btn, &QPushButton::clicked, this, &Controller::FunButtonClickedHandler);
     }
-    // 绑定更新视频流信号槽
-    connect(m_model, &Model::frameReady, this, &Controller::onFrameReady);
-    connect(m_model, &Model::streamDisconnected, this, [this](const QString& url) {
-        m_view->addEventMessage("warning", QString("视频流断开: %1").arg(url));
-    });
-    connect(m_model, &Model::streamReconnecting, this, [this](const QString& url) {
-        m_view->addEventMessage("info", QString("正在尝试重连: %1").arg(url));
-    });
-
+    // 帧时钟：按屏幕刷新率轮询各路最新帧邮箱，解码线程不再通过排队信号投递帧
+    m_frameTimer = new QTimer(this);
+    m_frameTimer->setTimerType(Qt::PreciseTimer);
+    QScreen* screen = QGuiApplication::primaryScreen();
+    qreal refreshRate = screen ? screen->refreshRate() : 60.0;
+    m_frameTimer->setInterval(qMax(1, qRound(1000.0 / (refreshRate > 0 ? refreshRate : 60.0))));
+    connect(m_frameTimer, &QTimer::timeout, this, &Controller::onFrameTick);
+    m_frameTimer->start();
+    
+    // 统计时钟：每秒采样一次各路性能计数器
+    m_statsTimer = new QTimer(this);
+    m_statsTimer->setInterval(1000);
+    connect(m_statsTimer, &QTimer::timeout, this, &Controller::onStatsTick);
+    m_statsTimer->start();
+    
     // 绑定矩形框确认信号
     connect(m_view, &View::rectangleConfirmed, this, &Controller::onRectangleConfirmed);
 
@@ -53,11 +65,21 @@ Controller::Controller(Model* model, View* view, QObject* parent)
     connect(m_view, &View::streamPauseRequested, this, &Controller::onStreamPauseRequested);
     connect(m_view, &View::streamScreenshotRequested, this, &Controller::onStreamScreenshotRequested);
     connect(m_view, &View::addCameraWithIdRequested, this, &Controller::onAddCameraWithIdRequested);
+    connect(m_view, &View::streamCloseRequested, this, &Controller::removeVideoStream);
+    connect(m_view, &View::streamDisplaySizeChanged, this, &Controller::onStreamDisplaySizeChanged);
+    connect(m_view, &View::videoLayoutUpdated, this, &Controller::updateDecodePolicies);
+    connect(&m_streamRegistry, &StreamRegistry::sinkModelChanged, this, &Controller::onSinkModelChanged);
+    connect(m_view, &View::streamDecoderSettingsRequested, this, &Controller::onStreamDecoderSettingsRequested);
+    connect(m_view, &View::streamRecordRequested, this, &Controller::onStreamRecordRequested);
+    connect(&m_snapshotWriter, &SnapshotWriter::snapshotSaved, this, &Controller::onSnapshotSaved);
+    
+    // 打开摄像头配置数据库（失败时使用默认配置）
+    m_cameraStore.open();
 
     // 如果稍后设置tcpWin，也会在setTcpServer中再连接
     if (tcpWin) {
         connect(tcpWin, &Tcpserver::tcpClientConnected, this, &Controller::onTcpClientConnected);
-        connect(tcpWin, &Tcpserver::detectionDataReceived, this, &Controller::onDetectionDataReceived);
+        connect(tcpWin, &Tcpserver::detectionsReceived, this, &Controller::onDetectionsReceived);
     }
 }
 
@@ -76,32 +98,41 @@ void Controller::setTcpServer(Tcpserver* tcpServer)
     tcpWin = tcpServer;
     if (tcpWin) {
         connect(tcpWin, &Tcpserver::tcpClientConnected, this, &Controller::onTcpClientConnected);
-        connect(tcpWin, &Tcpserver::detectionDataReceived, this, &Controller::onDetectionDataReceived);
+        connect(tcpWin, &Tcpserver::detectionsReceived, this, &Controller::onDetectionsReceived);
     }
 }
 
 // 添加摄像头按钮点击处理函数
 void Controller::onAddCameraClicked()
 {
-    // 获取可用的摄像头位置ID (1-16)
+    // 获取可用的摄像头位置ID (1-View::MaxCameraCount)
     QList<int> availableIds = m_view->getAvailableCameraIds();
     if (availableIds.isEmpty()) {
-        QMessageBox::warning(m_view, "错误", "所有摄像头位置（1-16）已被占用！\n请先删除已有的摄像头。");
+        QMessageBox::warning(m_view, "错误", QString("所有摄像头位置（1-%1）已被占用！\n请先删除已有的摄像头。")
+                             .arg(View::MaxCameraCount));
         m_view->addEventMessage("warning", "所有摄像头位置已被占用");
         return;
     }
     
     // 创建并显示自定义添加摄像头对话框
     AddCameraDialog dialog(availableIds, m_view);
+    // 预填已保存的连接参数和子码流地址，切换摄像头ID时重新载入，避免把其他位置的配置保存到所选位置
+    auto prefill = [this, &dialog](int cameraId) {
+        dialog.setOpenOptions(m_cameraStore.loadOpenOptions(cameraId));
+        dialog.setSubRtspUrl(m_cameraStore.loadSubRtspUrl(cameraId));
+    };
+    prefill(availableIds.first());
+    connect(&dialog, &AddCameraDialog::cameraIdSelected, &dialog, prefill);
     
     if (dialog.exec() == QDialog::Accepted) {
         // 获取用户输入的信息
         int cameraId = dialog.getSelectedCameraId();
         QString url = dialog.getRtspUrl();
         QString name = dialog.getCameraName();
+        m_cameraStore.saveOpenOptions(cameraId, dialog.getOpenOptions());
         
         // 添加视频流
-        addVideoStream(url, name, cameraId);
+        addVideoStream(url, name, cameraId, dialog.getSubRtspUrl());
         
         m_view->addEventMessage("success", QString("正在添加摄像头 %1: %2").arg(cameraId).arg(name));
         
@@ -163,24 +194,22 @@ void Controller::onAddCameraClicked()
     }
 }
 
-void Controller::onFrameReady(const QImage& img)
+void Controller::onFrameReady(const FrameHandle& frame)
 {
-    if (!img.isNull())
+    if (!frame.isNull())
     {
-        m_lastImage = img; // 保存最近一帧图像
+        m_lastFrame = frame; // 保存最近一帧图像
+        const QImage& img = frame.image();
         
         // 主视频流现在主要用于绘框功能
-        // 只在需要时更新videoLabel（绘框模式或旧代码兼容）
-        VideoLabel* videoLabel = m_view->getVideoLabel();
-        if (videoLabel && videoLabel->isVisible()) {
-            videoLabel->setPixmap(QPixmap::fromImage(img).scaled(videoLabel->size(), Qt::KeepAspectRatio));
-        }
+        // 只在videoLabel可见时更新（绘框模式或旧代码兼容），缩放在View的缩放线程池中完成
+        m_view->updateVideoFrame(View::MainVideoStreamId, img);
     }
 }
 
 void Controller::saveImage()
 {
-    if (m_lastImage.isNull()) {
+    if (m_lastFrame.isNull()) {
         QMessageBox::warning(m_view, "提示", "当前没有可保存的图像！");
         m_view->addEventMessage("warning", "当前没有可保存的图像！");
         return;
@@ -190,15 +219,44 @@ void Controller::saveImage()
     QString sourcePath = QString(__FILE__).section('/', 0, -4); // 回退到项目根目录
     QDir dir(sourcePath + "/picture/save-picture");
     if (!dir.exists()) dir.mkpath(".");
-    // 生成文件名
+    // 生成文件名，编码和写文件交给截图写入线程，结果在onSnapshotSaved中提示
+    // 优先从源数据解码原始分辨率的画面，不可用时使用最近一帧（深拷贝，脱离帧池缓冲区）
     QString fileName = dir.filePath(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss_zzz") + ".jpg");
-    if (m_lastImage.save(fileName)) {
-        QMessageBox::information(m_view, "截图成功", "图片已保存到: " + fileName);
-        m_view->addEventMessage("success", "截图成功，图片已保存到: " + fileName);
-    } else {
-        QMessageBox::critical(m_view, "保存失败", "图片保存失败！");
-        m_view->addEventMessage("error", "图片保存失败！");
+    std::shared_ptr<PacketGop> source = sourceGopForStream(View::MainVideoStreamId);
+    bool accepted = source ? m_snapshotWriter.submit(source, fileName)
+                           : m_snapshotWriter.submit(m_lastFrame.image().copy(), fileName);
+    if (!accepted) {
+        m_view->addEventMessage("warning", "截图队列已满，请稍后再试");
+    }
+}
+
+// 截图和报警的源数据：视频块优先取主码流（显示子码流时也按原始分辨率保存），主画面取其共享的解码器
+// （地址已被视频块打开时主画面共享该视频块的Model，m_model不接收数据）
+Model* Controller::sourceModelForStream(int streamId) const
+{
+    if (streamId == View::MainVideoStreamId) {
+        return m_streamRegistry.modelForSink(View::MainVideoStreamId);
+    }
+    if (!m_streamSources.contains(streamId)) {
+        return nullptr;
     }
+    Model* model = m_streamRegistry.modelForUrl(m_streamSources.value(streamId).mainUrl);
+    return model ? model : m_streamModels.value(streamId, nullptr);
+}
+
+std::shared_ptr<PacketGop> Controller::sourceGopForStream(int streamId) const
+{
+    Model* model = sourceModelForStream(streamId);
+    return model ? model->packetBuffer().latestGop() : std::shared_ptr<PacketGop>();
+}
+
+Model* Controller::alarmSourceModel(int cameraId) const
+{
+    if (cameraId <= 0) {
+        return sourceModelForStream(View::MainVideoStreamId);
+    }
+    int streamId = m_view->getStreamIdForCamera(cameraId);
+    return streamId != -1 ? sourceModelForStream(streamId) : nullptr;
 }
 
 void Controller::saveAlarmImage(int cameraId, const QString& detectionInfo)
@@ -209,25 +267,34 @@ void Controller::saveAlarmImage(int cameraId, const QString& detectionInfo)
         return;
     }
     
-    // 根据摄像头ID获取对应的流图像
+    // 优先使用该摄像头的源数据（最近一组GOP），在编码线程中解码出原始分辨率的画面作为报警证据
+    std::shared_ptr<PacketGop> source;
     QImage imageToSave;
     
     if (cameraId > 0) {
-        // 尝试从View的VideoLabel直接获取该摄像头的当前图像
-        imageToSave = m_view->getCurrentFrameForCamera(cameraId);
-        if (!imageToSave.isNull()) {
-            qDebug() << "成功获取摄像头" << cameraId << "的当前帧图像";
-        } else {
-            qDebug() << "警告：无法获取摄像头" << cameraId << "的图像";
+        if (Model* model = alarmSourceModel(cameraId)) {
+            source = model->packetBuffer().latestGop();
+        }
+        if (!source) {
+            // 源数据还没有关键帧（如刚打开）时，退回视频块的当前画面
+            imageToSave = m_view->getCurrentFrameForCamera(cameraId);
+            if (imageToSave.isNull()) {
+                qDebug() << "警告：无法获取摄像头" << cameraId << "的图像";
+            }
         }
     }
     
-    // 如果未指定摄像头或获取失败，使用主流图像（m_lastImage）作为备用
-    if (imageToSave.isNull()) {
-        if (!m_lastImage.isNull()) {
-            imageToSave = m_lastImage;
-            cameraId = 0; // 标记为主流
-            qDebug() << "警告：无法获取摄像头" << cameraId << "的图像，使用主流图像";
+    // 如果未指定摄像头或获取失败，使用主画面作为备用
+    if (!source && imageToSave.isNull()) {
+        cameraId = 0; // 标记为主流
+        if (Model* model = alarmSourceModel(0)) {
+            source = model->packetBuffer().latestGop();
+        }
+        if (source) {
+            qDebug() << "使用主画面的源数据保存报警图片";
+        } else if (!m_lastFrame.isNull()) {
+            imageToSave = m_lastFrame.image().copy(); // 深拷贝，脱离帧池缓冲区
+            qDebug() << "使用主画面的当前帧保存报警图片";
         } else {
             qDebug() << "错误：当前没有可保存的图像！";
             m_view->addEventMessage("warning", "检测到目标但当前没有可保存的图像！");
@@ -254,14 +321,38 @@ void Controller::saveAlarmImage(int cameraId, const QString& detectionInfo)
         fileName = dir.filePath(QString("alarm_main_%1.jpg").arg(timestamp));
     }
     
-    // 保存图像
-    if (imageToSave.save(fileName)) {
-        QString successMsg = QString("摄像头%1检测到目标，报警图片已保存: %2").arg(cameraId).arg(fileName);
-        qDebug() << successMsg;
-        m_view->addEventMessage("alarm", successMsg);
+    // 交给截图写入线程保存：同一摄像头按AlarmSnapshotIntervalMs限速，排队中的报警图片只保留最新一张
+    QString key = QString("alarm:%1").arg(cameraId);
+    bool accepted = source ? m_snapshotWriter.submit(source, fileName, -1, key, AlarmSnapshotIntervalMs)
+                           : m_snapshotWriter.submit(imageToSave, fileName, -1, key, AlarmSnapshotIntervalMs);
+    if (!accepted) {
+        qDebug() << "摄像头" << cameraId << "报警图片限速或队列已满，跳过";
+    }
+}
+
+// 截图写入完成：报警图片（带key）只记录事件，手动截图弹出结果提示
+void Controller::onSnapshotSaved(const QString& fileName, bool success, const QString& key)
+{
+    if (!key.isEmpty()) {
+        if (success) {
+            int cameraId = key.section(':', 1).toInt();
+            QString successMsg = QString("摄像头%1检测到目标，报警图片已保存: %2").arg(cameraId).arg(fileName);
+            qDebug() << successMsg;
+            m_view->addEventMessage("alarm", successMsg);
+        } else {
+            qDebug() << "错误：报警图片保存失败！" << fileName;
+            m_view->addEventMessage("error", "报警图片保存失败！");
+        }
+        return;
+    }
+    if (success) {
+        qDebug() << "截图成功:" << fileName;
+        m_view->addEventMessage("success", "截图成功，图片已保存到: " + fileName);
+        QMessageBox::information(m_view, "截图成功", "图片已保存到: " + fileName);
     } else {
-        qDebug() << "错误：报警图片保存失败！";
-        m_view->addEventMessage("error", "报警图片保存失败！");
+        qDebug() << "截图失败:" << fileName;
+        m_view->addEventMessage("error", "图片保存失败！");
+        QMessageBox::critical(m_view, "保存失败", "图片保存失败！");
     }
 }
 
@@ -313,20 +404,18 @@ void Controller::ButtonClickedHandler()
                 break;
             }
             
-            Model* model = m_streamModels.value(streamId);
-            
-            // 切换暂停/恢复状态
-            if (model->isPaused()) {
-                model->resumeStream();
-                m_view->addEventMessage("success", QString("已恢复摄像头%1的视频流").arg(currentCameraId));
+            // 切换暂停/恢复状态（共享解码器时只暂停该画面，全部画面暂停时才暂停解码）
+            if (m_streamRegistry.isSinkPaused(streamId)) {
+                m_streamRegistry.setSinkPaused(streamId, false);
+                m_view->addEventMessage("success", QString("已恢复摄像头%1的视频流").arg(currentCameraId), currentCameraId);
                 qDebug() << "已恢复摄像头" << currentCameraId << "的视频流";
                 
                 if (tcpWin && tcpWin->hasConnectedClients()) {
                     tcpWin->Tcp_sent_info(currentCameraId, DEVICE_CAMERA, RTSP_ENABLE, 1);
                 }
             } else {
-                model->pauseStream();
-                m_view->addEventMessage("info", QString("已暂停摄像头%1的视频流").arg(currentCameraId));
+                m_streamRegistry.setSinkPaused(streamId, true);
+                m_view->addEventMessage("info", QString("已暂停摄像头%1的视频流").arg(currentCameraId), currentCameraId);
                 qDebug() << "已暂停摄像头" << currentCameraId << "的视频流";
                 
                 if (tcpWin && tcpWin->hasConnectedClients()) {
@@ -693,6 +782,15 @@ void Controller::FunButtonClickedHandler()
         }
         break;
 
+    case 6: // 性能统计
+        qDebug() << "性能统计按钮被点击";
+        m_statsOverlayEnabled = isChecked;
+        for (int streamId : m_streamModels.keys()) {
+            m_view->setStreamStatsText(streamId, isChecked ? getStreamStats(streamId).toDisplayText() : QString());
+        }
+        m_view->addEventMessage("info", isChecked ? "性能统计叠加显示已开启" : "性能统计叠加显示已关闭");
+        break;
+
     case 5: // 报警保存
         qDebug() << "报警保存按钮被点击";
         {
@@ -998,11 +1096,24 @@ void Controller::onPlanApplied(const PlanData& plan)
     
     // 应用RTSP地址 - 自动启动视频流
     if (!plan.rtspUrl.isEmpty()) {
-        m_model->startStream(plan.rtspUrl);
+        startMainStream(plan.rtspUrl);
         QString cameraName = (plan.cameraId == 0) ? "主流" : QString("子流%1").arg(plan.cameraId);
         m_view->addEventMessage("info", QString("[%1] 已设置RTSP地址: %2").arg(cameraName).arg(plan.rtspUrl));
     }
     
+    // 应用子码流地址：目标摄像头的视频块按布局在主/子码流间切换（与添加摄像头时填写的子码流相同）
+    int planStreamId = plan.cameraId > 0 ? m_view->getStreamIdForCamera(plan.cameraId) : -1;
+    if (!plan.subRtspUrl.isEmpty() && m_streamSources.contains(planStreamId)) {
+        StreamSource& source = m_streamSources[planStreamId];
+        if (source.subUrl != plan.subRtspUrl) {
+            source.subUrl = plan.subRtspUrl;
+            m_cameraStore.saveCamera(source.cameraId, source.name, source.mainUrl, source.subUrl);
+            updateDecodePolicies();
+            m_view->addEventMessage("info", QString("[摄像头%1] 已设置子码流地址: %2")
+                                    .arg(plan.cameraId).arg(plan.subRtspUrl), plan.cameraId);
+        }
+    }
+    
     // 获取功能按钮列表
     QList<QPushButton*> funButtons = m_view->getFunButtons();
     if (funButtons.size() < 3) {
@@ -1102,26 +1213,82 @@ void Controller::onPlanApplied(const PlanData& plan)
     m_view->addEventMessage("success", QString("方案 \"%1\" 应用成功！").arg(plan.name));
 }
 
+// 网络线程批量投递的检测消息：同一摄像头在一批中只处理最新的一条，消息洪泛时界面线程的工作量只随摄像头数增长
+void Controller::onDetectionsReceived(const QVector<DetectionEvent>& events)
+{
+    QMap<int, int> latest; // 摄像头ID -> 该摄像头最新一条消息的下标
+    for (int i = 0; i < events.size(); ++i) {
+        latest.insert(events[i].cameraId, i);
+    }
+    for (int index : latest) {
+        onDetectionDataReceived(events[index].cameraId, events[index].summary);
+    }
+}
+
 void Controller::onDetectionDataReceived(int cameraId, const QString& detectionData)
 {
     qDebug() << "Controller接收到检测数据 [摄像头ID:" << cameraId << "]:" << detectionData;
     
     // 记录检测事件到消息系统（包含摄像头信息）
     if (cameraId > 0) {
-        m_view->addEventMessage("info", QString("🎯 摄像头%1检测到目标: %2").arg(cameraId).arg(detectionData));
+        m_view->addEventMessage("info", QString("🎯 摄像头%1检测到目标: %2").arg(cameraId).arg(detectionData), cameraId);
     } else {
         m_view->addEventMessage("info", QString("🎯 检测到目标: %1 (未绑定摄像头)").arg(detectionData));
     }
     
     // 调用报警图像保存函数，传入摄像头ID
     saveAlarmImage(cameraId, detectionData);
+    saveAlarmClip(cameraId);
+}
+
+// 保存报警片段：预录缓冲中的数据包加上之后AlarmPostRollMs的数据包，不重新编码直接封装为MP4
+void Controller::saveAlarmClip(int cameraId)
+{
+    if (!m_alarmSaveEnabled || m_recordingAlarmClips.contains(cameraId)) {
+        return;
+    }
+    
+    // 与报警图片使用同一路源数据，未绑定摄像头时使用主画面的视频流
+    Model* model = alarmSourceModel(cameraId);
+    if (!model) {
+        qDebug() << "摄像头" << cameraId << "没有正在接收的视频流，跳过报警片段";
+        return;
+    }
+    
+    QString sourcePath = QString(__FILE__).section('/', 0, -4); // 回退到项目根目录
+    QDir dir(sourcePath + "/picture/alarm-video");
+    if (!dir.exists()) {
+        dir.mkpath(".");
+    }
+    QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss_zzz");
+    QString fileName = cameraId > 0
+        ? dir.filePath(QString("alarm_cam%1_%2.mp4").arg(cameraId).arg(timestamp))
+        : dir.filePath(QString("alarm_main_%1.mp4").arg(timestamp));
+    
+    AlarmClipWriter* clip = new AlarmClipWriter(fileName, AlarmPostRollMs);
+    if (!clip->start(model->packetBuffer())) {
+        delete clip;
+        qDebug() << "摄像头" << cameraId << "预录缓冲中还没有关键帧，跳过报警片段";
+        return;
+    }
+    m_recordingAlarmClips.insert(cameraId);
+    connect(clip, &AlarmClipWriter::finished, this,
+            [this, cameraId](const QString& savedFile, bool success, qint64 durationMs) {
+        m_recordingAlarmClips.remove(cameraId);
+        if (success) {
+            m_view->addEventMessage("alarm", QString("摄像头%1报警片段已保存（%2 秒）: %3")
+                                    .arg(cameraId).arg(durationMs / 1000.0, 0, 'f', 1).arg(savedFile), cameraId);
+        } else {
+            m_view->addEventMessage("error", QString("摄像头%1报警片段保存失败").arg(cameraId), cameraId);
+        }
+    });
 }
 
 // ============================================
 // 多路视频流管理功能实现
 // ============================================
 
-void Controller::addVideoStream(const QString& url, const QString& name, int cameraId)
+void Controller::addVideoStream(const QString& url, const QString& name, int cameraId, const QString& subUrl)
 {
     if (url.isEmpty()) {
         m_view->addEventMessage("warning", "视频流URL为空");
@@ -1141,31 +1308,39 @@ void Controller::addVideoStream(const QString& url, const QString& name, int cam
     // 在View中添加视频流显示（传入摄像头ID）
     m_view->addVideoStream(streamId, name.isEmpty() ? QString("摄像头 %1").arg(cameraId) : name, cameraId);
     
-    // 创建新的Model实例
-    Model* model = new Model(this);
-    
-    // 连接帧信号（使用lambda捕获streamId）
-    connect(model, &Model::frameReady, this, [this, streamId](const QImage& frame) {
-        onModelFrameReady(streamId, frame);
-    });
-    
-    // 连接流断开和重连信号
-    connect(model, &Model::streamDisconnected, this, [this, cameraId, name](const QString& url) {
-        m_view->addEventMessage("warning", QString("摄像头 %1 (%2) 断开连接").arg(cameraId).arg(name));
-    });
-    
-    connect(model, &Model::streamReconnecting, this, [this, cameraId, name](const QString& url) {
-        m_view->addEventMessage("info", QString("摄像头 %1 (%2) 正在尝试重连...").arg(cameraId).arg(name));
-    });
-    
-    // 启动视频流
-    model->startStream(url);
+    // 从注册表获取解码器：同一地址已打开时（如主画面或其他视频块）直接共享，不再建立新的RTSP会话
+    // 首次打开时应用该摄像头的连接参数和解码器配置
+    // 新添加的视频流会被自动选中，先打开主码流；之后由updateDecodePolicies按布局切换到子码流
+    m_cameraStore.saveCamera(cameraId, name, url, subUrl);
+    StreamSource source;
+    source.mainUrl = url;
+    source.subUrl = subUrl;
+    source.cameraId = cameraId;
+    source.name = name;
+    m_streamSources.insert(streamId, source);
+    bool shared = false;
+    Model* model = m_streamRegistry.acquire(streamId, url,
+                                            m_cameraStore.loadOpenOptions(cameraId),
+                                            m_cameraStore.loadDecoderOptions(cameraId),
+                                            nullptr, &shared);
+    connectStreamSignals(streamId, model);
     
     // 保存到映射表
     m_streamModels.insert(streamId, model);
+    if (shared) {
+        m_view->addEventMessage("info", QString("摄像头 %1 与已打开的画面共享视频流，不再重复连接").arg(cameraId));
+    }
+    
+    // 按当前布局设置解码策略
+    updateDecodePolicies();
+    
+    // 恢复该摄像头的连续录像
+    if (m_cameraStore.loadRecordEnabled(cameraId)) {
+        startRecording(cameraId);
+    }
     
     // 记录日志
-    qDebug() << "添加视频流:" << streamId << "摄像头ID:" << cameraId << "URL:" << url << "Name:" << name;
+    qDebug() << "添加视频流:" << streamId << "摄像头ID:" << cameraId << "URL:" << url << "子码流:" << subUrl << "Name:" << name;
     m_view->addEventMessage("success", QString("添加摄像头 %1 成功: %2").arg(cameraId).arg(name));
     
     // 自动选中新添加的视频流（这样用户可以立即对其进行操作）
@@ -1174,18 +1349,130 @@ void Controller::addVideoStream(const QString& url, const QString& name, int cam
     // 不再自动切换布局，保持用户当前选择的布局模式
 }
 
+// 连接视频块的Model信号：视频流删除或切换码流时注册表自动断开这些连接
+void Controller::connectStreamSignals(int streamId, Model* model)
+{
+    QObject* context = m_streamRegistry.sinkContext(streamId);
+    int cameraId = m_streamSources.value(streamId).cameraId;
+    QString name = m_streamSources.value(streamId).name;
+    
+    // 连接流断开和重连信号
+    connect(model, &Model::streamDisconnected, context, [this, cameraId, name](const QString& url, int attempt, const QDateTime& nextRetry) {
+        m_view->addEventMessage("warning", QString("摄像头 %1 (%2) 断开连接（第%3次失败，%4 重试）")
+                                .arg(cameraId).arg(name).arg(attempt).arg(nextRetry.toString("hh:mm:ss")));
+    });
+    
+    connect(model, &Model::streamReconnecting, context, [this, cameraId, name](const QString& url, int attempt) {
+        m_view->addEventMessage("info", QString("摄像头 %1 (%2) 正在尝试第%3次重连...").arg(cameraId).arg(name).arg(attempt));
+    });
+    
+    // 平均解码耗时显示在画面提示中
+    connect(model, &Model::decodeTimeUpdated, context, [this, streamId](double averageMs) {
+        VideoLabel* label = m_view->getVideoLabelForStream(streamId);
+        if (label) {
+            label->setToolTip(QString("平均解码耗时: %1 ms").arg(averageMs, 0, 'f', 2));
+        }
+    });
+    
+    // 每次打开流后报告首帧耗时，便于调整连接参数
+    connect(model, &Model::firstFrameDecoded, context, [this, cameraId](qint64 openMs, qint64 firstFrameMs) {
+        qDebug() << "摄像头" << cameraId << "首帧耗时:" << firstFrameMs << "ms（打开与探测" << openMs << "ms）";
+        m_view->addEventMessage("info", QString("摄像头 %1 首帧耗时 %2 ms（打开与探测 %3 ms）")
+                                .arg(cameraId).arg(firstFrameMs).arg(openMs));
+    });
+}
+
+// 开始/停止视频流的连续录像，并保存录像开关
+void Controller::onStreamRecordRequested(int streamId)
+{
+    int cameraId = m_view->getCameraIdForStream(streamId);
+    if (cameraId <= 0) {
+        return;
+    }
+    if (m_recorders.contains(cameraId)) {
+        stopRecording(cameraId);
+        m_cameraStore.saveRecordEnabled(cameraId, false);
+        m_view->addEventMessage("info", QString("摄像头 %1 已停止录像").arg(cameraId));
+    } else if (startRecording(cameraId)) {
+        m_cameraStore.saveRecordEnabled(cameraId, true);
+        m_view->addEventMessage("success", QString("摄像头 %1 开始录像").arg(cameraId));
+    }
+}
+
+// 开始连续录像：以录像sink引用主码流并设为只解复用，数据包从解复用线程直接进入写入线程，不解码
+bool Controller::startRecording(int cameraId)
+{
+    int streamId = m_view->getStreamIdForCamera(cameraId);
+    if (m_recorders.contains(cameraId) || !m_streamSources.contains(streamId)) {
+        return false;
+    }
+    const StreamSource source = m_streamSources.value(streamId);
+    int sinkId = recordSinkId(cameraId);
+    Model* model = m_streamRegistry.acquire(sinkId, source.mainUrl,
+                                            m_cameraStore.loadOpenOptions(cameraId),
+                                            m_cameraStore.loadDecoderOptions(cameraId));
+    m_streamRegistry.setSinkDecodePolicy(sinkId, DecodePolicy::DemuxOnly); // 只有录像引用时不解码
+    
+    QString sourcePath = QString(__FILE__).section('/', 0, -4); // 回退到项目根目录
+    SegmentRecorder* recorder = new SegmentRecorder(sourcePath + "/record", QString("cam%1").arg(cameraId),
+                                                    RecordOptions(), this);
+    connect(recorder, &QThread::finished, recorder, &QObject::deleteLater);
+    connect(recorder, &SegmentRecorder::segmentFinished, this,
+            [this, cameraId](const QString& fileName, qint64 bytes, qint64 durationMs) {
+        qDebug() << "摄像头" << cameraId << "录像分段" << fileName << bytes << "字节" << durationMs << "ms";
+        m_view->addEventMessage("info", QString("摄像头%1录像分段已保存（%2 秒，%3 MB）: %4").arg(cameraId)
+                                .arg(durationMs / 1000).arg(bytes / (1024.0 * 1024.0), 0, 'f', 1).arg(fileName));
+    });
+    connect(recorder, &SegmentRecorder::recordError, this, [this, cameraId](const QString& message) {
+        m_view->addEventMessage("error", QString("摄像头%1录像错误：%2").arg(cameraId).arg(message));
+    });
+    recorder->start(model->packetBuffer());
+    m_recorders.insert(cameraId, recorder);
+    m_view->setStreamRecording(streamId, true);
+    qDebug() << "摄像头" << cameraId << "开始录像:" << source.mainUrl;
+    return true;
+}
+
+// 停止连续录像：先从预录缓冲摘除录像，再释放录像sink（解码器可能随之关闭）
+void Controller::stopRecording(int cameraId)
+{
+    SegmentRecorder* recorder = m_recorders.take(cameraId);
+    if (!recorder) {
+        return;
+    }
+    recorder->stop(); // 写入线程关闭当前分段后退出并自行删除
+    m_streamRegistry.release(recordSinkId(cameraId));
+    m_view->setStreamRecording(m_view->getStreamIdForCamera(cameraId), false);
+    qDebug() << "摄像头" << cameraId << "停止录像";
+}
+
+// 视频流完成主/子码流切换：新码流已出首帧，旧码流的信号连接已由注册表断开
+void Controller::onSinkModelChanged(int sinkId, Model* model)
+{
+    if (!m_streamModels.contains(sinkId)) {
+        return; // 主画面不切换码流
+    }
+    m_streamModels.insert(sinkId, model);
+    m_streamStats.remove(sinkId); // 计数器属于新的Model，重新采样
+    connectStreamSignals(sinkId, model);
+    qDebug() << "视频流" << sinkId << "码流切换完成";
+}
+
 void Controller::removeVideoStream(int streamId)
 {
-    if (!m_streamModels.contains(streamId)) {
+    if (!m_streamSources.contains(streamId)) {
         qDebug() << "警告：尝试删除不存在的视频流ID:" << streamId;
         return;
     }
     
-    // 停止并删除Model
-    Model* model = m_streamModels.take(streamId);
-    model->stopStream();
-    model->wait();
-    model->deleteLater();
+    // 停止录像（保留录像开关，重新添加时恢复）
+    stopRecording(m_streamSources.value(streamId).cameraId);
+    
+    // 释放共享解码器的引用，最后一个画面释放时异步停止并删除Model（不在界面线程等待解码线程退出）
+    m_streamModels.remove(streamId);
+    m_streamSources.remove(streamId);
+    m_streamRegistry.release(streamId);
+    m_streamStats.remove(streamId);
     
     // 从View中移除
     m_view->removeVideoStream(streamId);
@@ -1197,16 +1484,39 @@ void Controller::removeVideoStream(int streamId)
     // 不再自动切换布局，保持用户当前选择的布局模式
 }
 
+// 启动主画面（绘框用的videoLabel）视频流：优先使用主Model，地址已被视频块打开时直接共享
+void Controller::startMainStream(const QString& url)
+{
+    bool shared = false;
+    Model* model = m_streamRegistry.acquire(View::MainVideoStreamId, url, OpenOptions(), DecoderOptions(),
+                                            m_model, &shared);
+    QObject* context = m_streamRegistry.sinkContext(View::MainVideoStreamId);
+    connect(model, &Model::streamDisconnected, context, [this](const QString& url, int attempt, const QDateTime& nextRetry) {
+        m_view->addEventMessage("warning", QString("视频流断开: %1（第%2次失败，%3 重试）")
+                                .arg(url).arg(attempt).arg(nextRetry.toString("hh:mm:ss")));
+    });
+    connect(model, &Model::streamReconnecting, context, [this](const QString& url, int attempt) {
+        m_view->addEventMessage("info", QString("正在尝试第%1次重连: %2").arg(attempt).arg(url));
+    });
+    if (shared) {
+        m_view->addEventMessage("info", "主画面与已打开的视频块共享视频流");
+    }
+}
+
 void Controller::clearAllStreams()
 {
-    // 停止并删除所有Model
-    for (auto it = m_streamModels.begin(); it != m_streamModels.end(); ++it) {
-        Model* model = it.value();
-        model->stopStream();
-        model->wait();
-        model->deleteLater();
+    // 停止所有录像（写入线程在后台关闭当前分段）
+    for (int cameraId : m_recorders.keys()) {
+        stopRecording(cameraId);
+    }
+    
+    // 释放所有视频块的解码器引用（先全部发出停止请求，各线程并行退出；主画面共享的解码器继续运行）
+    for (auto it = m_streamModels.constBegin(); it != m_streamModels.constEnd(); ++it) {
+        m_streamRegistry.release(it.key());
     }
     m_streamModels.clear();
+    m_streamSources.clear();
+    m_streamStats.clear();
     
     // 清除View中的所有流
     m_view->clearAllStreams();
@@ -1248,25 +1558,201 @@ void Controller::onStreamSelected(int streamId)
                 m_view->addEventMessage("info", QString("TCP目标: 摄像头%1 → IP[%2]").arg(cameraId).arg(boundIp));
             }
         }
-    }
+    }    
+    // 选中的视频块使用主码流，取消选中的切回子码流
+    updateDecodePolicies();
 }
 
-void Controller::onModelFrameReady(int streamId, const QImage& frame)
+void Controller::onModelFrameReady(int streamId, const FrameHandle& frame)
 {
+    // 更新指定流的视频帧
+    // View在updateVideoFrame内将像素拷贝到VideoLabel，函数返回后句柄释放，缓冲区自动归还帧池
+    // 实际绘制在帧时钟末尾的presentVideoFrames()中统一完成
+    if (!frame.isNull() && m_streamModels.contains(streamId)) {
+        QElapsedTimer renderTimer;
+        renderTimer.start();
+        m_view->updateVideoFrame(streamId, frame.image());
+        
+        // 记录显示帧数和渲染耗时（指数滑动平均）
+        StreamStatsState& state = m_streamStats[streamId];
+        double renderMs = renderTimer.nsecsElapsed() / 1000000.0;
+        state.renderTimeMs = (state.renderTimeMs <= 0.0) ? renderMs : state.renderTimeMs * 0.95 + renderMs * 0.05;
+        ++state.displayedFrames;
+    }
+}
 
-        // 如果存在此模型，则释放其挂起的帧计数，防止内存泄漏和卡顿
-    if (m_streamModels.contains(streamId)) {
-        Model* pModel = m_streamModels.value(streamId);
-        if (pModel) {
-            pModel->pendingFrames.fetchAndAddRelease(-1);
+// 统计时钟：每秒采样各路计数器，计算速率并刷新叠加显示
+void Controller::onStatsTick()
+{
+    for (auto it = m_streamModels.constBegin(); it != m_streamModels.constEnd(); ++it) {
+        StreamStatsState& state = m_streamStats[it.key()];
+        StreamCounters counters = it.value()->counters();
+        qint64 intervalMs = state.sampleTimer.isValid() ? state.sampleTimer.restart() : 0;
+        if (intervalMs > 0) {
+            state.stats = StreamStats::fromCounters(counters, state.lastCounters, intervalMs);
+            state.stats.displayFps = state.displayedFrames * 1000.0 / intervalMs;
+        } else {
+            state.sampleTimer.start(); // 首次采样只记录基准
+        }
+        state.stats.renderTimeMs = state.renderTimeMs;
+        state.stats.health = it.value()->health();
+        state.lastCounters = counters;
+        state.displayedFrames = 0;
+        
+        if (m_statsOverlayEnabled) {
+            m_view->setStreamStatsText(it.key(), state.stats.toDisplayText());
         }
     }
+    
+    // 截图队列已满时丢弃的报警图片（限速丢弃属于正常情况，只记录日志）
+    SnapshotWriter::Stats snapshotStats = m_snapshotWriter.stats();
+    if (snapshotStats.dropped > m_reportedSnapshotDrops) {
+        m_view->addEventMessage("warning", QString("截图队列已满，丢弃 %1 张（排队 %2，编码中 %3）")
+                                .arg(snapshotStats.dropped - m_reportedSnapshotDrops)
+                                .arg(snapshotStats.pending).arg(snapshotStats.running));
+        m_reportedSnapshotDrops = snapshotStats.dropped;
+    }
+    
+    // 长时间不在当前页的视频流关闭连接，减少网络和摄像头端的会话数
+    for (auto it = m_streamSources.begin(); it != m_streamSources.end(); ++it) {
+        if (!it->parked && it->hiddenTimer.isValid() && it->hiddenTimer.elapsed() >= ParkDelayMs) {
+            parkStream(it.key());
+        }
+    }
+}
 
+// 关闭视频流的连接：释放注册表中的引用（共享的解码器仍被其它画面使用时继续运行），
+// 视频块保留最后一帧，翻回当前页时重新打开
+void Controller::parkStream(int streamId)
+{
+    StreamSource& source = m_streamSources[streamId];
+    source.paused = m_streamRegistry.isSinkPaused(streamId);
+    source.parked = true;
+    m_streamModels.remove(streamId);
+    m_streamStats.remove(streamId);
+    m_streamRegistry.release(streamId);
+    qDebug() << "视频流" << streamId << "已隐藏" << ParkDelayMs / 1000 << "秒，关闭连接";
+}
 
-    // 更新指定流的视频帧
-    if (!frame.isNull()) {
-        m_view->updateVideoFrame(streamId, frame);
+// 重新打开已关闭连接的视频流（打开参数已按首帧时间优化，期间显示关闭前的最后一帧）
+void Controller::resumeParkedStream(int streamId, const QString& url)
+{
+    StreamSource& source = m_streamSources[streamId];
+    Model* model = m_streamRegistry.acquire(streamId, url,
+                                            m_cameraStore.loadOpenOptions(source.cameraId),
+                                            m_cameraStore.loadDecoderOptions(source.cameraId));
+    source.parked = false;
+    connectStreamSignals(streamId, model);
+    m_streamModels.insert(streamId, model);
+    if (source.paused) {
+        m_streamRegistry.setSinkPaused(streamId, true);
     }
+    qDebug() << "视频流" << streamId << "回到当前页，重新打开连接";
+}
+
+// 获取指定视频流的性能统计（每秒更新），流不存在时返回默认值
+StreamStats Controller::getStreamStats(int streamId) const
+{
+    return m_streamStats.value(streamId).stats;
+}
+
+// 获取所有视频流的性能统计
+QMap<int, StreamStats> Controller::getAllStreamStats() const
+{
+    QMap<int, StreamStats> result;
+    for (auto it = m_streamStats.constBegin(); it != m_streamStats.constEnd(); ++it) {
+        result.insert(it.key(), it.value().stats);
+    }
+    return result;
+}
+
+// 帧时钟：取出各路邮箱中的最新帧并刷新显示（界面卡顿期间的旧帧已被解码线程覆盖，不会堆积）
+void Controller::onFrameTick()
+{
+    // 每个共享解码器只取一次，分发给引用它的所有画面
+    m_streamRegistry.pollFrames([this](int sinkId, const FrameHandle& frame) {
+        if (sinkId == View::MainVideoStreamId) {
+            onFrameReady(frame);
+        } else if (sinkId > 0) {
+            onModelFrameReady(sinkId, frame); // 录像sink不显示画面
+        }
+    });
+    // 所有有新帧的视频块在一次重绘中完成，界面线程开销不随摄像头数量线性增长
+    m_view->presentVideoFrames();
+}
+
+// 视频流显示尺寸变化：通知对应Model按显示尺寸直接缩放输出，避免界面线程再次缩放
+void Controller::onStreamDisplaySizeChanged(int streamId, const QSize& size)
+{
+    // 共享解码器按各画面中最大的显示尺寸输出，较小的画面由View的缩放线程池缩放
+    m_streamRegistry.setSinkOutputSize(streamId, size);
+}
+
+// 按可见性和布局模式更新各路码流和解码策略：
+// • 9/16路时未选中的视频块切换到子码流并全部解码，全屏（1路）、4路或选中时切回主码流
+// • 没有子码流的摄像头：16路只解关键帧，9路隔帧输出，其余全部解码
+// • 隐藏的流（其它页）只保持连接不解码，也不切换码流；隐藏超过ParkDelayMs后关闭连接，翻回时重新打开
+void Controller::updateDecodePolicies()
+{
+    int layoutMode = m_view->getCurrentLayoutMode();
+    int selectedStreamId = m_view->getSelectedStreamId();
+    for (auto it = m_streamSources.begin(); it != m_streamSources.end(); ++it) {
+        int streamId = it.key();
+        StreamSource& source = it.value();
+        bool hasSub = !source.subUrl.isEmpty();
+        DecodePolicy policy = DecodePolicy::Full;
+        int interval = NineGridDecodeInterval;
+        if (!m_view->isStreamShown(streamId)) {
+            policy = DecodePolicy::DemuxOnly;
+            if (!source.hiddenTimer.isValid()) {
+                source.hiddenTimer.start();
+            }
+            if (source.parked) {
+                continue;
+            }
+        } else {
+            source.hiddenTimer.invalidate();
+            bool useSub = hasSub && layoutMode >= 9 && streamId != selectedStreamId;
+            QString url = useSub ? source.subUrl : source.mainUrl;
+            if (source.parked) {
+                resumeParkedStream(streamId, url);
+            } else {
+                // 新码流出首帧（解码总是从关键帧开始）后才替换旧码流，画面不中断
+                m_streamRegistry.switchSource(streamId, url,
+                                              m_cameraStore.loadOpenOptions(source.cameraId),
+                                              m_cameraStore.loadDecoderOptions(source.cameraId));
+            }
+            if (!hasSub && layoutMode >= 9) {
+                policy = DecodePolicy::EveryNth;
+                interval = layoutMode >= 16 ? SixteenGridDecodeInterval : NineGridDecodeInterval;
+            }
+        }
+        m_streamRegistry.setSinkDecodePolicy(streamId, policy, interval); // 共享解码器取各画面中要求最高的策略
+    }
+}
+
+// 修改视频流解码设置：运行时生效并保存到摄像头配置
+void Controller::onStreamDecoderSettingsRequested(int streamId)
+{
+    Model* model = m_streamModels.value(streamId, nullptr);
+    if (!model) {
+        return;
+    }
+    
+    int cameraId = m_view->getCameraIdForStream(streamId);
+    DecoderOptionsDialog dialog(cameraId, model->decoderOptions(), m_view);
+    int decodeTimeUs = model->averageDecodeTimeUs();
+    dialog.setDecodeTime(decodeTimeUs > 0 ? decodeTimeUs / 1000.0 : -1.0);
+    dialog.setLowDelay(model->openOptions().lowDelay);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+    
+    DecoderOptions options = dialog.getDecoderOptions();
+    model->setDecoderOptions(options);
+    m_cameraStore.saveDecoderOptions(cameraId, options);
+    m_view->addEventMessage("info", QString("摄像头 %1 解码设置已更新：线程数 %2").arg(cameraId)
+                            .arg(options.threadCount > 0 ? QString::number(options.threadCount) : QString("自动")));
 }
 
 // 暂停/恢复视频流
@@ -1277,15 +1763,13 @@ void Controller::onStreamPauseRequested(int streamId)
         return;
     }
     
-    Model* model = m_streamModels.value(streamId);
-    
-    // 切换暂停/恢复状态
-    if (model->isPaused()) {
-        model->resumeStream();
+    // 切换暂停/恢复状态（共享解码器时只暂停该画面，全部画面暂停时才暂停解码）
+    if (m_streamRegistry.isSinkPaused(streamId)) {
+        m_streamRegistry.setSinkPaused(streamId, false);
         qDebug() << "恢复视频流" << streamId;
         m_view->addEventMessage("success", QString("已恢复视频流 %1").arg(streamId));
     } else {
-        model->pauseStream();
+        m_streamRegistry.setSinkPaused(streamId, true);
         qDebug() << "暂停视频流" << streamId;
         m_view->addEventMessage("info", QString("已暂停视频流 %1").arg(streamId));
     }
@@ -1294,26 +1778,26 @@ void Controller::onStreamPauseRequested(int streamId)
 // 截图视频流
 void Controller::onStreamScreenshotRequested(int streamId)
 {
-    if (!m_streamModels.contains(streamId)) {
+    if (!m_streamSources.contains(streamId)) {
         qWarning() << "流" << streamId << "不存在";
         return;
     }
     
-    // 获取该流的VideoLabel
-    VideoLabel* label = m_view->getVideoLabelForStream(streamId);
-    if (!label || label->pixmap() == nullptr) {
-        m_view->addEventMessage("warning", "当前流没有可截图的画面");
-        QMessageBox::warning(m_view, "提示", "当前流没有可截图的画面！");
-        return;
-    }
-    
-    // 获取当前画面
-    QPixmap pixmap = *label->pixmap();
-    QImage image = pixmap.toImage();
-    
-    if (image.isNull()) {
-        m_view->addEventMessage("warning", "截图失败：图像为空");
-        return;
+    // 优先从源数据解码原始分辨率的画面（显示子码流时同样按主码流截图），不可用时使用视频块的当前画面
+    std::shared_ptr<PacketGop> source = sourceGopForStream(streamId);
+    QImage image;
+    if (!source) {
+        VideoLabel* label = m_view->getVideoLabelForStream(streamId);
+        if (!label || !label->hasFrame()) {
+            m_view->addEventMessage("warning", "当前流没有可截图的画面");
+            QMessageBox::warning(m_view, "提示", "当前流没有可截图的画面！");
+            return;
+        }
+        image = label->currentFrame();
+        if (image.isNull()) {
+            m_view->addEventMessage("warning", "截图失败：图像为空");
+            return;
+        }
     }
     
     // 获取摄像头ID和名称（通过view层获取）
@@ -1343,15 +1827,11 @@ void Controller::onStreamScreenshotRequested(int streamId)
                         .arg(timestamp);
     QString filepath = dir.filePath(filename);
     
-    // 保存图像
-    if (image.save(filepath, "JPEG", 95)) {
-        qDebug() << "截图成功:" << filepath;
-        m_view->addEventMessage("success", QString("截图成功: %1").arg(filename));
-        QMessageBox::information(m_view, "截图成功", "图片已保存到: " + filepath);
-    } else {
-        qDebug() << "截图失败:" << filepath;
-        m_view->addEventMessage("error", "图片保存失败！");
-        QMessageBox::critical(m_view, "保存失败", "图片保存失败！");
+    // 交给截图写入线程保存（视频块的帧隐式共享，写入下一帧时自动分离），结果在onSnapshotSaved中提示
+    bool accepted = source ? m_snapshotWriter.submit(source, filepath, 95)
+                           : m_snapshotWriter.submit(image, filepath, 95);
+    if (!accepted) {
+        m_view->addEventMessage("warning", "截图队列已满，请稍后再试");
     }
 }
 
@@ -1367,14 +1847,17 @@ void Controller::onAddCameraWithIdRequested(int cameraId)
     
     // 创建固定摄像头ID的对话框（ID不可修改）
     AddCameraDialog dialog(cameraId, m_view);
+    dialog.setOpenOptions(m_cameraStore.loadOpenOptions(cameraId)); // 预填已保存的连接参数
+    dialog.setSubRtspUrl(m_cameraStore.loadSubRtspUrl(cameraId));
     
     if (dialog.exec() == QDialog::Accepted) {
         // 获取用户输入的信息
         QString url = dialog.getRtspUrl();
         QString name = dialog.getCameraName();
+        m_cameraStore.saveOpenOptions(cameraId, dialog.getOpenOptions());
         
         // 添加视频流
-        addVideoStream(url, name, cameraId);
+        addVideoStream(url, name, cameraId, dialog.getSubRtspUrl());
         
         m_view->addEventMessage("success", QString("正在添加摄像头 %1: %2").arg(cameraId).arg(name));
         
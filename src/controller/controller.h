@@ -1,12 +1,18 @@
 #pragma once
 #include <QObject>
 #include <QMap>
+#include <QTimer>
+#include <QElapsedTimer>
 #include "model.h"
 #include "view.h"
 #include "Picture.h"
 #include "Tcpserver.h"
 #include "VideoLabel.h"  // 包含RectangleBox定义
 #include "detectlist.h"  // 包含DetectList类
+#include "CameraConfigStore.h" // 摄像头配置存储
+#include "StreamRegistry.h"    // 共享解码器注册表
+#include "SegmentRecorder.h"   // 连续录像
+#include "SnapshotWriter.h"    // 异步截图写入
 
 class Plan; // 前向声明
 
@@ -23,9 +29,14 @@ public:
     void setTcpServer(Tcpserver* tcpServer);
     
     // 多路视频流管理
-    void addVideoStream(const QString& url, const QString& name, int cameraId);
+    // subUrl为子码流地址（可选），多画面布局时自动切换到子码流
+    void addVideoStream(const QString& url, const QString& name, int cameraId, const QString& subUrl = QString());
     void removeVideoStream(int streamId);
     void clearAllStreams();
+    
+    // 性能统计查询（每秒更新）
+    StreamStats getStreamStats(int streamId) const;
+    QMap<int, StreamStats> getAllStreamStats() const;
 
 public slots:
     void ButtonClickedHandler();      //主界面标签按键槽
@@ -36,29 +47,60 @@ public slots:
         
 private slots:
     void onAddCameraClicked();      //添加摄像头槽
-    void onFrameReady(const QImage& img); //视频帧槽
+    void onFrameReady(const FrameHandle& frame); //视频帧槽
+    void onFrameTick();                          //帧时钟槽（轮询各路最新帧）
+    void onStatsTick();                          //统计时钟槽（每秒采样性能计数器）
     void onDetectListSelectionChanged(const QSet<int>& selectedIds); //对象列表选择变化槽 
     void onRectangleConfirmed(const RectangleBox& rect);// 处理用户确认的矩形框（绝对坐标），用于目标选定等功能
     // 处理用户确认的矩形框（归一化坐标和绝对坐标），便于后续处理如检测、标注等
     void onNormalizedRectangleConfirmed(const NormalizedRectangleBox& normRect, const RectangleBox& absRect);
     void onPlanApplied(const PlanData& plan); // 处理方案应用槽
+    void onDetectionsReceived(const QVector<DetectionEvent>& events); // 一批检测消息（按摄像头合并后处理）
     void onDetectionDataReceived(int cameraId, const QString& detectionData); // 新增：处理检测数据接收槽（含摄像头ID）
     
     // 多路视频流槽函数
     void onLayoutModeChanged(int mode);     // 布局模式切换
     void onStreamSelected(int streamId);    // 视频流选择
-    void onModelFrameReady(int streamId, const QImage& frame); // 多路视频帧更新
+    void onModelFrameReady(int streamId, const FrameHandle& frame); // 多路视频帧更新（池化帧句柄，界面使用完毕后自动归还）
     void onStreamPauseRequested(int streamId);     // 暂停视频流
     void onStreamScreenshotRequested(int streamId); // 截图视频流
     void onAddCameraWithIdRequested(int cameraId); // 添加指定ID的摄像头
+    void onStreamDisplaySizeChanged(int streamId, const QSize& size); // 视频流显示尺寸变化
+    void updateDecodePolicies();                   // 按可见性和布局模式更新各路解码策略
+    // 没有子码流的可见视频块按间隔输出：9宫格每2帧一帧，16宫格及以上每4帧一帧（保持连续画面，不退化为只显示关键帧）
+    static const int NineGridDecodeInterval = 2;
+    static const int SixteenGridDecodeInterval = 4;
+    void onStreamDecoderSettingsRequested(int streamId); // 修改视频流解码设置
+    void onSinkModelChanged(int sinkId, Model* model);   // 视频流完成主/子码流切换
+    void onStreamRecordRequested(int streamId);          // 开始/停止视频流的连续录像
+    void onSnapshotSaved(const QString& fileName, bool success, const QString& key); // 截图写入完成
 
 private:
     Model* m_model; //模型指针  
     View* m_view;   //视图指针
     bool m_paused = false; //暂停标志
-    QImage m_lastImage; // 保存最近一帧图像
+    FrameHandle m_lastFrame; // 保存最近一帧图像（持有池化帧句柄，保证截图时缓冲区不被覆盖）
     void saveImage();   // 截图保存函数
     void saveAlarmImage(int cameraId, const QString& detectionInfo); // 新增：报警图像保存函数（含摄像头ID）
+    void saveAlarmClip(int cameraId); // 保存报警片段（预录 + 后录，直接封装为MP4）
+    SnapshotWriter m_snapshotWriter;  // 截图和报警图片在编码线程池中保存，不阻塞界面
+    // 截图和报警片段的源数据所在的Model（主画面取其共享的解码器），没有时返回nullptr
+    Model* sourceModelForStream(int streamId) const;
+    // 截图的源数据（最近一组GOP，原始分辨率），不可用时返回空
+    std::shared_ptr<PacketGop> sourceGopForStream(int streamId) const;
+    // 报警图片和报警片段共用的源数据：cameraId>0时取该摄像头的视频流（未添加时返回nullptr），否则取主画面
+    Model* alarmSourceModel(int cameraId) const;
+    quint64 m_reportedSnapshotDrops = 0; // 已提示过的截图丢弃数
+    static const int AlarmSnapshotIntervalMs = 1000; // 每路摄像头报警图片的最小保存间隔
+    QSet<int> m_recordingAlarmClips;  // 正在录制报警片段的摄像头（录制期间的重复报警不再新建片段）
+    static const int AlarmPostRollMs = 10000; // 报警片段的后录时长
+    
+    // 连续录像：以独立的sink引用主码流（只解复用），不受画面切换子码流、暂停或关闭连接的影响
+    bool startRecording(int cameraId);
+    void stopRecording(int cameraId);
+    static const int RecordSinkBase = -1000;  // 录像sink的ID为RecordSinkBase - 摄像头位置，不与视频块和主画面冲突
+    static int recordSinkId(int cameraId) { return RecordSinkBase - cameraId; }
+    QMap<int, SegmentRecorder*> m_recorders;  // 摄像头位置 -> 连续录像
     Tcpserver* tcpWin = nullptr; // TCP服务器窗口指针
     DetectList* m_detectList = nullptr; // 对象检测列表窗口指针
     Plan* m_plan = nullptr; // 方案预选窗口指针
@@ -68,7 +110,43 @@ private:
     // 功能按钮状态管理
     void updateButtonDependencies(int clickedButtonId, bool isChecked);
     
+    // 启动主画面视频流（与视频块共享相同地址的解码器）
+    void startMainStream(const QString& url);
+    // 连接视频块的Model信号（以注册表的sink上下文为接收者）
+    void connectStreamSignals(int streamId, Model* model);
+    // 关闭长时间不在当前页的视频流（释放RTSP会话），翻回时重新打开
+    void parkStream(int streamId);
+    void resumeParkedStream(int streamId, const QString& url);
+    static const int ParkDelayMs = 30000; // 视频流隐藏超过该时间后关闭连接
+    
+    // 视频块的码流地址
+    struct StreamSource {
+        QString mainUrl;               // 主码流地址
+        QString subUrl;                // 子码流地址（为空表示无子码流）
+        int cameraId = 0;
+        QString name;
+        QElapsedTimer hiddenTimer;     // 隐藏计时（显示时无效）
+        bool parked = false;           // 连接已关闭，等待翻回当前页时重新打开
+        bool paused = false;           // 关闭连接前的暂停状态（重新打开后恢复）
+    };
+    QMap<int, StreamSource> m_streamSources; // streamId -> 码流地址
+    
     // 多路视频流管理
-    QMap<int, Model*> m_streamModels;  // streamId -> Model映射
+    QMap<int, Model*> m_streamModels;  // streamId -> Model映射（相同地址的视频流共享同一Model）
+    StreamRegistry m_streamRegistry;   // 共享解码器注册表（管理Model生命周期，主画面以MainVideoStreamId引用）
     int m_nextStreamId;                // 下一个可用的流ID
+    CameraConfigStore m_cameraStore;   // 摄像头配置存储（解码器配置等）
+    QTimer* m_frameTimer = nullptr;    // 帧时钟（按屏幕刷新率轮询最新帧）
+    
+    // 每路视频流的性能统计状态
+    struct StreamStatsState {
+        StreamCounters lastCounters;   // 上次采样的计数器
+        QElapsedTimer sampleTimer;     // 采样间隔计时
+        int displayedFrames = 0;       // 本采样周期内显示的帧数
+        double renderTimeMs = 0.0;     // 平均渲染耗时
+        StreamStats stats;             // 最近一次计算的统计结果
+    };
+    QMap<int, StreamStatsState> m_streamStats; // streamId -> 性能统计状态
+    QTimer* m_statsTimer = nullptr;    // 统计时钟
+    bool m_statsOverlayEnabled = false; // 性能统计叠加显示开关
 };
@@ -0,0 +1,127 @@
+#include "AlarmClipWriter.h"
+#include <QRunnable>
+#include <QThreadPool>
+#include <QDebug>
+
+// 片段封装任务：封装完成后发出信号并删除片段对象
+class AlarmClipMuxJob : public QRunnable {
+public:
+    explicit AlarmClipMuxJob(AlarmClipWriter* writer) : m_writer(writer) { setAutoDelete(true); }
+
+    void run() override
+    {
+        qint64 durationMs = 0;
+        bool success = m_writer->mux(&durationMs);
+        emit m_writer->finished(m_writer->fileName(), success, durationMs);
+        m_writer->deleteLater(); // 在片段对象所在线程中删除，排在finished信号之后
+    }
+
+private:
+    AlarmClipWriter* m_writer;
+};
+
+AlarmClipWriter::AlarmClipWriter(const QString& fileName, int postRollMs, QObject* parent)
+    : QObject(parent), m_fileName(fileName), m_postRollMs(postRollMs),
+      m_codecpar(avcodec_parameters_alloc()), m_timeBase{1, 90000}, m_finished(false)
+{
+}
+
+AlarmClipWriter::~AlarmClipWriter()
+{
+    for (AVPacket*& packet : m_packets) {
+        av_packet_free(&packet);
+    }
+    avcodec_parameters_free(&m_codecpar);
+}
+
+bool AlarmClipWriter::start(PacketRingBuffer& buffer)
+{
+    if (!m_codecpar) {
+        return false;
+    }
+    m_postRollTimer.start();
+    // 预录数据的复制和挂上接收端在缓冲锁内完成，之后解复用线程才会回调writePacket
+    return buffer.attach(this, m_packets, m_codecpar, &m_timeBase);
+}
+
+bool AlarmClipWriter::writePacket(const AVPacket* packet)
+{
+    QMutexLocker locker(&m_mutex);
+    AVPacket* copy = av_packet_clone(packet);
+    if (copy) {
+        m_packets.append(copy);
+    }
+    if (m_postRollTimer.elapsed() < m_postRollMs) {
+        return true;
+    }
+    locker.unlock();
+    finish();
+    return false;
+}
+
+void AlarmClipWriter::streamEnded()
+{
+    finish(); // 视频流中断时保存已收到的部分
+}
+
+void AlarmClipWriter::finish()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_finished) {
+            return;
+        }
+        m_finished = true;
+    }
+    QThreadPool::globalInstance()->start(new AlarmClipMuxJob(this));
+}
+
+bool AlarmClipWriter::mux(qint64* durationMs)
+{
+    // 数据收集已结束，不再有其它线程访问数据包列表
+    if (m_packets.isEmpty()) {
+        return false;
+    }
+
+    AVFormatContext* outCtx = nullptr;
+    QByteArray path = m_fileName.toUtf8();
+    if (avformat_alloc_output_context2(&outCtx, nullptr, "mp4", path.constData()) < 0 || !outCtx) {
+        qDebug() << "报警片段：无法创建MP4封装" << m_fileName;
+        return false;
+    }
+    AVStream* outStream = avformat_new_stream(outCtx, nullptr);
+    bool ok = outStream && avcodec_parameters_copy(outStream->codecpar, m_codecpar) >= 0;
+    if (ok) {
+        outStream->codecpar->codec_tag = 0; // 由MP4封装选择合适的标签
+        outStream->time_base = m_timeBase;
+        ok = avio_open(&outCtx->pb, path.constData(), AVIO_FLAG_WRITE) >= 0;
+    }
+    if (ok) {
+        AVDictionary* options = nullptr;
+        av_dict_set(&options, "movflags", "+faststart", 0); // 索引放在文件头，便于直接预览
+        ok = avformat_write_header(outCtx, &options) >= 0;
+        av_dict_free(&options);
+    }
+
+    // 时间戳以第一个数据包（关键帧）为零点
+    PacketTimeline timeline;
+    for (int i = 0; ok && i < m_packets.size(); ++i) {
+        AVPacket* packet = m_packets[i];
+        timeline.rebase(packet);
+        packet->stream_index = 0;
+        packet->pos = -1;
+        av_packet_rescale_ts(packet, m_timeBase, outStream->time_base);
+        ok = av_write_frame(outCtx, packet) >= 0;
+    }
+    if (ok) {
+        ok = av_write_trailer(outCtx) >= 0;
+    }
+    avio_closep(&outCtx->pb);
+    avformat_free_context(outCtx);
+
+    *durationMs = av_rescale_q(timeline.durationTs(), m_timeBase, AVRational{1, 1000});
+    if (!ok) {
+        qDebug() << "报警片段封装失败" << m_fileName;
+    }
+    return ok;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include "PacketRingBuffer.h"
+
+// 报警片段：预录缓冲中的数据包加上报警后一段时间的数据包，不重新编码直接封装为MP4
+// • start()从预录缓冲复制已有数据并挂为接收端，后录时长到达或视频流结束后自动摘除
+// • 封装在全局线程池中执行，完成后发出finished信号并自行删除（在创建它的线程中）
+class AlarmClipWriter : public QObject, public PacketSink {
+    Q_OBJECT
+
+public:
+    AlarmClipWriter(const QString& fileName, int postRollMs, QObject* parent = nullptr);
+    ~AlarmClipWriter();
+
+    // 开始录制片段，预录缓冲中还没有可用数据时返回false（调用方负责删除）
+    bool start(PacketRingBuffer& buffer);
+    QString fileName() const { return m_fileName; }
+
+    bool writePacket(const AVPacket* packet) override;
+    void streamEnded() override;
+
+signals:
+    // 封装完成，durationMs为片段时长（按时间戳计算）
+    void finished(const QString& fileName, bool success, qint64 durationMs);
+
+private:
+    friend class AlarmClipMuxJob;
+    void finish();                 // 数据收集结束，提交封装任务（只执行一次）
+    bool mux(qint64* durationMs);  // 将收集的数据包封装为MP4（线程池中执行）
+
+    QString m_fileName;
+    int m_postRollMs;
+    QElapsedTimer m_postRollTimer;     // 后录计时（挂上接收端时开始）
+    QMutex m_mutex;                    // 保护数据包列表和完成标志
+    QList<AVPacket*> m_packets;        // 预录 + 后录的数据包
+    AVCodecParameters* m_codecpar;     // 视频流参数
+    AVRational m_timeBase;             // 数据包时间基
+    bool m_finished;
+};
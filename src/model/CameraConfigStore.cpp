@@ -0,0 +1,254 @@
+#include "CameraConfigStore.h"
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlError>
+#include <QStandardPaths>
+#include <QDir>
+#include <QDebug>
+
+CameraConfigStore::CameraConfigStore()
+{
+}
+
+CameraConfigStore::~CameraConfigStore()
+{
+    if (m_database.isOpen())
+        m_database.close();
+}
+
+bool CameraConfigStore::open()
+{
+    if (m_database.isOpen())
+        return true;
+
+    // 与方案数据库放在同一应用数据目录
+    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dataDir);
+    QString dbPath = dataDir + "/cameras.db";
+
+    // 使用命名连接"CameraDB"避免与其他数据库连接冲突
+    m_database = QSqlDatabase::addDatabase("QSQLITE", "CameraDB");
+    m_database.setDatabaseName(dbPath);
+    if (!m_database.open()) {
+        qWarning() << "无法打开摄像头配置数据库:" << m_database.lastError().text();
+        return false;
+    }
+    return createCameraTable();
+}
+
+bool CameraConfigStore::createCameraTable()
+{
+    QSqlQuery query(m_database);
+    QString createTableSql = R"(
+        CREATE TABLE IF NOT EXISTS cameras (
+            camera_id INTEGER PRIMARY KEY,
+            name TEXT DEFAULT '',
+            rtsp_url TEXT DEFAULT '',
+            updated_time DATETIME DEFAULT CURRENT_TIMESTAMP
+        )
+    )";
+    if (!query.exec(createTableSql)) {
+        qWarning() << "创建摄像头配置表失败:" << query.lastError().text();
+        return false;
+    }
+
+    // 解码器配置字段（旧版本数据库自动补充）
+    return ensureColumn("thread_count", "INTEGER DEFAULT 0")
+           && ensureColumn("thread_type", "INTEGER DEFAULT 0")
+           && ensureColumn("skip_loop_filter", "INTEGER DEFAULT 0")
+           && ensureColumn("lowres", "INTEGER DEFAULT 0")
+           // RTSP打开参数字段
+           && ensureColumn("rtsp_transport", "TEXT DEFAULT 'tcp'")
+           && ensureColumn("probe_size", "INTEGER DEFAULT 500000")
+           && ensureColumn("analyze_duration_ms", "INTEGER DEFAULT 500")
+           && ensureColumn("no_buffer", "INTEGER DEFAULT 1")
+           && ensureColumn("low_delay", "INTEGER DEFAULT 1")
+           && ensureColumn("max_delay_ms", "INTEGER DEFAULT 500")
+           && ensureColumn("reorder_queue_size", "INTEGER DEFAULT -1")
+           && ensureColumn("timeout_ms", "INTEGER DEFAULT 5000")
+           // 子码流地址（多画面时使用的低分辨率码流）
+           && ensureColumn("sub_rtsp_url", "TEXT DEFAULT ''")
+           // 连续录像开关
+           && ensureColumn("record_enabled", "INTEGER DEFAULT 0");
+}
+
+bool CameraConfigStore::ensureColumn(const QString& column, const QString& definition)
+{
+    QSqlQuery query(m_database);
+    query.exec("PRAGMA table_info(cameras)");
+    while (query.next()) {
+        if (query.value(1).toString() == column)
+            return true; // 字段已存在
+    }
+    if (!query.exec(QString("ALTER TABLE cameras ADD COLUMN %1 %2").arg(column, definition))) {
+        qWarning() << "升级摄像头配置表失败:" << column << query.lastError().text();
+        return false;
+    }
+    qDebug() << "摄像头配置表已添加字段:" << column;
+    return true;
+}
+
+bool CameraConfigStore::ensureCameraRow(int cameraId)
+{
+    QSqlQuery query(m_database);
+    query.prepare("INSERT OR IGNORE INTO cameras (camera_id) VALUES (?)");
+    query.addBindValue(cameraId);
+    return query.exec();
+}
+
+bool CameraConfigStore::saveCamera(int cameraId, const QString& name, const QString& rtspUrl,
+                                   const QString& subRtspUrl)
+{
+    if (!m_database.isOpen() || !ensureCameraRow(cameraId))
+        return false;
+
+    QSqlQuery query(m_database);
+    query.prepare(R"(
+        UPDATE cameras SET name = ?, rtsp_url = ?, sub_rtsp_url = ?, updated_time = CURRENT_TIMESTAMP
+        WHERE camera_id = ?
+    )");
+    query.addBindValue(name);
+    query.addBindValue(rtspUrl);
+    query.addBindValue(subRtspUrl);
+    query.addBindValue(cameraId);
+    if (!query.exec()) {
+        qWarning() << "保存摄像头信息失败:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool CameraConfigStore::loadRecordEnabled(int cameraId) const
+{
+    if (!m_database.isOpen())
+        return false;
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT record_enabled FROM cameras WHERE camera_id = ?");
+    query.addBindValue(cameraId);
+    return query.exec() && query.next() && query.value(0).toBool();
+}
+
+bool CameraConfigStore::saveRecordEnabled(int cameraId, bool enabled)
+{
+    if (!m_database.isOpen() || !ensureCameraRow(cameraId))
+        return false;
+
+    QSqlQuery query(m_database);
+    query.prepare("UPDATE cameras SET record_enabled = ?, updated_time = CURRENT_TIMESTAMP WHERE camera_id = ?");
+    query.addBindValue(enabled ? 1 : 0);
+    query.addBindValue(cameraId);
+    if (!query.exec()) {
+        qWarning() << "保存录像开关失败:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+QString CameraConfigStore::loadSubRtspUrl(int cameraId) const
+{
+    if (!m_database.isOpen())
+        return QString();
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT sub_rtsp_url FROM cameras WHERE camera_id = ?");
+    query.addBindValue(cameraId);
+    if (query.exec() && query.next())
+        return query.value(0).toString();
+    return QString();
+}
+
+DecoderOptions CameraConfigStore::loadDecoderOptions(int cameraId) const
+{
+    DecoderOptions options;
+    if (!m_database.isOpen())
+        return options;
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT thread_count, thread_type, skip_loop_filter, lowres FROM cameras WHERE camera_id = ?");
+    query.addBindValue(cameraId);
+    if (query.exec() && query.next()) {
+        options.threadCount = query.value(0).toInt();
+        options.threadType = query.value(1).toInt() == static_cast<int>(DecoderThreadType::Slice)
+                             ? DecoderThreadType::Slice : DecoderThreadType::Frame;
+        options.skipLoopFilter = query.value(2).toBool();
+        options.lowres = query.value(3).toInt();
+    }
+    return options;
+}
+
+bool CameraConfigStore::saveDecoderOptions(int cameraId, const DecoderOptions& options)
+{
+    if (!m_database.isOpen() || !ensureCameraRow(cameraId))
+        return false;
+
+    QSqlQuery query(m_database);
+    query.prepare(R"(
+        UPDATE cameras SET thread_count = ?, thread_type = ?, skip_loop_filter = ?, lowres = ?,
+                           updated_time = CURRENT_TIMESTAMP
+        WHERE camera_id = ?
+    )");
+    query.addBindValue(options.threadCount);
+    query.addBindValue(static_cast<int>(options.threadType));
+    query.addBindValue(options.skipLoopFilter ? 1 : 0);
+    query.addBindValue(options.lowres);
+    query.addBindValue(cameraId);
+    if (!query.exec()) {
+        qWarning() << "保存解码器配置失败:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+OpenOptions CameraConfigStore::loadOpenOptions(int cameraId) const
+{
+    OpenOptions options;
+    if (!m_database.isOpen())
+        return options;
+
+    QSqlQuery query(m_database);
+    query.prepare(R"(
+        SELECT rtsp_transport, probe_size, analyze_duration_ms, no_buffer, low_delay,
+               max_delay_ms, reorder_queue_size, timeout_ms
+        FROM cameras WHERE camera_id = ?
+    )");
+    query.addBindValue(cameraId);
+    if (query.exec() && query.next()) {
+        options.rtspTransport = query.value(0).toString() == "udp" ? QString("udp") : QString("tcp");
+        options.probeSize = query.value(1).toInt();
+        options.analyzeDurationMs = query.value(2).toInt();
+        options.noBuffer = query.value(3).toBool();
+        options.lowDelay = query.value(4).toBool();
+        options.maxDelayMs = query.value(5).toInt();
+        options.reorderQueueSize = query.value(6).toInt();
+        options.timeoutMs = query.value(7).toInt();
+    }
+    return options;
+}
+
+bool CameraConfigStore::saveOpenOptions(int cameraId, const OpenOptions& options)
+{
+    if (!m_database.isOpen() || !ensureCameraRow(cameraId))
+        return false;
+
+    QSqlQuery query(m_database);
+    query.prepare(R"(
+        UPDATE cameras SET rtsp_transport = ?, probe_size = ?, analyze_duration_ms = ?, no_buffer = ?,
+                           low_delay = ?, max_delay_ms = ?, reorder_queue_size = ?, timeout_ms = ?,
+                           updated_time = CURRENT_TIMESTAMP
+        WHERE camera_id = ?
+    )");
+    query.addBindValue(options.rtspTransport);
+    query.addBindValue(options.probeSize);
+    query.addBindValue(options.analyzeDurationMs);
+    query.addBindValue(options.noBuffer ? 1 : 0);
+    query.addBindValue(options.lowDelay ? 1 : 0);
+    query.addBindValue(options.maxDelayMs);
+    query.addBindValue(options.reorderQueueSize);
+    query.addBindValue(options.timeoutMs);
+    query.addBindValue(cameraId);
+    if (!query.exec()) {
+        qWarning() << "保存RTSP打开参数失败:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
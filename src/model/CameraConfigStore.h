@@ -0,0 +1,40 @@
+#pragma once
+#include <QString>
+#include <QtSql/QSqlDatabase>
+#include "StreamConfig.h"
+
+// 摄像头配置存储：按摄像头位置（camera_id）持久化每路摄像头的配置
+// 数据保存在应用数据目录下的cameras.db中，仅在界面线程中使用
+class CameraConfigStore {
+public:
+    CameraConfigStore();
+    ~CameraConfigStore();
+
+    bool open();                                    // 打开数据库并创建/升级数据表
+    bool isOpen() const { return m_database.isOpen(); }
+
+    // 保存摄像头基本信息（名称、主码流地址、子码流地址），已存在时更新
+    bool saveCamera(int cameraId, const QString& name, const QString& rtspUrl,
+                    const QString& subRtspUrl = QString());
+    // 读取子码流地址（未配置时返回空字符串）
+    QString loadSubRtspUrl(int cameraId) const;
+    // 读取/保存解码器配置（未保存过的摄像头返回默认配置）
+    DecoderOptions loadDecoderOptions(int cameraId) const;
+    bool saveDecoderOptions(int cameraId, const DecoderOptions& options);
+    // 读取/保存RTSP打开参数（未保存过的摄像头返回默认参数）
+    OpenOptions loadOpenOptions(int cameraId) const;
+    bool saveOpenOptions(int cameraId, const OpenOptions& options);
+    // 读取/保存是否连续录像（重新添加摄像头或重启后自动恢复录像）
+    bool loadRecordEnabled(int cameraId) const;
+    bool saveRecordEnabled(int cameraId, bool enabled);
+
+private:
+    bool createCameraTable();                       // 创建摄像头数据表
+    bool ensureColumn(const QString& column, const QString& definition); // 旧表缺少字段时补充
+    bool ensureCameraRow(int cameraId);             // 确保摄像头记录存在
+
+    QSqlDatabase m_database;
+
+    CameraConfigStore(const CameraConfigStore&) = delete;
+    CameraConfigStore& operator=(const CameraConfigStore&) = delete;
+};
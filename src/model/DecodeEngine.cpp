@@ -0,0 +1,146 @@
+#include "DecodeEngine.h"
+#include <QThread>
+
+// 解码工作线程：只运行解码引擎的调度循环
+class DecodeWorker : public QThread {
+public:
+    DecodeWorker(DecodeEngine* engine, int index) : m_engine(engine), m_index(index) {}
+
+protected:
+    void run() override { m_engine->workerLoop(m_index); }
+
+private:
+    DecodeEngine* m_engine;
+    int m_index;
+};
+
+DecodeEngine& DecodeEngine::instance()
+{
+    static DecodeEngine engine;
+    return engine;
+}
+
+DecodeEngine::DecodeEngine()
+    : m_nextWorker(0), m_stolenCount(0), m_shutdown(false)
+{
+    // 工作线程数与CPU核数一致，解码器内部不再各自创建线程
+    int count = qMax(2, QThread::idealThreadCount());
+    m_queues.resize(count);
+    for (int i = 0; i < count; ++i) {
+        DecodeWorker* worker = new DecodeWorker(this, i);
+        worker->setObjectName(QString("DecodeWorker%1").arg(i));
+        m_workers.append(worker);
+        worker->start();
+    }
+}
+
+DecodeEngine::~DecodeEngine()
+{
+    m_mutex.lock();
+    m_shutdown = true;
+    m_workAvailable.wakeAll();
+    m_mutex.unlock();
+    for (QThread* worker : m_workers) {
+        worker->wait();
+        delete worker;
+    }
+}
+
+void DecodeEngine::schedule(DecodeJob* job)
+{
+    QMutexLocker locker(&m_mutex);
+    JobState& state = m_jobs[job];
+    if (state.running) {
+        state.rerun = true; // 当前切片结束后由工作线程重新入队
+        return;
+    }
+    if (state.queued) {
+        return;
+    }
+    if (state.worker < 0) {
+        state.worker = m_nextWorker;
+        m_nextWorker = (m_nextWorker + 1) % m_queues.size();
+    }
+    m_queues[state.worker].append(job);
+    state.queued = true;
+    m_workAvailable.wakeOne(); // 任一空闲线程都可以取走（必要时窃取）
+}
+
+void DecodeEngine::cancel(DecodeJob* job)
+{
+    QMutexLocker locker(&m_mutex);
+    while (m_jobs.contains(job) && m_jobs[job].running) {
+        m_jobFinished.wait(&m_mutex);
+    }
+    auto it = m_jobs.find(job);
+    if (it == m_jobs.end()) {
+        return;
+    }
+    if (it->queued) {
+        m_queues[it->worker].removeOne(job);
+    }
+    m_jobs.erase(it);
+}
+
+quint64 DecodeEngine::stolenCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stolenCount;
+}
+
+DecodeJob* DecodeEngine::takeJob(int index)
+{
+    QList<DecodeJob*>& own = m_queues[index];
+    if (!own.isEmpty()) {
+        return own.takeFirst();
+    }
+
+    // 自己的队列为空：从积压最多的队列尾部窃取（队首留给该线程，保持其缓存局部性）
+    int victim = -1;
+    for (int i = 0; i < m_queues.size(); ++i) {
+        if (i != index && !m_queues[i].isEmpty()
+            && (victim < 0 || m_queues[i].size() > m_queues[victim].size())) {
+            victim = i;
+        }
+    }
+    if (victim < 0) {
+        return nullptr;
+    }
+    ++m_stolenCount;
+    return m_queues[victim].takeLast();
+}
+
+void DecodeEngine::workerLoop(int index)
+{
+    QMutexLocker locker(&m_mutex);
+    while (!m_shutdown) {
+        DecodeJob* job = takeJob(index);
+        if (!job) {
+            m_workAvailable.wait(&m_mutex);
+            continue;
+        }
+
+        JobState& state = m_jobs[job];
+        state.queued = false;
+        state.running = true;
+        state.rerun = false;
+        state.worker = index; // 被窃取的任务此后留在本线程
+        locker.unlock();
+
+        bool more = job->runDecodeSlice();
+
+        locker.relock();
+        // 执行期间cancel()只会等待，不会移除任务，状态一定存在
+        JobState& finished = m_jobs[job];
+        finished.running = false;
+        if (more || finished.rerun) {
+            finished.rerun = false;
+            finished.queued = true;
+            m_queues[index].append(job); // 回到队尾，让其它视频流先解码
+            if (m_queues[index].size() > 1) {
+                m_workAvailable.wakeOne(); // 本线程有积压，唤醒空闲线程来窃取
+            }
+        }
+        m_jobFinished.wakeAll();
+    }
+}
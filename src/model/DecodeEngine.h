@@ -0,0 +1,62 @@
+#pragma once
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+
+class QThread;
+
+// 解码任务：由解码引擎的工作线程执行，同一任务同一时刻只在一个工作线程上运行
+class DecodeJob {
+public:
+    virtual ~DecodeJob() {}
+    // 处理一段待解码数据（有上限，保证各路轮流执行），返回是否还有剩余数据
+    virtual bool runDecodeSlice() = 0;
+};
+
+// 解码引擎：所有视频流共享的固定数量解码工作线程（按CPU核数），取代每路一个解码线程
+// • 每个工作线程有自己的任务队列，任务优先回到上次执行它的线程（解码器状态留在该核的缓存中）
+// • 工作线程自己的队列为空时从最长的队列尾部窃取任务，避免个别线程积压
+// • 任务执行期间再次收到数据只做标记，执行完后回到队尾，各路轮流解码
+class DecodeEngine {
+public:
+    static DecodeEngine& instance();
+
+    int workerCount() const { return m_workers.size(); }
+    // 任务有新数据时调用，任务未在队列中时加入队列并唤醒工作线程
+    void schedule(DecodeJob* job);
+    // 将任务移出队列并等待正在执行的切片结束，返回后工作线程不会再访问该任务
+    void cancel(DecodeJob* job);
+    // 累计窃取次数（用于性能统计）
+    quint64 stolenCount() const;
+
+private:
+    DecodeEngine();
+    ~DecodeEngine();
+
+    friend class DecodeWorker;
+    void workerLoop(int index);               // 工作线程主循环
+    DecodeJob* takeJob(int index);            // 取出任务：先取自己的队首，否则窃取其它队列的队尾（需持有m_mutex）
+
+    // 任务的调度状态
+    struct JobState {
+        int worker = -1;           // 所在（或上次执行）的工作线程
+        bool queued = false;       // 是否在队列中
+        bool running = false;      // 是否正在执行
+        bool rerun = false;        // 执行期间收到新数据，结束后重新入队
+    };
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_workAvailable;           // 有任务入队
+    QWaitCondition m_jobFinished;             // 有任务切片执行结束
+    QVector<QList<DecodeJob*>> m_queues;      // 每个工作线程的任务队列
+    QHash<DecodeJob*, JobState> m_jobs;       // 已调度任务的状态
+    QList<QThread*> m_workers;                // 工作线程
+    int m_nextWorker;                         // 新任务轮流分配的工作线程
+    quint64 m_stolenCount;                    // 累计窃取次数
+    bool m_shutdown;
+
+    DecodeEngine(const DecodeEngine&) = delete;
+    DecodeEngine& operator=(const DecodeEngine&) = delete;
+};
@@ -0,0 +1,37 @@
+#include "FrameMailbox.h"
+
+FrameMailbox::FrameMailbox()
+    : m_state(1), m_producerIndex(0), m_consumerIndex(2)
+{
+}
+
+bool FrameMailbox::publish(const FrameHandle& frame)
+{
+    // 写入生产者槽后与中间槽交换，并标记有新帧
+    m_slots[m_producerIndex] = frame;
+    int oldState = m_state.fetchAndStoreOrdered(m_producerIndex | NewFrameFlag);
+    m_producerIndex = oldState & IndexMask;
+    // 换回的槽中可能是未被取走的旧帧，立即释放使其归还帧池
+    bool overwritten = (oldState & NewFrameFlag) && !m_slots[m_producerIndex].isNull();
+    m_slots[m_producerIndex].reset();
+    return overwritten;
+}
+
+bool FrameMailbox::take(FrameHandle& frame)
+{
+    if (!hasNewFrame())
+        return false;
+
+    // 用消费者槽（已清空）交换出中间槽中的最新帧
+    int oldState = m_state.fetchAndStoreOrdered(m_consumerIndex);
+    m_consumerIndex = oldState & IndexMask;
+    frame = m_slots[m_consumerIndex];
+    m_slots[m_consumerIndex].reset(); // 句柄交给调用方，邮箱不再额外占用帧缓冲区
+    return !frame.isNull();
+}
+
+void FrameMailbox::clear()
+{
+    // 发布一个空句柄覆盖中间槽中的旧帧
+    publish(FrameHandle());
+}
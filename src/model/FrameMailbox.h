@@ -0,0 +1,30 @@
+#pragma once
+#include <QAtomicInt>
+#include "FramePool.h"
+
+// 最新帧邮箱：单生产者/单消费者的无锁三缓冲
+// 解码线程publish()永不阻塞，界面线程按刷新节奏take()取最新一帧，未取走的旧帧直接被覆盖
+class FrameMailbox {
+public:
+    FrameMailbox();
+
+    // 发布新帧（仅生产者线程调用），覆盖尚未被取走的旧帧；返回true表示有旧帧被覆盖（丢帧）
+    bool publish(const FrameHandle& frame);
+    // 取出最新帧（仅消费者线程调用），没有新帧时返回false
+    bool take(FrameHandle& frame);
+    // 是否有尚未取走的新帧
+    bool hasNewFrame() const { return (m_state.loadAcquire() & NewFrameFlag) != 0; }
+    // 清空邮箱（仅生产者线程调用，如重连前）
+    void clear();
+
+private:
+    enum { IndexMask = 0x3, NewFrameFlag = 0x4 };
+
+    FrameHandle m_slots[3];    // 三个缓冲槽：生产者槽、中间槽、消费者槽
+    QAtomicInt m_state;        // 中间槽索引 | 新帧标志，通过原子交换在两端之间传递
+    int m_producerIndex;       // 生产者独占的槽索引
+    int m_consumerIndex;       // 消费者独占的槽索引
+
+    FrameMailbox(const FrameMailbox&) = delete;
+    FrameMailbox& operator=(const FrameMailbox&) = delete;
+};
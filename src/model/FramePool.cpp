@@ -0,0 +1,208 @@
+#include "FramePool.h"
+#include <QElapsedTimer>
+
+extern "C" {
+#include <libavutil/mem.h>
+}
+
+// 单个帧槽：预分配的像素缓冲区及其包装QImage
+struct FrameSlot {
+    QImage image;                 // 包装buffer的QImage（不拥有像素数据）
+    uint8_t* buffer = nullptr;    // av_malloc分配的对齐像素缓冲区
+    int bytesPerLine = 0;         // 行字节数（32字节对齐）
+    qint64 timestampNs = 0;       // 帧时间戳（单调时钟纳秒）
+    QAtomicInt refCount;          // 句柄引用计数
+    QAtomicInt inUse;             // 是否已借出（0-空闲 1-借出）
+    FramePoolData* owner = nullptr; // 所属的一代缓冲区
+};
+
+// 一代帧缓冲区：帧池持有1个引用，每个借出的帧槽各持有1个引用
+struct FramePoolData {
+    QVector<FrameSlot*> slots;    // 帧槽列表
+    QAtomicInt refCount;          // 引用计数
+    int nextIndex = 0;            // 下一次查找空闲帧的起始位置（仅生产者线程访问）
+};
+
+// 释放一代缓冲区的引用，最后一个引用释放时回收全部内存
+static void derefPoolData(FramePoolData* data)
+{
+    if (!data->refCount.deref()) {
+        for (FrameSlot* slot : data->slots) {
+            slot->image = QImage();
+            av_free(slot->buffer);
+            delete slot;
+        }
+        delete data;
+    }
+}
+
+// ============================================
+// FrameHandle
+// ============================================
+
+FrameHandle::FrameHandle()
+    : m_slot(nullptr)
+{
+}
+
+FrameHandle::FrameHandle(FrameSlot* slot)
+    : m_slot(slot)
+{
+}
+
+FrameHandle::FrameHandle(const FrameHandle& other)
+    : m_slot(other.m_slot)
+{
+    if (m_slot)
+        m_slot->refCount.ref();
+}
+
+FrameHandle& FrameHandle::operator=(const FrameHandle& other)
+{
+    if (m_slot != other.m_slot) {
+        if (other.m_slot)
+            other.m_slot->refCount.ref();
+        reset();
+        m_slot = other.m_slot;
+    }
+    return *this;
+}
+
+FrameHandle::~FrameHandle()
+{
+    reset();
+}
+
+void FrameHandle::reset()
+{
+    if (!m_slot)
+        return;
+    FrameSlot* slot = m_slot;
+    m_slot = nullptr;
+    if (!slot->refCount.deref()) {
+        // 最后一个引用释放：标记帧槽空闲，归还给帧池
+        FramePoolData* owner = slot->owner;
+        slot->inUse.storeRelease(0);
+        derefPoolData(owner);
+    }
+}
+
+const QImage& FrameHandle::image() const
+{
+    static const QImage nullImage;
+    return m_slot ? m_slot->image : nullImage;
+}
+
+uint8_t* FrameHandle::bits() const
+{
+    return m_slot ? m_slot->buffer : nullptr;
+}
+
+int FrameHandle::bytesPerLine() const
+{
+    return m_slot ? m_slot->bytesPerLine : 0;
+}
+
+void FrameHandle::setTimestampNs(qint64 timestampNs)
+{
+    if (m_slot)
+        m_slot->timestampNs = timestampNs;
+}
+
+qint64 FrameHandle::timestampNs() const
+{
+    return m_slot ? m_slot->timestampNs : 0;
+}
+
+qint64 FrameHandle::monotonicNs()
+{
+    // 首次调用时启动（C++11保证局部静态变量线程安全初始化）
+    static QElapsedTimer clock = []() {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock.nsecsElapsed();
+}
+
+// ============================================
+// FramePool
+// ============================================
+
+FramePool::FramePool(int capacity)
+    : m_data(nullptr), m_capacity(qMax(2, capacity)),
+      m_width(0), m_height(0), m_format(QImage::Format_Invalid)
+{
+}
+
+FramePool::~FramePool()
+{
+    release();
+}
+
+bool FramePool::reset(int width, int height, QImage::Format format)
+{
+    if (m_data && width == m_width && height == m_height && format == m_format)
+        return true; // 尺寸未变化，继续复用
+
+    release();
+    if (width <= 0 || height <= 0)
+        return false;
+
+    // 行字节数按32字节对齐，便于sws_scale使用SIMD写入
+    int bitsPerPixel = QImage::toPixelFormat(format).bitsPerPixel();
+    int bytesPerLine = ((width * bitsPerPixel / 8) + 31) & ~31;
+
+    FramePoolData* data = new FramePoolData;
+    data->refCount.storeRelease(1); // 帧池自身持有的引用
+    for (int i = 0; i < m_capacity; ++i) {
+        FrameSlot* slot = new FrameSlot;
+        slot->buffer = static_cast<uint8_t*>(av_malloc(static_cast<size_t>(bytesPerLine) * height));
+        if (!slot->buffer) {
+            delete slot;
+            derefPoolData(data);
+            return false;
+        }
+        slot->bytesPerLine = bytesPerLine;
+        slot->image = QImage(slot->buffer, width, height, bytesPerLine, format);
+        slot->owner = data;
+        data->slots.append(slot);
+    }
+
+    m_data = data;
+    m_width = width;
+    m_height = height;
+    m_format = format;
+    return true;
+}
+
+FrameHandle FramePool::acquire()
+{
+    if (!m_data)
+        return FrameHandle();
+
+    // 从上次位置开始轮询查找空闲帧槽
+    int count = m_data->slots.size();
+    for (int i = 0; i < count; ++i) {
+        int index = (m_data->nextIndex + i) % count;
+        FrameSlot* slot = m_data->slots[index];
+        if (slot->inUse.testAndSetAcquire(0, 1)) {
+            slot->refCount.storeRelease(1);
+            m_data->refCount.ref(); // 借出的帧槽持有一代缓冲区的引用
+            m_data->nextIndex = (index + 1) % count;
+            return FrameHandle(slot);
+        }
+    }
+    return FrameHandle(); // 所有帧都在使用中（渲染跟不上解码）
+}
+
+void FramePool::release()
+{
+    if (m_data) {
+        derefPoolData(m_data);
+        m_data = nullptr;
+    }
+    m_width = 0;
+    m_height = 0;
+    m_format = QImage::Format_Invalid;
+}
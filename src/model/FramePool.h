@@ -0,0 +1,70 @@
+#pragma once
+#include <QImage>
+#include <QVector>
+#include <QAtomicInt>
+#include <QMetaType>
+
+// 帧池内部数据（前向声明，仅在FramePool.cpp中定义）
+struct FramePoolData;
+struct FrameSlot;
+
+// 池化帧句柄：引用计数的只读视频帧
+// 所有句柄副本都释放后，帧缓冲区自动归还到所属帧池，供解码线程复用
+class FrameHandle {
+public:
+    FrameHandle();                                  // 构造空句柄
+    FrameHandle(const FrameHandle& other);          // 拷贝（仅增加引用计数，不拷贝像素）
+    FrameHandle& operator=(const FrameHandle& other);
+    ~FrameHandle();                                 // 释放引用，必要时归还帧缓冲区
+
+    bool isNull() const { return m_slot == nullptr; } // 是否为空句柄
+    const QImage& image() const;                    // 获取帧图像（包装池内缓冲区，生命周期受句柄约束）
+    QSize size() const { return image().size(); }   // 获取帧尺寸
+    void reset();                                   // 主动释放引用
+
+    // 获取可写的像素缓冲区（仅供生产者在发布前填充数据）
+    uint8_t* bits() const;
+    int bytesPerLine() const;
+
+    // 帧时间戳（单调时钟纳秒，由生产者在发布前设置，用于统计端到端延迟）
+    void setTimestampNs(qint64 timestampNs);
+    qint64 timestampNs() const;
+    static qint64 monotonicNs();                    // 进程内统一的单调时钟
+
+private:
+    friend class FramePool;
+    explicit FrameHandle(FrameSlot* slot);          // 由FramePool创建
+    FrameSlot* m_slot;                              // 指向池中的帧槽
+};
+
+Q_DECLARE_METATYPE(FrameHandle)
+
+// 帧池：预分配N个固定尺寸的RGB帧缓冲区，运行期间零堆分配
+// 仅由单个生产者线程（Model解码线程）调用acquire()，句柄可在任意线程释放
+class FramePool {
+public:
+    explicit FramePool(int capacity = 4);           // 构造函数，指定池中帧数量
+    ~FramePool();                                   // 析构函数，未归还的帧在最后一个句柄释放时回收
+
+    // 按尺寸和格式（重新）分配帧缓冲区；尺寸未变化时不做任何事
+    bool reset(int width, int height, QImage::Format format);
+    // 获取一个空闲帧，池已耗尽时返回空句柄（调用方应丢弃该帧）
+    FrameHandle acquire();
+    // 释放全部缓冲区（已借出的帧在归还时才真正释放）
+    void release();
+
+    int capacity() const { return m_capacity; }     // 池容量
+    int width() const { return m_width; }           // 当前帧宽度
+    int height() const { return m_height; }         // 当前帧高度
+    QImage::Format format() const { return m_format; } // 当前帧格式
+
+private:
+    FramePoolData* m_data;                          // 当前一代帧缓冲区（尺寸变化时整体替换）
+    int m_capacity;                                 // 池容量
+    int m_width;                                    // 帧宽度
+    int m_height;                                   // 帧高度
+    QImage::Format m_format;                        // 帧格式
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+};
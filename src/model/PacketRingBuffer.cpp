@@ -0,0 +1,240 @@
+#include "PacketRingBuffer.h"
+
+PacketRingBuffer::PacketRingBuffer(int capacityMs, qint64 maxBytes)
+    : m_codecpar(avcodec_parameters_alloc()), m_timeBase{1, 90000}, m_active(false),
+      m_capacityMs(capacityMs), m_maxBytes(maxBytes), m_bytes(0)
+{
+}
+
+PacketRingBuffer::~PacketRingBuffer()
+{
+    end();
+    avcodec_parameters_free(&m_codecpar);
+}
+
+void PacketRingBuffer::setCapacityMs(int ms)
+{
+    QMutexLocker locker(&m_mutex);
+    m_capacityMs = qMax(0, ms);
+}
+
+int PacketRingBuffer::capacityMs() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_capacityMs;
+}
+
+void PacketRingBuffer::begin(const AVStream* stream)
+{
+    QMutexLocker locker(&m_mutex);
+    clear();
+    m_active = m_codecpar && avcodec_parameters_copy(m_codecpar, stream->codecpar) >= 0;
+    m_timeBase = stream->time_base;
+    if (m_active) {
+        for (PacketSink* sink : m_continuousSinks) {
+            sink->streamStarted(m_codecpar, m_timeBase);
+        }
+    }
+}
+
+void PacketRingBuffer::end()
+{
+    QList<PacketSink*> sinks;
+    {
+        QMutexLocker locker(&m_mutex);
+        clear();
+        if (m_active) {
+            for (PacketSink* sink : m_continuousSinks) {
+                sink->streamEnded(); // 持续接收端保持挂上，持锁通知保证与removeSink互斥
+            }
+        }
+        m_active = false;
+        sinks.swap(m_sinks);
+    }
+    // 在锁外通知，接收端可以在回调中提交后续处理
+    for (PacketSink* sink : sinks) {
+        sink->streamEnded();
+    }
+}
+
+void PacketRingBuffer::push(const AVPacket* packet, qint64 timeMs)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_active) {
+        return;
+    }
+
+    // 接收端只做引用计数复制，返回false的摘除
+    for (int i = m_sinks.size() - 1; i >= 0; --i) {
+        if (!m_sinks[i]->writePacket(packet)) {
+            m_sinks.removeAt(i);
+        }
+    }
+    for (int i = m_continuousSinks.size() - 1; i >= 0; --i) {
+        if (!m_continuousSinks[i]->writePacket(packet)) {
+            m_continuousSinks.removeAt(i);
+        }
+    }
+
+    bool keyframe = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+    if (m_entries.isEmpty() && !keyframe) {
+        return; // 缓冲必须从关键帧开始
+    }
+    Entry entry;
+    entry.packet = av_packet_clone(packet);
+    entry.timeMs = timeMs;
+    if (!entry.packet) {
+        return;
+    }
+    m_entries.enqueue(entry);
+    m_bytes += packet->size;
+    if (keyframe) {
+        m_keyframeTimes.enqueue(timeMs);
+    }
+
+    // 第二个GOP起的数据已覆盖预录时长（或超过字节上限）时丢弃最早的GOP
+    while (m_keyframeTimes.size() >= 2
+           && (timeMs - m_keyframeTimes.at(1) >= m_capacityMs || m_bytes > m_maxBytes)) {
+        dropFirstGop();
+    }
+    if (m_bytes > m_maxBytes) {
+        clear(); // 单个GOP已超过上限，等待下一个关键帧重新开始
+    }
+}
+
+bool PacketRingBuffer::attach(PacketSink* sink, QList<AVPacket*>& preRoll, AVCodecParameters* codecpar,
+                              AVRational* timeBase)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_active || m_entries.isEmpty() || avcodec_parameters_copy(codecpar, m_codecpar) < 0) {
+        return false;
+    }
+    for (const Entry& entry : m_entries) {
+        AVPacket* copy = av_packet_clone(entry.packet);
+        if (copy) {
+            preRoll.append(copy);
+        }
+    }
+    *timeBase = m_timeBase;
+    m_sinks.append(sink);
+    return true;
+}
+
+void PacketRingBuffer::detach(PacketSink* sink)
+{
+    QMutexLocker locker(&m_mutex);
+    m_sinks.removeAll(sink);
+}
+
+void PacketRingBuffer::addSink(PacketSink* sink)
+{
+    QMutexLocker locker(&m_mutex);
+    m_continuousSinks.append(sink);
+    if (!m_active) {
+        return;
+    }
+    sink->streamStarted(m_codecpar, m_timeBase);
+    // 从最近一个关键帧开始补发，接收端无需等待下一个GOP
+    int start = m_entries.size() - 1;
+    while (start > 0 && !(m_entries.at(start).packet->flags & AV_PKT_FLAG_KEY)) {
+        --start;
+    }
+    for (int i = qMax(0, start); i < m_entries.size(); ++i) {
+        sink->writePacket(m_entries.at(i).packet);
+    }
+}
+
+void PacketRingBuffer::removeSink(PacketSink* sink)
+{
+    QMutexLocker locker(&m_mutex);
+    m_continuousSinks.removeAll(sink);
+}
+
+std::shared_ptr<PacketGop> PacketRingBuffer::latestGop() const
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_active || m_entries.isEmpty()) {
+        return std::shared_ptr<PacketGop>();
+    }
+    std::shared_ptr<PacketGop> gop = std::make_shared<PacketGop>();
+    gop->codecpar = avcodec_parameters_alloc();
+    if (!gop->codecpar || avcodec_parameters_copy(gop->codecpar, m_codecpar) < 0) {
+        return std::shared_ptr<PacketGop>();
+    }
+    gop->timeBase = m_timeBase;
+    int start = m_entries.size() - 1;
+    while (start > 0 && !(m_entries.at(start).packet->flags & AV_PKT_FLAG_KEY)) {
+        --start;
+    }
+    for (int i = start; i < m_entries.size(); ++i) {
+        AVPacket* copy = av_packet_clone(m_entries.at(i).packet);
+        if (copy) {
+            gop->packets.append(copy);
+        }
+    }
+    return gop;
+}
+
+qint64 PacketRingBuffer::bufferedMs() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.isEmpty() ? 0 : m_entries.last().timeMs - m_entries.first().timeMs;
+}
+
+qint64 PacketRingBuffer::bufferedBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_bytes;
+}
+
+void PacketRingBuffer::dropFirstGop()
+{
+    // 丢弃第一个关键帧及其后的非关键帧，直到下一个关键帧
+    do {
+        Entry entry = m_entries.dequeue();
+        m_bytes -= entry.packet->size;
+        av_packet_free(&entry.packet);
+    } while (!m_entries.isEmpty() && !(m_entries.first().packet->flags & AV_PKT_FLAG_KEY));
+    m_keyframeTimes.dequeue();
+}
+
+void PacketRingBuffer::clear()
+{
+    while (!m_entries.isEmpty()) {
+        Entry entry = m_entries.dequeue();
+        av_packet_free(&entry.packet);
+    }
+    m_keyframeTimes.clear();
+    m_bytes = 0;
+}
+
+PacketGop::~PacketGop()
+{
+    for (AVPacket*& packet : packets) {
+        av_packet_free(&packet);
+    }
+    avcodec_parameters_free(&codecpar);
+}
+
+void PacketTimeline::reset()
+{
+    m_baseDts = AV_NOPTS_VALUE;
+    m_lastDts = AV_NOPTS_VALUE;
+    m_maxPts = 0;
+}
+
+void PacketTimeline::rebase(AVPacket* packet)
+{
+    int64_t dts = packet->dts != AV_NOPTS_VALUE ? packet->dts : packet->pts;
+    if (dts == AV_NOPTS_VALUE || (m_lastDts != AV_NOPTS_VALUE && dts <= m_lastDts)) {
+        dts = m_lastDts == AV_NOPTS_VALUE ? 0 : m_lastDts + qMax<int64_t>(1, packet->duration);
+    }
+    if (m_baseDts == AV_NOPTS_VALUE) {
+        m_baseDts = dts;
+    }
+    int64_t pts = packet->pts != AV_NOPTS_VALUE ? qMax(packet->pts, dts) : dts;
+    m_lastDts = dts;
+    m_maxPts = qMax(m_maxPts, pts - m_baseDts);
+    packet->dts = dts - m_baseDts;
+    packet->pts = pts - m_baseDts;
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <QList>
+#include <QMutex>
+#include <QQueue>
+#include <memory>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+// 数据包接收端：挂到预录缓冲上，接收此后到达的每个视频包（如报警片段的后录部分、连续录像）
+class PacketSink {
+public:
+    virtual ~PacketSink() {}
+    // 视频流开始（仅持续接收端，解复用线程中持有缓冲锁时调用），之后的数据包使用这组流参数
+    virtual void streamStarted(const AVCodecParameters* codecpar, AVRational timeBase)
+    {
+        Q_UNUSED(codecpar);
+        Q_UNUSED(timeBase);
+    }
+    // 接收一个视频包（解复用线程中持有缓冲锁时调用，不能阻塞），返回false表示不再需要数据，随即被摘除
+    virtual bool writePacket(const AVPacket* packet) = 0;
+    // 视频流结束（断线、停止或重新打开）；一次性接收端已被摘除，持续接收端在下次streamStarted后继续接收
+    virtual void streamEnded() = 0;
+};
+
+// 数据包时间线：以第一个数据包为零点重写时间戳，缺失或不递增的DTS按前一个包顺延（封装MP4/MKV时要求DTS单调递增）
+class PacketTimeline {
+public:
+    PacketTimeline() { reset(); }
+    void reset();
+    // 重写数据包的pts/dts（仍为输入时间基）
+    void rebase(AVPacket* packet);
+    int64_t durationTs() const { return m_maxPts; } // 已写入部分的时长（输入时间基）
+
+private:
+    int64_t m_baseDts;
+    int64_t m_lastDts;
+    int64_t m_maxPts;
+};
+
+// 一组GOP的压缩数据（最近一个关键帧起的数据包引用），用于在其它线程中解码出原始分辨率的最新画面
+struct PacketGop {
+    QList<AVPacket*> packets;          // 第一个为关键帧
+    AVCodecParameters* codecpar = nullptr;
+    AVRational timeBase = {1, 90000};
+
+    PacketGop() = default;
+    ~PacketGop();
+    PacketGop(const PacketGop&) = delete;
+    PacketGop& operator=(const PacketGop&) = delete;
+};
+
+// 压缩数据包预录缓冲：保存最近一段时间的视频包（引用计数，不复制数据），始终从关键帧开始
+// • 按到达时间裁剪：第二个关键帧之后的数据已覆盖预录时长时丢弃最早的一组GOP
+// • 超过字节上限时同样丢弃最早的GOP（只剩一组GOP时清空，等待下一个关键帧）
+// • 保存压缩数据的开销约为保存解码帧的百分之一，报警时直接重新封装，不需要重新编码
+class PacketRingBuffer {
+public:
+    explicit PacketRingBuffer(int capacityMs = 10000, qint64 maxBytes = 16 * 1024 * 1024);
+    ~PacketRingBuffer();
+
+    void setCapacityMs(int ms);                // 设置预录时长
+    int capacityMs() const;
+    // 视频流开始（解复用线程，打开流后调用）：记录流参数并清空缓冲
+    void begin(const AVStream* stream);
+    // 视频流结束（解复用线程）：清空缓冲，通知并摘除所有接收端
+    void end();
+    // 放入一个视频包（解复用线程），先分发给接收端再放入缓冲，timeMs为到达时刻（单调时钟）
+    void push(const AVPacket* packet, qint64 timeMs);
+    // 复制当前缓冲（从关键帧开始，调用方负责av_packet_free）并挂上接收端，同一把锁内完成，预录与后录之间不漏包
+    // 流未开始或缓冲中还没有关键帧时返回false，接收端未挂上
+    bool attach(PacketSink* sink, QList<AVPacket*>& preRoll, AVCodecParameters* codecpar, AVRational* timeBase);
+    void detach(PacketSink* sink);             // 摘除接收端（不调用streamEnded）
+    // 挂上持续接收端（如连续录像）：跨越断线重连持续接收，每次打开流时收到streamStarted
+    // 流已开始时立即收到streamStarted和缓冲中最近一个关键帧起的数据包；调用方保证removeSink之前缓冲有效
+    void addSink(PacketSink* sink);
+    void removeSink(PacketSink* sink);         // 摘除持续接收端，返回后不会再有回调
+    // 复制最近一个关键帧到最新数据包（只增加引用计数），缓冲中没有关键帧时返回空
+    std::shared_ptr<PacketGop> latestGop() const;
+    qint64 bufferedMs() const;                 // 当前缓冲的时长（毫秒）
+    qint64 bufferedBytes() const;              // 当前缓冲的字节数
+
+private:
+    struct Entry {
+        AVPacket* packet;
+        qint64 timeMs;                         // 到达时刻
+    };
+
+    void dropFirstGop();                       // 丢弃最早的一组GOP（需持有m_mutex）
+    void clear();                              // 清空缓冲（需持有m_mutex）
+
+    mutable QMutex m_mutex;
+    QQueue<Entry> m_entries;                   // 缓冲的视频包，第一个总是关键帧
+    QQueue<qint64> m_keyframeTimes;            // 缓冲中各关键帧的到达时刻
+    QList<PacketSink*> m_sinks;                // 挂上的一次性接收端
+    QList<PacketSink*> m_continuousSinks;      // 持续接收端
+    AVCodecParameters* m_codecpar;             // 视频流参数（流开始时复制）
+    AVRational m_timeBase;                     // 视频包时间基
+    bool m_active;                             // 视频流是否已开始
+    int m_capacityMs;
+    qint64 m_maxBytes;
+    qint64 m_bytes;
+
+    PacketRingBuffer(const PacketRingBuffer&) = delete;
+    PacketRingBuffer& operator=(const PacketRingBuffer&) = delete;
+};
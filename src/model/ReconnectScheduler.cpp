@@ -0,0 +1,41 @@
+#include "ReconnectScheduler.h"
+#include <QRandomGenerator>
+
+ReconnectScheduler& ReconnectScheduler::instance()
+{
+    static ReconnectScheduler scheduler;
+    return scheduler;
+}
+
+ReconnectScheduler::ReconnectScheduler()
+    : m_baseDelayMs(1000), m_maxDelayMs(30000), m_maxConcurrentOpens(4), m_openSlots(4)
+{
+}
+
+int ReconnectScheduler::backoffDelayMs(int attempt) const
+{
+    QMutexLocker locker(&m_mutex);
+    // 指数退避，移位次数限制在安全范围内防止溢出
+    int shift = qBound(0, attempt - 1, 16);
+    qint64 delay = qMin(static_cast<qint64>(m_baseDelayMs) << shift, static_cast<qint64>(m_maxDelayMs));
+    // 抖动：取[delay/2, delay]内的随机值
+    int half = static_cast<int>(delay / 2);
+    return half + QRandomGenerator::global()->bounded(half + 1);
+}
+
+bool ReconnectScheduler::tryAcquireOpenSlot(int timeoutMs)
+{
+    return m_openSlots.tryAcquire(1, timeoutMs);
+}
+
+void ReconnectScheduler::releaseOpenSlot()
+{
+    m_openSlots.release(1);
+}
+
+void ReconnectScheduler::setBackoff(int baseDelayMs, int maxDelayMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_baseDelayMs = qMax(100, baseDelayMs);
+    m_maxDelayMs = qMax(m_baseDelayMs, maxDelayMs);
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <QMutex>
+#include <QSemaphore>
+
+// 视频流健康状态
+enum class StreamHealth {
+    Idle = 0,       // 未启动
+    Connecting,     // 正在打开流
+    Online,         // 已出画面
+    Backoff         // 连接失败或断开，等待重试
+};
+
+// 重连调度器：所有视频流共享，避免网络恢复时所有摄像头同时重连
+// • 指数退避：第N次重试等待 base*2^(N-1)，不超过上限
+// • 抖动：在退避时间的后一半内随机取值，打散各路的重试时刻
+// • 并发打开上限：同一时刻最多允许maxConcurrentOpens路执行打开/探测
+class ReconnectScheduler {
+public:
+    static ReconnectScheduler& instance();
+
+    // 计算第attempt次重试前的等待时间（毫秒，含抖动）
+    int backoffDelayMs(int attempt) const;
+    // 获取打开许可，超时返回false（调用方应检查停止标志后重试）
+    bool tryAcquireOpenSlot(int timeoutMs);
+    // 归还打开许可
+    void releaseOpenSlot();
+
+    // 调整退避参数
+    void setBackoff(int baseDelayMs, int maxDelayMs);
+    int maxConcurrentOpens() const { return m_maxConcurrentOpens; }
+
+private:
+    ReconnectScheduler();
+
+    mutable QMutex m_mutex;         // 保护退避参数
+    int m_baseDelayMs;              // 首次重试等待时间
+    int m_maxDelayMs;               // 最大等待时间
+    const int m_maxConcurrentOpens; // 并发打开上限
+    QSemaphore m_openSlots;         // 打开许可
+
+    ReconnectScheduler(const ReconnectScheduler&) = delete;
+    ReconnectScheduler& operator=(const ReconnectScheduler&) = delete;
+};
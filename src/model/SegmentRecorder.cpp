@@ -0,0 +1,341 @@
+#include "SegmentRecorder.h"
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QSet>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+// 各录像线程共享：配额清理互斥，以及正在写入的分段（清理时跳过）
+QMutex& quotaMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+QSet<QString>& openSegments()
+{
+    static QSet<QString> files;
+    return files;
+}
+
+} // namespace
+
+SegmentRecorder::SegmentRecorder(const QString& rootDirectory, const QString& prefix, const RecordOptions& options,
+                                 QObject* parent)
+    : QThread(parent), m_rootDirectory(rootDirectory), m_prefix(prefix), m_options(options), m_buffer(nullptr),
+      m_queuedBytes(0), m_dropping(false), m_stopRequested(false), m_droppedPackets(0),
+      m_codecpar(avcodec_parameters_alloc()), m_timeBase{1, 90000}, m_hasParameters(false),
+      m_output(nullptr), m_avio(nullptr), m_segmentTs(0)
+{
+    setStackSize(512 * 1024);
+}
+
+SegmentRecorder::~SegmentRecorder()
+{
+    stop();
+    wait();
+    // 写入线程退出时队列已清空；线程未启动过时在这里释放
+    while (!m_queue.isEmpty()) {
+        Item item = m_queue.dequeue();
+        av_packet_free(&item.packet);
+        avcodec_parameters_free(&item.codecpar);
+    }
+    avcodec_parameters_free(&m_codecpar);
+}
+
+void SegmentRecorder::start(PacketRingBuffer& buffer)
+{
+    m_buffer = &buffer;
+    QThread::start();
+    buffer.addSink(this);
+}
+
+void SegmentRecorder::stop()
+{
+    if (m_buffer) {
+        m_buffer->removeSink(this); // 返回后解复用线程不会再回调
+        m_buffer = nullptr;
+    }
+    QMutexLocker locker(&m_mutex);
+    m_stopRequested = true;
+    m_wait.wakeOne();
+}
+
+void SegmentRecorder::streamStarted(const AVCodecParameters* codecpar, AVRational timeBase)
+{
+    Item item;
+    item.kind = Item::Start;
+    item.packet = nullptr;
+    item.codecpar = avcodec_parameters_alloc();
+    item.timeBase = timeBase;
+    if (!item.codecpar || avcodec_parameters_copy(item.codecpar, codecpar) < 0) {
+        avcodec_parameters_free(&item.codecpar);
+        return;
+    }
+    QMutexLocker locker(&m_mutex);
+    m_dropping = false;
+    enqueue(item, 0);
+}
+
+bool SegmentRecorder::writePacket(const AVPacket* packet)
+{
+    QMutexLocker locker(&m_mutex);
+    bool keyframe = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+    if (m_queuedBytes + packet->size > MaxQueuedBytes) {
+        m_dropping = true; // 磁盘跟不上，丢弃到下一个关键帧
+    } else if (m_dropping && keyframe) {
+        m_dropping = false;
+    }
+    if (m_dropping) {
+        m_droppedPackets.fetchAndAddRelaxed(1);
+        return true;
+    }
+
+    Item item;
+    item.kind = Item::Packet;
+    item.packet = av_packet_clone(packet); // 只增加引用计数
+    item.codecpar = nullptr;
+    if (item.packet) {
+        enqueue(item, packet->size);
+    }
+    return true;
+}
+
+void SegmentRecorder::streamEnded()
+{
+    Item item;
+    item.kind = Item::End;
+    item.packet = nullptr;
+    item.codecpar = nullptr;
+    QMutexLocker locker(&m_mutex);
+    enqueue(item, 0);
+}
+
+void SegmentRecorder::enqueue(const Item& item, qint64 bytes)
+{
+    m_queue.enqueue(item);
+    m_queuedBytes += bytes;
+    m_wait.wakeOne();
+}
+
+void SegmentRecorder::run()
+{
+    QMutexLocker locker(&m_mutex);
+    while (true) {
+        while (m_queue.isEmpty() && !m_stopRequested) {
+            m_wait.wait(&m_mutex);
+        }
+        if (m_queue.isEmpty()) {
+            break; // 已请求停止且数据已全部写入
+        }
+        Item item = m_queue.dequeue();
+        if (item.packet) {
+            m_queuedBytes -= item.packet->size;
+        }
+        locker.unlock();
+
+        switch (item.kind) {
+        case Item::Start:
+            // 流重新打开（参数可能变化），从新流的第一个关键帧开始新分段
+            closeSegment();
+            m_hasParameters = avcodec_parameters_copy(m_codecpar, item.codecpar) >= 0;
+            m_timeBase = item.timeBase;
+            avcodec_parameters_free(&item.codecpar);
+            break;
+        case Item::Packet:
+            handlePacket(item.packet);
+            av_packet_free(&item.packet);
+            break;
+        case Item::End:
+            closeSegment();
+            m_hasParameters = false;
+            break;
+        }
+
+        locker.relock();
+    }
+    locker.unlock();
+    closeSegment();
+}
+
+void SegmentRecorder::handlePacket(AVPacket* packet)
+{
+    bool keyframe = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+    if (m_output && keyframe && m_timeline.durationTs() >= m_segmentTs) {
+        closeSegment(); // 超过分段时长，在关键帧处切分
+    }
+    if (!m_output) {
+        if (!keyframe || !m_hasParameters || !openSegment()) {
+            return; // 分段必须从关键帧开始
+        }
+    }
+
+    m_timeline.rebase(packet);
+    packet->stream_index = 0;
+    packet->pos = -1;
+    av_packet_rescale_ts(packet, m_timeBase, m_output->streams[0]->time_base);
+    if (av_write_frame(m_output, packet) < 0) {
+        emit recordError(QString("写入录像分段失败: %1").arg(m_file.fileName()));
+        closeSegment();
+    }
+}
+
+bool SegmentRecorder::openSegment()
+{
+    QDir dir(m_rootDirectory + "/" + m_prefix);
+    if (!dir.exists() && !dir.mkpath(".")) {
+        emit recordError(QString("无法创建录像目录: %1").arg(dir.path()));
+        return false;
+    }
+    bool mkv = m_options.container == "mkv";
+    QString baseName = QString("%1_%2").arg(m_prefix)
+                       .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss_zzz"));
+
+    // 无缓冲打开：写入由AVIO的1 MiB缓冲攒成整块后直接落盘
+    // 只创建新文件，不覆盖已有分段（写入出错后重开、停止后立即重新开始等可能在同一时刻重开）
+    QString fileName;
+    for (int suffix = 0; ; ++suffix) {
+        fileName = dir.filePath(QString("%1%2.%3").arg(baseName)
+                                .arg(suffix > 0 ? QString("_%1").arg(suffix) : QString())
+                                .arg(mkv ? "mkv" : "mp4"));
+        m_file.setFileName(fileName);
+        if (m_file.open(QIODevice::WriteOnly | QIODevice::NewOnly | QIODevice::Unbuffered)) {
+            break;
+        }
+        if (!m_file.exists() || suffix >= MaxNameCollisions) {
+            emit recordError(QString("无法创建录像文件: %1").arg(fileName));
+            return false;
+        }
+    }
+
+    unsigned char* buffer = static_cast<unsigned char*>(av_malloc(AvioBufferSize));
+    m_avio = buffer ? avio_alloc_context(buffer, AvioBufferSize, 1, this, nullptr, writeCallback, seekCallback)
+                    : nullptr;
+    bool ok = m_avio && avformat_alloc_output_context2(&m_output, nullptr, mkv ? "matroska" : "mp4",
+                                                       nullptr) >= 0 && m_output;
+    AVStream* stream = ok ? avformat_new_stream(m_output, nullptr) : nullptr;
+    ok = stream && avcodec_parameters_copy(stream->codecpar, m_codecpar) >= 0;
+    if (ok) {
+        stream->codecpar->codec_tag = 0;
+        stream->time_base = m_timeBase;
+        m_output->pb = m_avio;
+        m_output->flags |= AVFMT_FLAG_CUSTOM_IO;
+        ok = avformat_write_header(m_output, nullptr) >= 0;
+    }
+    if (!ok) {
+        if (!m_avio) {
+            av_free(buffer);
+        }
+        if (m_output) {
+            m_output->pb = nullptr; // 头部未写入，关闭时不写尾部
+        }
+        closeSegment();
+        QFile::remove(fileName);
+        emit recordError(QString("无法打开录像分段: %1").arg(fileName));
+        return false;
+    }
+
+    m_timeline.reset();
+    m_segmentTs = av_rescale_q(m_options.segmentSeconds, AVRational{1, 1}, m_timeBase);
+    QMutexLocker locker(&quotaMutex());
+    openSegments().insert(fileName);
+    return true;
+}
+
+void SegmentRecorder::closeSegment()
+{
+    if (!m_output && !m_avio && !m_file.isOpen()) {
+        return;
+    }
+    QString fileName = m_file.fileName();
+    bool headerWritten = m_output && m_output->pb;
+    if (headerWritten) {
+        av_write_trailer(m_output);
+    }
+    if (m_avio) {
+        avio_flush(m_avio);
+        av_freep(&m_avio->buffer);
+        avio_context_free(&m_avio);
+    }
+    if (m_output) {
+        m_output->pb = nullptr;
+        avformat_free_context(m_output);
+        m_output = nullptr;
+    }
+    qint64 bytes = m_file.size();
+    m_file.close();
+
+    {
+        QMutexLocker locker(&quotaMutex());
+        openSegments().remove(fileName);
+    }
+    if (headerWritten) {
+        qint64 durationMs = av_rescale_q(m_timeline.durationTs(), m_timeBase, AVRational{1, 1000});
+        emit segmentFinished(fileName, bytes, durationMs);
+        enforceQuota();
+    }
+}
+
+void SegmentRecorder::enforceQuota()
+{
+    // 多个摄像头的录像共享一个配额，串行清理
+    QMutexLocker locker(&quotaMutex());
+    QFileInfoList segments;
+    qint64 totalBytes = 0;
+    QDirIterator it(m_rootDirectory, QStringList() << "*.mp4" << "*.mkv", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        QFileInfo info = it.fileInfo();
+        totalBytes += info.size();
+        if (!openSegments().contains(info.filePath())) {
+            segments.append(info);
+        }
+    }
+    if (totalBytes <= m_options.quotaBytes) {
+        return;
+    }
+
+    std::sort(segments.begin(), segments.end(), [](const QFileInfo& a, const QFileInfo& b) {
+        return a.lastModified() < b.lastModified();
+    });
+    for (const QFileInfo& info : segments) {
+        if (totalBytes <= m_options.quotaBytes) {
+            break;
+        }
+        if (QFile::remove(info.filePath())) {
+            totalBytes -= info.size();
+            qDebug() << "录像超过磁盘配额，删除最早的分段" << info.filePath();
+        }
+    }
+}
+
+int SegmentRecorder::writeCallback(void* opaque, AvioWriteData* buf, int size)
+{
+    SegmentRecorder* recorder = static_cast<SegmentRecorder*>(opaque);
+    qint64 written = recorder->m_file.write(reinterpret_cast<const char*>(buf), size);
+    return written == size ? size : AVERROR(EIO);
+}
+
+int64_t SegmentRecorder::seekCallback(void* opaque, int64_t offset, int whence)
+{
+    QFile& file = static_cast<SegmentRecorder*>(opaque)->m_file;
+    switch (whence & ~AVSEEK_FORCE) {
+    case AVSEEK_SIZE:
+        return file.size();
+    case SEEK_SET:
+        break;
+    case SEEK_CUR:
+        offset += file.pos();
+        break;
+    case SEEK_END:
+        offset += file.size();
+        break;
+    default:
+        return AVERROR(EINVAL);
+    }
+    return file.seek(offset) ? offset : AVERROR(EIO);
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QFile>
+#include <QAtomicInteger>
+#include "PacketRingBuffer.h"
+#include "StreamConfig.h"
+
+// 连续录像：作为持续接收端挂到视频流的预录缓冲上，把解复用得到的视频包分段封装为MP4/MKV
+// • 不依赖解码：数据包直接来自解复用线程，视频流只解复用（隐藏、关闭画面）时照常录像
+// • 解复用线程只做引用计数复制并入队，封装和磁盘写入在独立的写入线程中进行
+// • 写入经过1 MiB的AVIO缓冲，文件以无缓冲方式打开，顺序写入时每次写满整块
+// • 每段从关键帧开始，超过分段时长后在下一个关键帧处切分；关闭分段后按磁盘配额删除最早的分段
+// • 磁盘写入跟不上时丢弃积压的数据包，从下一个关键帧继续
+class SegmentRecorder : public QThread, public PacketSink {
+    Q_OBJECT
+
+public:
+    // 分段保存在rootDirectory/prefix/prefix_时间.扩展名，磁盘配额作用于整个rootDirectory
+    SegmentRecorder(const QString& rootDirectory, const QString& prefix, const RecordOptions& options,
+                    QObject* parent = nullptr);
+    ~SegmentRecorder();
+
+    // 挂到预录缓冲并启动写入线程（从缓冲中最近的关键帧开始录）
+    void start(PacketRingBuffer& buffer);
+    // 从预录缓冲摘除，写入线程写完已入队的数据、关闭当前分段后退出（不等待，结束时发出finished信号）
+    void stop();
+    quint32 droppedPackets() const { return m_droppedPackets.loadAcquire(); }
+
+    void streamStarted(const AVCodecParameters* codecpar, AVRational timeBase) override;
+    bool writePacket(const AVPacket* packet) override;
+    void streamEnded() override;
+
+signals:
+    void segmentFinished(const QString& fileName, qint64 bytes, qint64 durationMs); // 一个分段写入完成
+    void recordError(const QString& message);                                       // 打开或写入分段失败
+
+protected:
+    void run() override;       // 写入线程
+
+private:
+    // 写入线程的任务
+    struct Item {
+        enum Kind { Start, Packet, End } kind;
+        AVPacket* packet;                  // Packet：数据包（写入线程负责释放）
+        AVCodecParameters* codecpar;       // Start：流参数副本（写入线程负责释放）
+        AVRational timeBase;
+    };
+    static const int AvioBufferSize = 1024 * 1024;          // AVIO写缓冲（每次整块写入磁盘）
+    static const qint64 MaxQueuedBytes = 32 * 1024 * 1024;  // 写入队列上限
+    static const int MaxNameCollisions = 100;               // 同名分段已存在时最多尝试的序号
+
+    void enqueue(const Item& item, qint64 bytes); // 入队并唤醒写入线程（需持有m_mutex）
+    void handlePacket(AVPacket* packet);          // 写入一个数据包，必要时切分分段
+    bool openSegment();                           // 打开新分段（当前流参数）
+    void closeSegment();                          // 写入尾部并关闭当前分段
+    void enforceQuota();                          // 按磁盘配额删除最早的分段
+#if LIBAVFORMAT_VERSION_MAJOR >= 61
+    typedef const uint8_t AvioWriteData;          // FFmpeg 7起AVIO写回调的缓冲区为const
+#else
+    typedef uint8_t AvioWriteData;
+#endif
+    static int writeCallback(void* opaque, AvioWriteData* buf, int size);
+    static int64_t seekCallback(void* opaque, int64_t offset, int whence);
+
+    QString m_rootDirectory;
+    QString m_prefix;
+    RecordOptions m_options;
+    PacketRingBuffer* m_buffer;
+
+    // 解复用线程与写入线程共享（受m_mutex保护）
+    QMutex m_mutex;
+    QWaitCondition m_wait;
+    QQueue<Item> m_queue;
+    qint64 m_queuedBytes;
+    bool m_dropping;                   // 队列满后丢弃数据包，直到下一个关键帧
+    bool m_stopRequested;
+    QAtomicInteger<quint32> m_droppedPackets;
+
+    // 以下仅写入线程访问
+    AVCodecParameters* m_codecpar;     // 当前流参数
+    AVRational m_timeBase;
+    bool m_hasParameters;
+    AVFormatContext* m_output;         // 当前分段（为空表示未打开）
+    AVIOContext* m_avio;
+    QFile m_file;
+    PacketTimeline m_timeline;         // 当前分段的时间线
+    int64_t m_segmentTs;               // 分段时长（输入时间基）
+};
@@ -0,0 +1,196 @@
+#include "SnapshotWriter.h"
+#include <QRunnable>
+#include <QThread>
+#include <QDebug>
+
+extern "C" {
+#include <libswscale/swscale.h>
+}
+
+// 单张截图的编码任务：在编码线程中写文件，完成后回到界面线程通知
+class SnapshotJob : public QRunnable {
+public:
+    SnapshotJob(SnapshotWriter* writer, const SnapshotWriter::Job& job) : m_writer(writer), m_job(job)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        QImage image = m_job.image;
+        if (image.isNull() && m_job.source) {
+            image = SnapshotWriter::decodeLatestFrame(*m_job.source, !m_job.key.isEmpty());
+        }
+        bool success = !image.isNull() && image.save(m_job.fileName, "JPEG", m_job.quality);
+        m_job.image = QImage(); // 尽早释放图像和数据包
+        m_job.source.reset();
+
+        // SnapshotWriter析构时会等待所有任务结束，投递时对象一定有效
+        SnapshotWriter* writer = m_writer;
+        QString fileName = m_job.fileName;
+        QString key = m_job.key;
+        QMetaObject::invokeMethod(writer, [writer, fileName, success, key]() {
+            writer->onJobFinished(fileName, success, key);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    SnapshotWriter* m_writer;
+    SnapshotWriter::Job m_job;
+};
+
+SnapshotWriter::SnapshotWriter(QObject* parent)
+    : QObject(parent), m_running(0)
+{
+    // 解码和缩放已占用大部分核心，编码只需少量线程
+    m_pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 4, 2));
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+    m_pool.waitForDone(); // 已开始的截图写完，排队中的丢弃
+}
+
+bool SnapshotWriter::submit(const QImage& image, const QString& fileName, int quality,
+                            const QString& key, int minIntervalMs)
+{
+    if (image.isNull()) {
+        return false;
+    }
+    Job job;
+    job.key = key;
+    job.image = image;
+    job.fileName = fileName;
+    job.quality = quality;
+    return enqueue(job, minIntervalMs);
+}
+
+bool SnapshotWriter::submit(const std::shared_ptr<PacketGop>& source, const QString& fileName, int quality,
+                            const QString& key, int minIntervalMs)
+{
+    if (!source || source->packets.isEmpty()) {
+        return false;
+    }
+    Job job;
+    job.key = key;
+    job.source = source;
+    job.fileName = fileName;
+    job.quality = quality;
+    return enqueue(job, minIntervalMs);
+}
+
+bool SnapshotWriter::enqueue(const Job& job, int minIntervalMs)
+{
+    const QString& key = job.key;
+    if (!key.isEmpty()) {
+        // 限速：同一key两次接受的间隔不小于minIntervalMs
+        auto last = m_lastAccepted.find(key);
+        if (last != m_lastAccepted.end() && last->isValid() && last->elapsed() < minIntervalMs) {
+            ++m_stats.rateLimited;
+            return false;
+        }
+
+        // 合并：同一key还在排队时只保存最新的一张
+        for (Job& pending : m_pending) {
+            if (pending.key == key) {
+                pending = job;
+                ++m_stats.coalesced;
+                m_lastAccepted[key].start();
+                return true;
+            }
+        }
+    }
+
+    // 队列已满时丢弃，不计入限速（下一张不必再等待间隔）
+    if (m_pending.size() >= MaxPending) {
+        ++m_stats.dropped;
+        return false;
+    }
+    if (!key.isEmpty()) {
+        m_lastAccepted[key].start();
+    }
+    m_pending.append(job);
+    startJobs();
+    return true;
+}
+
+SnapshotWriter::Stats SnapshotWriter::stats() const
+{
+    Stats stats = m_stats;
+    stats.pending = m_pending.size();
+    stats.running = m_running;
+    return stats;
+}
+
+void SnapshotWriter::startJobs()
+{
+    // 任务只在有空闲线程时才交给线程池，排队中的任务留在m_pending中以便合并
+    while (!m_pending.isEmpty() && m_running < m_pool.maxThreadCount()) {
+        ++m_running;
+        m_pool.start(new SnapshotJob(this, m_pending.takeFirst()));
+    }
+}
+
+void SnapshotWriter::onJobFinished(const QString& fileName, bool success, const QString& key)
+{
+    --m_running;
+    if (success) {
+        ++m_stats.written;
+    }
+    startJobs();
+    emit snapshotSaved(fileName, success, key);
+}
+
+// 用独立的单线程解码器依次解码GOP中的数据包，保留最后一帧并转换为RGB32（原始分辨率）
+QImage SnapshotWriter::decodeLatestFrame(const PacketGop& gop, bool keyframeOnly)
+{
+    const AVCodec* codec = avcodec_find_decoder(gop.codecpar->codec_id);
+    AVCodecContext* codecCtx = codec ? avcodec_alloc_context3(codec) : nullptr;
+    if (!codecCtx || avcodec_parameters_to_context(codecCtx, gop.codecpar) < 0) {
+        avcodec_free_context(&codecCtx);
+        return QImage();
+    }
+    codecCtx->thread_count = 1;
+    AVFrame* frame = av_frame_alloc();
+    AVFrame* latest = av_frame_alloc();
+    if (!frame || !latest || avcodec_open2(codecCtx, codec, nullptr) < 0) {
+        av_frame_free(&frame);
+        av_frame_free(&latest);
+        avcodec_free_context(&codecCtx);
+        return QImage();
+    }
+
+    // 送完数据包后冲刷解码器，取出最后一帧（只解码关键帧时只送第一个数据包）
+    int packetCount = keyframeOnly ? qMin(1, gop.packets.size()) : gop.packets.size();
+    for (int i = 0; i <= packetCount; ++i) {
+        if (avcodec_send_packet(codecCtx, i < packetCount ? gop.packets[i] : nullptr) < 0
+            && i < packetCount) {
+            continue; // 个别数据包损坏时继续解码后续数据包
+        }
+        while (avcodec_receive_frame(codecCtx, frame) == 0) {
+            av_frame_unref(latest);
+            av_frame_move_ref(latest, frame);
+        }
+    }
+
+    QImage image;
+    if (latest->width > 0 && latest->height > 0) {
+        SwsContext* swsCtx = sws_getContext(latest->width, latest->height, static_cast<AVPixelFormat>(latest->format),
+                                            latest->width, latest->height, AV_PIX_FMT_RGB32,
+                                            SWS_BILINEAR, nullptr, nullptr, nullptr);
+        if (swsCtx) {
+            image = QImage(latest->width, latest->height, QImage::Format_RGB32);
+            uint8_t* dst[1] = { image.bits() };
+            int dstStride[1] = { image.bytesPerLine() };
+            sws_scale(swsCtx, latest->data, latest->linesize, 0, latest->height, dst, dstStride);
+            sws_freeContext(swsCtx);
+        }
+    }
+    if (image.isNull()) {
+        qDebug() << "截图：源数据解码失败";
+    }
+    av_frame_free(&frame);
+    av_frame_free(&latest);
+    avcodec_free_context(&codecCtx);
+    return image;
+}
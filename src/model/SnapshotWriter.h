@@ -0,0 +1,71 @@
+#pragma once
+#include <QObject>
+#include <QImage>
+#include <QHash>
+#include <QList>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include "PacketRingBuffer.h"
+
+// 截图写入：JPEG编码和写文件在编码线程池中进行，界面线程只负责排队
+// • 队列有上限，满时丢弃新提交的截图（报警截图宁可少存，也不能拖慢界面）
+// • 带key的截图（如每路摄像头的报警截图）按key合并：同一key尚未开始编码的截图被新截图替换，
+//   并按最小间隔限速，检测结果以10 Hz到达时也只按限速保存
+// • 图像必须持有自己的像素数据（隐式共享即可，不能引用帧池缓冲区）
+// • 也可以提交压缩的源数据（最近一组GOP）：在编码线程中解码出原始分辨率的最新画面再保存，
+//   界面线程只复制数据包引用，截图不受显示尺寸和子码流影响
+// • 带key的源数据（报警截图）只解码GOP开头的关键帧：多路高分辨率长GOP同时报警时解码整组跟不上，
+//   报警证据允许早于最新画面最多一个GOP；手动截图解码整组，取最新画面
+class SnapshotWriter : public QObject {
+    Q_OBJECT
+
+public:
+    // 队列统计
+    struct Stats {
+        int pending = 0;           // 排队中的截图
+        int running = 0;           // 正在编码的截图
+        quint64 written = 0;       // 累计保存成功
+        quint64 coalesced = 0;     // 累计被同一key的新截图替换
+        quint64 rateLimited = 0;   // 累计因限速丢弃
+        quint64 dropped = 0;       // 累计因队列已满丢弃
+    };
+
+    explicit SnapshotWriter(QObject* parent = nullptr);
+    ~SnapshotWriter();
+
+    // 提交截图（仅界面线程调用），quality为JPEG质量（-1为默认）
+    // key非空时同一key的截图合并并限速（两次接受间隔小于minIntervalMs时丢弃）；返回false表示未接受
+    bool submit(const QImage& image, const QString& fileName, int quality = -1,
+                const QString& key = QString(), int minIntervalMs = 0);
+    // 提交压缩的源数据，编码线程解码出最新一帧（带key时只解码关键帧）后保存（参数同上）
+    bool submit(const std::shared_ptr<PacketGop>& source, const QString& fileName, int quality = -1,
+                const QString& key = QString(), int minIntervalMs = 0);
+    Stats stats() const;
+
+signals:
+    // 截图保存完成（界面线程发出）
+    void snapshotSaved(const QString& fileName, bool success, const QString& key);
+
+private:
+    friend class SnapshotJob;
+    struct Job {
+        QString key;
+        QImage image;                  // 已解码的图像
+        std::shared_ptr<PacketGop> source; // 或压缩的源数据（image为空时使用）
+        QString fileName;
+        int quality;
+    };
+    static const int MaxPending = 16;  // 排队上限
+
+    bool enqueue(const Job& job, int minIntervalMs); // 限速、合并并排队
+    // 解码GOP，返回最后一帧；keyframeOnly时只解码开头的关键帧（编码线程调用）
+    static QImage decodeLatestFrame(const PacketGop& gop, bool keyframeOnly);
+    void startJobs();                  // 按空闲线程数启动排队中的任务
+    void onJobFinished(const QString& fileName, bool success, const QString& key);
+
+    QThreadPool m_pool;                // JPEG编码线程
+    QList<Job> m_pending;              // 排队中的任务（先进先出，仅界面线程访问）
+    int m_running;                     // 正在编码的任务数
+    QHash<QString, QElapsedTimer> m_lastAccepted; // key -> 上次接受的时间（限速）
+    Stats m_stats;
+};
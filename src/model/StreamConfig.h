@@ -0,0 +1,61 @@
+#pragma once
+#include <QMetaType>
+#include <QString>
+
+// 解码器线程模式
+enum class DecoderThreadType {
+    Frame = 0,  // 帧级多线程（吞吐量高，增加约thread_count帧的延迟；低延迟解码开启时改为片级）
+    Slice = 1   // 片级多线程（无额外延迟，需码流按多片编码才有效）
+};
+
+// 每路摄像头的解码器配置（与摄像头一起持久化，可在运行时修改）
+struct DecoderOptions {
+    int threadCount;                // 解码线程数（0表示自动：单线程解码，由解码引擎在各路之间并行）
+    DecoderThreadType threadType;   // 线程模式
+    bool skipLoopFilter;            // 跳过环路滤波（降低画质换取解码速度）
+    int lowres;                     // 低分辨率解码级别（0-关闭，1-1/2，2-1/4，仅部分解码器支持）
+
+    DecoderOptions() : threadCount(0), threadType(DecoderThreadType::Frame), skipLoopFilter(false), lowres(0) {}
+
+    bool operator==(const DecoderOptions& other) const {
+        return threadCount == other.threadCount && threadType == other.threadType
+               && skipLoopFilter == other.skipLoopFilter && lowres == other.lowres;
+    }
+    bool operator!=(const DecoderOptions& other) const { return !(*this == other); }
+};
+
+// 每路摄像头的RTSP打开参数（影响探测耗时和缓冲延迟）
+struct OpenOptions {
+    QString rtspTransport;          // 传输方式（"tcp"或"udp"）
+    int probeSize;                  // 探测数据量（字节）
+    int analyzeDurationMs;          // 探测时长（毫秒）
+    bool noBuffer;                  // fflags=nobuffer，不缓存探测阶段的数据包
+    bool lowDelay;                  // 解码器low_delay标志（开启时帧级多线程改为片级）
+    int maxDelayMs;                 // 最大解复用延迟（毫秒）
+    int reorderQueueSize;           // RTP乱序重排队列长度（-1表示使用FFmpeg默认值）
+    int timeoutMs;                  // 网络读写超时（毫秒）
+
+    OpenOptions()
+        : rtspTransport("tcp"), probeSize(500000), analyzeDurationMs(500), noBuffer(true), lowDelay(true),
+          maxDelayMs(500), reorderQueueSize(-1), timeoutMs(5000) {}
+
+    bool operator==(const OpenOptions& other) const {
+        return rtspTransport == other.rtspTransport && probeSize == other.probeSize
+               && analyzeDurationMs == other.analyzeDurationMs && noBuffer == other.noBuffer
+               && lowDelay == other.lowDelay && maxDelayMs == other.maxDelayMs
+               && reorderQueueSize == other.reorderQueueSize && timeoutMs == other.timeoutMs;
+    }
+    bool operator!=(const OpenOptions& other) const { return !(*this == other); }
+};
+
+// 连续录像参数（按摄像头开启，分段封装为MP4/MKV，不重新编码）
+struct RecordOptions {
+    int segmentSeconds;             // 每段时长（秒），在此后的第一个关键帧处切分
+    QString container;              // 封装格式（"mp4"或"mkv"）
+    qint64 quotaBytes;              // 录像目录的磁盘配额（字节），超过时删除最早的分段
+
+    RecordOptions() : segmentSeconds(300), container("mp4"), quotaBytes(20LL * 1024 * 1024 * 1024) {}
+};
+
+Q_DECLARE_METATYPE(DecoderOptions)
+Q_DECLARE_METATYPE(OpenOptions)
@@ -0,0 +1,400 @@
+#include "StreamRegistry.h"
+#include <QUrl>
+#include <QDir>
+#include <QDebug>
+
+StreamRegistry::StreamRegistry(QObject* parent)
+    : QObject(parent)
+{
+}
+
+StreamRegistry::~StreamRegistry()
+{
+    // 程序退出：先全部请求停止，各线程并行退出，再逐个等待
+    for (auto it = m_streams.begin(); it != m_streams.end(); ++it) {
+        it->model->stopStream();
+    }
+    for (Model* model : m_retiring) {
+        model->stopStream();
+    }
+    for (auto it = m_streams.begin(); it != m_streams.end(); ++it) {
+        it->model->wait();
+        if (it->owned) {
+            delete it->model;
+        }
+    }
+    for (Model* model : m_retiring) {
+        model->wait();
+        delete model;
+    }
+    // sink上下文对象是注册表的子对象，随注册表一起删除
+}
+
+QString StreamRegistry::normalizeUrl(const QString& url)
+{
+    QString trimmed = url.trimmed();
+    if (!trimmed.contains("://")) {
+        return QDir::cleanPath(trimmed); // 本地文件
+    }
+
+    QUrl parsed(trimmed);
+    if (!parsed.isValid()) {
+        return trimmed;
+    }
+    parsed.setScheme(parsed.scheme().toLower());
+    parsed.setHost(parsed.host().toLower());
+    if (parsed.scheme() == "rtsp" && parsed.port() == 554) {
+        parsed.setPort(-1); // RTSP默认端口
+    }
+    QString path = parsed.path();
+    while (path.length() > 1 && path.endsWith('/')) {
+        path.chop(1);
+    }
+    parsed.setPath(path);
+    return parsed.toString(QUrl::FullyEncoded);
+}
+
+Model* StreamRegistry::acquire(int sinkId, const QString& url, const OpenOptions& openOptions,
+                               const DecoderOptions& decoderOptions, Model* preferred, bool* shared)
+{
+    if (m_sinks.contains(sinkId)) {
+        release(sinkId);
+    }
+
+    QString key = normalizeUrl(url);
+    bool reused = false;
+    SharedStream& stream = obtainStream(key, url, openOptions, decoderOptions, preferred, &reused);
+    stream.sinks.append(sinkId);
+
+    SinkState sink;
+    sink.key = key;
+    sink.context = new QObject(this);
+    m_sinks.insert(sinkId, sink);
+    applySinkStates(key);
+
+    if (shared) {
+        *shared = reused;
+    }
+    return stream.model;
+}
+
+bool StreamRegistry::switchSource(int sinkId, const QString& url, const OpenOptions& openOptions,
+                                  const DecoderOptions& decoderOptions)
+{
+    auto sinkIt = m_sinks.find(sinkId);
+    if (sinkIt == m_sinks.end()) {
+        return false;
+    }
+    QString key = normalizeUrl(url);
+    if (key == sinkIt->pendingKey) {
+        return true; // 已在切换中
+    }
+
+    // 取消尚未完成的切换
+    QString oldPending = sinkIt->pendingKey;
+    sinkIt->pendingKey.clear();
+    if (!oldPending.isEmpty()) {
+        dropReference(oldPending, sinkId, true);
+    }
+    if (key == sinkIt->key) {
+        return true; // 切换回当前地址
+    }
+
+    // 先打开新地址，收到首帧（解码器总是从关键帧开始输出）后再释放旧地址，切换期间画面不中断
+    SharedStream& stream = obtainStream(key, url, openOptions, decoderOptions, nullptr, nullptr);
+    stream.pendingSinks.append(sinkId);
+    m_sinks[sinkId].pendingKey = key;
+    applySinkStates(key);
+    return true;
+}
+
+void StreamRegistry::release(int sinkId)
+{
+    auto sinkIt = m_sinks.find(sinkId);
+    if (sinkIt == m_sinks.end()) {
+        return;
+    }
+    QString key = sinkIt->key;
+    QString pendingKey = sinkIt->pendingKey;
+    QObject* context = sinkIt->context;
+    m_sinks.erase(sinkIt);
+
+    // 立即断开该sink的信号连接，上下文对象延迟删除（可能正处于其连接的槽函数中）
+    auto it = m_streams.find(key);
+    if (it != m_streams.end()) {
+        QObject::disconnect(it->model, nullptr, context, nullptr);
+    }
+    dropReference(key, sinkId, false);
+    if (!pendingKey.isEmpty()) {
+        dropReference(pendingKey, sinkId, true);
+    }
+    context->deleteLater();
+}
+
+StreamRegistry::SharedStream& StreamRegistry::obtainStream(const QString& key, const QString& url,
+                                                           const OpenOptions& openOptions,
+                                                           const DecoderOptions& decoderOptions,
+                                                           Model* preferred, bool* reused)
+{
+    auto it = m_streams.find(key);
+    if (reused) {
+        *reused = it != m_streams.end();
+    }
+    if (it == m_streams.end()) {
+        SharedStream stream;
+        // 调用方提供的Model仍在退出过程中时不能复用（线程会沿用旧的停止标志），改为新建
+        if (preferred && !preferred->isRunning()) {
+            stream.model = preferred;
+            stream.owned = false;
+        } else {
+            stream.model = new Model;
+            stream.owned = true;
+        }
+        stream.model->setOpenOptions(openOptions);
+        stream.model->setDecoderOptions(decoderOptions);
+        stream.model->resumeStream();
+        stream.model->startStream(url);
+        it = m_streams.insert(key, stream);
+    }
+    return it.value();
+}
+
+void StreamRegistry::dropReference(const QString& key, int sinkId, bool pending)
+{
+    auto it = m_streams.find(key);
+    if (it == m_streams.end()) {
+        return;
+    }
+    if (pending) {
+        it->pendingSinks.removeAll(sinkId);
+    } else {
+        it->sinks.removeAll(sinkId);
+    }
+    if (it->sinks.isEmpty() && it->pendingSinks.isEmpty()) {
+        releaseModel(*it);
+        m_streams.erase(it);
+    } else {
+        applySinkStates(key); // 剩余sink重新合并参数
+    }
+}
+
+void StreamRegistry::releaseAll()
+{
+    QList<int> sinkIds = m_sinks.keys();
+    for (int sinkId : sinkIds) {
+        release(sinkId);
+    }
+}
+
+Model* StreamRegistry::modelForSink(int sinkId) const
+{
+    auto sinkIt = m_sinks.constFind(sinkId);
+    if (sinkIt == m_sinks.constEnd()) {
+        return nullptr;
+    }
+    return m_streams.value(sinkIt->key).model;
+}
+
+Model* StreamRegistry::modelForUrl(const QString& url) const
+{
+    return m_streams.value(normalizeUrl(url)).model;
+}
+
+int StreamRegistry::shareCount(int sinkId) const
+{
+    auto sinkIt = m_sinks.constFind(sinkId);
+    if (sinkIt == m_sinks.constEnd()) {
+        return 0;
+    }
+    return m_streams.value(sinkIt->key).sinks.size();
+}
+
+QObject* StreamRegistry::sinkContext(int sinkId) const
+{
+    return m_sinks.value(sinkId).context;
+}
+
+void StreamRegistry::setSinkOutputSize(int sinkId, const QSize& size)
+{
+    auto sinkIt = m_sinks.find(sinkId);
+    if (sinkIt == m_sinks.end() || sinkIt->outputSize == size) {
+        return;
+    }
+    sinkIt->outputSize = size;
+    applySinkStatesForSink(*sinkIt);
+}
+
+void StreamRegistry::setSinkDecodePolicy(int sinkId, DecodePolicy policy, int interval)
+{
+    auto sinkIt = m_sinks.find(sinkId);
+    if (sinkIt == m_sinks.end()) {
+        return;
+    }
+    sinkIt->policy = policy;
+    sinkIt->interval = qMax(1, interval);
+    applySinkStatesForSink(*sinkIt);
+}
+
+void StreamRegistry::setSinkPaused(int sinkId, bool paused)
+{
+    auto sinkIt = m_sinks.find(sinkId);
+    if (sinkIt == m_sinks.end() || sinkIt->paused == paused) {
+        return;
+    }
+    sinkIt->paused = paused;
+    applySinkStatesForSink(*sinkIt);
+}
+
+bool StreamRegistry::isSinkPaused(int sinkId) const
+{
+    return m_sinks.value(sinkId).paused;
+}
+
+void StreamRegistry::pollFrames(const std::function<void(int sinkId, const FrameHandle& frame)>& deliver)
+{
+    // 先取出所有新帧，分发期间sink可能被释放（如界面回调中关闭视频流）
+    struct Delivery {
+        QString key;
+        FrameHandle frame;
+    };
+    QList<Delivery> deliveries;
+    for (auto it = m_streams.constBegin(); it != m_streams.constEnd(); ++it) {
+        Delivery delivery;
+        if (it->model->takeLatestFrame(delivery.frame)) {
+            delivery.key = it.key();
+            deliveries.append(delivery);
+        }
+    }
+
+    for (const Delivery& delivery : deliveries) {
+        // 切换中的sink收到新地址的首帧：完成切换，释放旧地址
+        auto it = m_streams.find(delivery.key);
+        if (it == m_streams.end()) {
+            continue;
+        }
+        const QList<int> pendingSinks = it->pendingSinks;
+        for (int sinkId : pendingSinks) {
+            promotePending(sinkId);
+        }
+
+        it = m_streams.find(delivery.key);
+        if (it == m_streams.end()) {
+            continue;
+        }
+        const QList<int> sinks = it->sinks;
+        for (int sinkId : sinks) {
+            auto sinkIt = m_sinks.constFind(sinkId);
+            if (sinkIt != m_sinks.constEnd() && !sinkIt->paused && sinkIt->key == delivery.key) {
+                deliver(sinkId, delivery.frame);
+            }
+        }
+    }
+}
+
+void StreamRegistry::promotePending(int sinkId)
+{
+    auto sinkIt = m_sinks.find(sinkId);
+    if (sinkIt == m_sinks.end() || sinkIt->pendingKey.isEmpty()) {
+        return;
+    }
+    QString oldKey = sinkIt->key;
+    QString newKey = sinkIt->pendingKey;
+    QObject* context = sinkIt->context;
+    sinkIt->key = newKey;
+    sinkIt->pendingKey.clear();
+
+    auto it = m_streams.find(newKey);
+    if (it == m_streams.end()) {
+        return;
+    }
+    it->pendingSinks.removeAll(sinkId);
+    it->sinks.append(sinkId);
+    Model* model = it->model;
+
+    // 旧解码器不再向该sink上报状态
+    auto oldIt = m_streams.find(oldKey);
+    if (oldIt != m_streams.end()) {
+        QObject::disconnect(oldIt->model, nullptr, context, nullptr);
+    }
+    dropReference(oldKey, sinkId, false);
+    applySinkStates(newKey);
+    emit sinkModelChanged(sinkId, model);
+}
+
+void StreamRegistry::applySinkStatesForSink(const SinkState& sink)
+{
+    QString key = sink.key;
+    QString pendingKey = sink.pendingKey;
+    applySinkStates(key);
+    if (!pendingKey.isEmpty()) {
+        applySinkStates(pendingKey); // 切换中的新地址同样生效
+    }
+}
+
+void StreamRegistry::applySinkStates(const QString& key)
+{
+    auto it = m_streams.find(key);
+    if (it == m_streams.end()) {
+        return;
+    }
+
+    bool allPaused = true;
+    bool nativeSize = false;
+    QSize outputSize(0, 0);
+    DecodePolicy policy = DecodePolicy::DemuxOnly;
+    int interval = 0;
+    const QList<int> sinks = it->sinks + it->pendingSinks; // 切换中的sink也按自己的参数准备新地址
+    for (int sinkId : sinks) {
+        const SinkState& sink = m_sinks[sinkId];
+        if (sink.paused) {
+            continue; // 暂停的sink不需要画面，不参与合并
+        }
+        allPaused = false;
+
+        // 枚举值越小要求越高（Full < EveryNth < KeyframesOnly < DemuxOnly）
+        if (static_cast<int>(sink.policy) < static_cast<int>(policy)) {
+            policy = sink.policy;
+        }
+        if (sink.policy == DecodePolicy::EveryNth) {
+            interval = interval > 0 ? qMin(interval, sink.interval) : sink.interval;
+        }
+        // 隐藏（只解复用）的sink的尺寸不影响输出
+        if (sink.policy != DecodePolicy::DemuxOnly) {
+            if (sink.outputSize.isValid() && !sink.outputSize.isEmpty()) {
+                outputSize = outputSize.expandedTo(sink.outputSize);
+            } else {
+                nativeSize = true;
+            }
+        }
+    }
+
+    Model* model = it->model;
+    if (allPaused) {
+        model->pauseStream();
+        return;
+    }
+    model->setDecodePolicy(policy, interval > 0 ? interval : 2);
+    model->setOutputSize(nativeSize || outputSize.isEmpty() ? QSize() : outputSize);
+    if (model->isPaused()) {
+        model->resumeStream();
+    }
+}
+
+void StreamRegistry::releaseModel(SharedStream& stream)
+{
+    Model* model = stream.model;
+    if (!stream.owned) {
+        model->stopStream(); // 调用方持有的Model只停止，不删除
+        return;
+    }
+    // 线程退出后再删除，界面线程不等待
+    m_retiring.insert(model);
+    connect(model, &QThread::finished, this, [this, model]() {
+        m_retiring.remove(model);
+        model->deleteLater();
+    });
+    model->stopStream();
+    if (!model->isRunning() && m_retiring.remove(model)) {
+        model->deleteLater(); // 线程未运行
+    }
+}
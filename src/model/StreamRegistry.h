@@ -0,0 +1,95 @@
+#pragma once
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QSize>
+#include <QString>
+#include <functional>
+#include "model.h"
+
+// 视频流注册表：按规范化URL共享解码器，同一摄像头只建立一个RTSP会话、只解码一次
+// • 每个显示端（sink，如多路视频块、绘框用的主画面）以唯一的sinkId引用共享的Model
+// • 各sink的输出尺寸、解码策略、暂停状态合并后作用于共享的Model：
+//   输出尺寸取最大值（任一sink要求原始分辨率时按原始分辨率），解码策略取要求最高的一个，全部暂停时才暂停解码
+// • 帧时钟每次只从共享Model取一帧，再分发给所有未暂停的sink
+// • 最后一个sink释放时异步停止并删除Model
+// • sink可在主码流/子码流间切换：先打开新地址，出首帧后再释放旧地址
+class StreamRegistry : public QObject {
+    Q_OBJECT
+
+public:
+    explicit StreamRegistry(QObject* parent = nullptr);
+    ~StreamRegistry();
+
+    // 规范化URL（协议和主机名小写、去除RTSP默认端口和末尾斜杠），作为共享的键
+    static QString normalizeUrl(const QString& url);
+
+    // 为sink获取url对应的共享解码器，不存在时创建并启动；sink已存在时先释放原来的引用
+    // preferred为调用方持有的空闲Model（如主画面的Model），新建时优先使用，注册表不负责删除它
+    // shared返回是否复用了已打开的视频流；打开参数和解码器配置只在新建时生效
+    Model* acquire(int sinkId, const QString& url, const OpenOptions& openOptions,
+                   const DecoderOptions& decoderOptions, Model* preferred = nullptr, bool* shared = nullptr);
+    // 将sink切换到另一个地址（如主码流/子码流）：新地址出首帧后才释放旧地址，期间继续显示旧画面
+    // 切换完成时发出sinkModelChanged信号；切换回当前地址会取消未完成的切换
+    bool switchSource(int sinkId, const QString& url, const OpenOptions& openOptions,
+                      const DecoderOptions& decoderOptions);
+    // 释放sink的引用
+    void release(int sinkId);
+    // 释放全部sink
+    void releaseAll();
+
+    Model* modelForSink(int sinkId) const;          // 获取sink使用的Model
+    Model* modelForUrl(const QString& url) const;   // 获取已打开该地址的Model（未打开时返回空）
+    int shareCount(int sinkId) const;               // 与该sink共享解码器的sink数量（含自身）
+    // sink的上下文对象：以它为接收者连接Model的信号，sink释放时自动断开
+    QObject* sinkContext(int sinkId) const;
+
+    // sink参数（合并后作用于共享的Model）
+    void setSinkOutputSize(int sinkId, const QSize& size);
+    void setSinkDecodePolicy(int sinkId, DecodePolicy policy, int interval = 2);
+    void setSinkPaused(int sinkId, bool paused);
+    bool isSinkPaused(int sinkId) const;
+
+    // 取出各共享解码器的最新帧并分发给其所有未暂停的sink（仅界面线程帧时钟调用）
+    void pollFrames(const std::function<void(int sinkId, const FrameHandle& frame)>& deliver);
+
+signals:
+    // sink切换地址完成，此后使用model（需重新连接该sink的Model信号）
+    void sinkModelChanged(int sinkId, Model* model);
+
+private:
+    // 共享的解码器
+    struct SharedStream {
+        Model* model = nullptr;
+        bool owned = true;         // 是否由注册表创建（释放时删除）
+        QList<int> sinks;          // 引用该解码器的sink
+        QList<int> pendingSinks;   // 正在切换到该解码器、等待首帧的sink
+    };
+    // 单个sink的状态
+    struct SinkState {
+        QString key;               // 共享解码器的键（规范化URL）
+        QString pendingKey;        // 正在切换到的解码器的键（为空表示未在切换）
+        QSize outputSize;          // 期望的输出尺寸（无效表示原始分辨率）
+        DecodePolicy policy = DecodePolicy::Full;
+        int interval = 2;          // EveryNth模式的输出间隔
+        bool paused = false;
+        QObject* context = nullptr;
+    };
+
+    // 获取key对应的共享解码器，不存在时创建并启动
+    SharedStream& obtainStream(const QString& key, const QString& url, const OpenOptions& openOptions,
+                               const DecoderOptions& decoderOptions, Model* preferred, bool* reused);
+    void dropReference(const QString& key, int sinkId, bool pending); // 释放sink对解码器的引用
+    void promotePending(int sinkId);          // 完成sink的切换
+    void applySinkStates(const QString& key); // 合并各sink参数并设置到共享的Model
+    void applySinkStatesForSink(const SinkState& sink); // 重新合并sink当前及切换中的解码器参数
+    void releaseModel(SharedStream& stream);  // 异步停止并删除（或仅停止）解码器
+
+    QHash<QString, SharedStream> m_streams;   // 规范化URL -> 共享解码器
+    QHash<int, SinkState> m_sinks;            // sinkId -> sink状态
+    QSet<Model*> m_retiring;                  // 已释放、等待线程退出后删除的解码器
+
+    StreamRegistry(const StreamRegistry&) = delete;
+    StreamRegistry& operator=(const StreamRegistry&) = delete;
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include <QString>
+#include <QMetaType>
+#include "ReconnectScheduler.h"
+
+// 解码线程累计计数器的一次采样（计数均为32位无符号，按差值计算速率，回绕不影响结果）
+struct StreamCounters {
+    quint32 packets;          // 已读取的视频包数
+    quint32 bytes;            // 已读取的视频数据字节数
+    quint32 decodedFrames;    // 已解码帧数
+    quint32 droppedFrames;    // 丢弃帧数（帧池耗尽或未显示即被新帧覆盖）
+    quint32 reconnects;       // 重连次数
+    int decodeTimeUs;         // 平均解码耗时（微秒）
+    int scaleTimeUs;          // 平均缩放转换耗时（微秒）
+
+    StreamCounters()
+        : packets(0), bytes(0), decodedFrames(0), droppedFrames(0), reconnects(0),
+          decodeTimeUs(0), scaleTimeUs(0) {}
+};
+
+// 视频流性能统计（由两次计数器采样计算得到）
+struct StreamStats {
+    double demuxRate;         // 解复用速率（包/秒）
+    double decodeFps;         // 解码帧率
+    double displayFps;        // 显示帧率
+    quint32 droppedFrames;    // 累计丢帧数
+    double decodeTimeMs;      // 平均解码耗时
+    double scaleTimeMs;       // 平均缩放转换耗时
+    double renderTimeMs;      // 平均界面渲染耗时（View::updateVideoFrame）
+    double bitrateKbps;       // 码率（kbit/s）
+    quint32 reconnectCount;   // 累计重连次数
+    StreamHealth health;      // 健康状态
+
+    StreamStats()
+        : demuxRate(0), decodeFps(0), displayFps(0), droppedFrames(0), decodeTimeMs(0),
+          scaleTimeMs(0), renderTimeMs(0), bitrateKbps(0), reconnectCount(0), health(StreamHealth::Idle) {}
+
+    // 根据前后两次采样和间隔计算统计值（界面相关字段由调用方填写）
+    static StreamStats fromCounters(const StreamCounters& current, const StreamCounters& previous, qint64 intervalMs) {
+        StreamStats stats;
+        double seconds = intervalMs > 0 ? intervalMs / 1000.0 : 1.0;
+        stats.demuxRate = static_cast<quint32>(current.packets - previous.packets) / seconds;
+        stats.decodeFps = static_cast<quint32>(current.decodedFrames - previous.decodedFrames) / seconds;
+        stats.bitrateKbps = static_cast<quint32>(current.bytes - previous.bytes) * 8.0 / 1000.0 / seconds;
+        stats.droppedFrames = current.droppedFrames;
+        stats.reconnectCount = current.reconnects;
+        stats.decodeTimeMs = current.decodeTimeUs / 1000.0;
+        stats.scaleTimeMs = current.scaleTimeUs / 1000.0;
+        return stats;
+    }
+
+    // 叠加显示用的多行文本
+    QString toDisplayText() const {
+        return QString("解复用 %1 包/s  码率 %2 kbps\n"
+                       "解码 %3 fps  显示 %4 fps  丢帧 %5\n"
+                       "解码 %6 ms  缩放 %7 ms  渲染 %8 ms\n"
+                       "重连 %9 次")
+            .arg(demuxRate, 0, 'f', 1).arg(bitrateKbps, 0, 'f', 0)
+            .arg(decodeFps, 0, 'f', 1).arg(displayFps, 0, 'f', 1).arg(droppedFrames)
+            .arg(decodeTimeMs, 0, 'f', 2).arg(scaleTimeMs, 0, 'f', 2).arg(renderTimeMs, 0, 'f', 2)
+            .arg(reconnectCount);
+    }
+};
+
+Q_DECLARE_METATYPE(StreamStats)
@@ -0,0 +1,313 @@
+#include "YuvConvert.h"
+#include <QtGlobal>
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+}
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define YUV_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define YUV_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+// 定点色彩转换系数（6位小数，保证16位乘加不溢出）
+struct YuvCoefficients {
+    int16_t yOffset;   // 亮度偏移（有限范围16，全范围0）
+    int16_t yCoef;     // 亮度系数
+    int16_t vr;        // V对R的系数
+    int16_t ug;        // U对G的系数
+    int16_t vg;        // V对G的系数
+    int16_t ub;        // U对B的系数
+};
+
+static const YuvCoefficients kBt601Limited = { 16, 75, 102, -25, -52, 129 };
+static const YuvCoefficients kBt709Limited = { 16, 75, 115, -14, -34, 135 };
+static const YuvCoefficients kBt601Full    = {  0, 64,  90, -22, -46, 113 };
+static const YuvCoefficients kBt709Full    = {  0, 64, 101, -12, -30, 119 };
+
+// 按帧的色彩空间和取值范围选择系数（未标注时与sws_scale一致按BT.601处理）
+static const YuvCoefficients& coefficientsFor(const AVFrame* frame)
+{
+    bool fullRange = frame->color_range == AVCOL_RANGE_JPEG || frame->format == AV_PIX_FMT_YUVJ420P;
+    bool bt709 = frame->colorspace == AVCOL_SPC_BT709;
+    if (bt709)
+        return fullRange ? kBt709Full : kBt709Limited;
+    return fullRange ? kBt601Full : kBt601Limited;
+}
+
+static inline uint8_t clampToByte(int value)
+{
+    return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// ============================================
+// 色彩转换内核：一行Y/U/V（已展开到输出宽度）-> B,G,R,0xFF
+// ============================================
+
+static void convertRowScalar(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                             uint8_t* dst, int width, const YuvCoefficients& c)
+{
+    for (int x = 0; x < width; ++x) {
+        int yy = (y[x] - c.yOffset) * c.yCoef + 32;
+        int uu = u[x] - 128;
+        int vv = v[x] - 128;
+        dst[4 * x + 0] = clampToByte((yy + uu * c.ub) >> 6);
+        dst[4 * x + 1] = clampToByte((yy + uu * c.ug + vv * c.vg) >> 6);
+        dst[4 * x + 2] = clampToByte((yy + vv * c.vr) >> 6);
+        dst[4 * x + 3] = 0xFF;
+    }
+}
+
+#if defined(YUV_SIMD_SSE2)
+static void convertRow(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                       uint8_t* dst, int width, const YuvCoefficients& c)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i yOffset = _mm_set1_epi16(c.yOffset);
+    const __m128i yCoef = _mm_set1_epi16(c.yCoef);
+    const __m128i uvOffset = _mm_set1_epi16(128);
+    const __m128i vr = _mm_set1_epi16(c.vr);
+    const __m128i ug = _mm_set1_epi16(c.ug);
+    const __m128i vg = _mm_set1_epi16(c.vg);
+    const __m128i ub = _mm_set1_epi16(c.ub);
+    const __m128i round = _mm_set1_epi16(32);
+    const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m128i yy = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + x)), zero);
+        __m128i uu = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + x)), zero);
+        __m128i vv = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + x)), zero);
+        yy = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(yy, yOffset), yCoef), round);
+        uu = _mm_sub_epi16(uu, uvOffset);
+        vv = _mm_sub_epi16(vv, uvOffset);
+
+        // 饱和加法：溢出的分量本身就会被截断到0或255
+        __m128i r = _mm_srai_epi16(_mm_adds_epi16(yy, _mm_mullo_epi16(vv, vr)), 6);
+        __m128i g = _mm_srai_epi16(_mm_adds_epi16(_mm_adds_epi16(yy, _mm_mullo_epi16(uu, ug)),
+                                                  _mm_mullo_epi16(vv, vg)), 6);
+        __m128i b = _mm_srai_epi16(_mm_adds_epi16(yy, _mm_mullo_epi16(uu, ub)), 6);
+
+        // 交织为B,G,R,A
+        __m128i bg = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), _mm_packus_epi16(g, g));
+        __m128i ra = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * x), _mm_unpacklo_epi16(bg, ra));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * x + 16), _mm_unpackhi_epi16(bg, ra));
+    }
+    convertRowScalar(y + x, u + x, v + x, dst + 4 * x, width - x, c);
+}
+#elif defined(YUV_SIMD_NEON)
+static void convertRow(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                       uint8_t* dst, int width, const YuvCoefficients& c)
+{
+    const int16x8_t yOffset = vdupq_n_s16(c.yOffset);
+    const int16x8_t yCoef = vdupq_n_s16(c.yCoef);
+    const int16x8_t uvOffset = vdupq_n_s16(128);
+    const int16x8_t vr = vdupq_n_s16(c.vr);
+    const int16x8_t ug = vdupq_n_s16(c.ug);
+    const int16x8_t vg = vdupq_n_s16(c.vg);
+    const int16x8_t ub = vdupq_n_s16(c.ub);
+    const int16x8_t round = vdupq_n_s16(32);
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        int16x8_t yy = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(y + x)));
+        int16x8_t uu = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(u + x))), uvOffset);
+        int16x8_t vv = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(v + x))), uvOffset);
+        yy = vaddq_s16(vmulq_s16(vsubq_s16(yy, yOffset), yCoef), round);
+
+        uint8x8x4_t bgra;
+        bgra.val[0] = vqmovun_s16(vshrq_n_s16(vqaddq_s16(yy, vmulq_s16(uu, ub)), 6));
+        bgra.val[1] = vqmovun_s16(vshrq_n_s16(vqaddq_s16(vqaddq_s16(yy, vmulq_s16(uu, ug)),
+                                                         vmulq_s16(vv, vg)), 6));
+        bgra.val[2] = vqmovun_s16(vshrq_n_s16(vqaddq_s16(yy, vmulq_s16(vv, vr)), 6));
+        bgra.val[3] = vdup_n_u8(0xFF);
+        vst4_u8(dst + 4 * x, bgra);
+    }
+    convertRowScalar(y + x, u + x, v + x, dst + 4 * x, width - x, c);
+}
+#else
+static void convertRow(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                       uint8_t* dst, int width, const YuvCoefficients& c)
+{
+    convertRowScalar(y, u, v, dst, width, c);
+}
+#endif
+
+// ============================================
+// 垂直混合：out = (row0 * (256 - frac) + row1 * frac) / 256，frac取1~255
+// ============================================
+
+static void blendRowsScalar(const uint8_t* row0, const uint8_t* row1, int frac, uint8_t* out, int width)
+{
+    const int inv = 256 - frac;
+    for (int x = 0; x < width; ++x)
+        out[x] = static_cast<uint8_t>((row0[x] * inv + row1[x] * frac + 128) >> 8);
+}
+
+#if defined(YUV_SIMD_SSE2)
+static void blendRows(const uint8_t* row0, const uint8_t* row1, int frac, uint8_t* out, int width)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i w0 = _mm_set1_epi16(static_cast<short>(256 - frac));
+    const __m128i w1 = _mm_set1_epi16(static_cast<short>(frac));
+    const __m128i round = _mm_set1_epi16(128);
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x));
+        // 按无符号16位计算，最大值255*256不会溢出
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), w0),
+                                                 _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), w1)), round);
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), w0),
+                                                 _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), w1)), round);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x),
+                         _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)));
+    }
+    blendRowsScalar(row0 + x, row1 + x, frac, out + x, width - x);
+}
+#elif defined(YUV_SIMD_NEON)
+static void blendRows(const uint8_t* row0, const uint8_t* row1, int frac, uint8_t* out, int width)
+{
+    const uint8x8_t w0 = vdup_n_u8(static_cast<uint8_t>(256 - frac));
+    const uint8x8_t w1 = vdup_n_u8(static_cast<uint8_t>(frac));
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        uint16x8_t sum = vmull_u8(vld1_u8(row0 + x), w0);
+        sum = vmlal_u8(sum, vld1_u8(row1 + x), w1);
+        vst1_u8(out + x, vrshrn_n_u16(sum, 8));
+    }
+    blendRowsScalar(row0 + x, row1 + x, frac, out + x, width - x);
+}
+#else
+static void blendRows(const uint8_t* row0, const uint8_t* row1, int frac, uint8_t* out, int width)
+{
+    blendRowsScalar(row0, row1, frac, out, width);
+}
+#endif
+
+// ============================================
+// YuvConverter
+// ============================================
+
+YuvConverter::YuvConverter()
+    : m_srcWidth(0), m_srcHeight(0), m_dstWidth(0), m_dstHeight(0)
+{
+}
+
+bool YuvConverter::isSupported(int pixelFormat)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    return pixelFormat == AV_PIX_FMT_YUV420P || pixelFormat == AV_PIX_FMT_YUVJ420P;
+#else
+    Q_UNUSED(pixelFormat);
+    return false; // 大端平台上字节序与Format_RGB32不一致，交给sws_scale处理
+#endif
+}
+
+const char* YuvConverter::simdName()
+{
+#if defined(YUV_SIMD_SSE2)
+    return "sse2";
+#elif defined(YUV_SIMD_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+// 计算一个方向上的采样坐标（像素中心对齐），保证左/上采样点+1仍在范围内
+static void buildAxis(QVector<int>& index, QVector<uint8_t>& frac, int srcSize, int dstSize)
+{
+    index.resize(dstSize);
+    frac.resize(dstSize);
+    for (int d = 0; d < dstSize; ++d) {
+        // pos = ((d + 0.5) * srcSize / dstSize - 0.5) * 256
+        qint64 pos = (static_cast<qint64>(2 * d + 1) * srcSize * 256) / (2 * dstSize) - 128;
+        pos = qBound<qint64>(0, pos, static_cast<qint64>(srcSize - 1) * 256);
+        int i = static_cast<int>(pos >> 8);
+        int f = static_cast<int>(pos & 255);
+        if (i >= srcSize - 1) {
+            i = srcSize - 2;
+            f = 255;
+        }
+        index[d] = i;
+        frac[d] = static_cast<uint8_t>(f);
+    }
+}
+
+void YuvConverter::buildMap(PlaneMap& map, int srcWidth, int srcHeight, int dstWidth, int dstHeight)
+{
+    map.srcWidth = srcWidth;
+    map.srcHeight = srcHeight;
+    buildAxis(map.xIndex, map.xFrac, srcWidth, dstWidth);
+    buildAxis(map.yIndex, map.yFrac, srcHeight, dstHeight);
+}
+
+bool YuvConverter::configure(int srcWidth, int srcHeight, int dstWidth, int dstHeight)
+{
+    if (srcWidth == m_srcWidth && srcHeight == m_srcHeight
+        && dstWidth == m_dstWidth && dstHeight == m_dstHeight)
+        return true;
+
+    // 色度平面至少需要2x2才能双线性插值
+    if (srcWidth < 4 || srcHeight < 4 || dstWidth <= 0 || dstHeight <= 0) {
+        m_srcWidth = m_srcHeight = m_dstWidth = m_dstHeight = 0;
+        return false;
+    }
+
+    buildMap(m_lumaMap, srcWidth, srcHeight, dstWidth, dstHeight);
+    buildMap(m_chromaMap, (srcWidth + 1) / 2, (srcHeight + 1) / 2, dstWidth, dstHeight);
+    m_blendRow.resize(srcWidth);
+    m_yRow.resize(dstWidth);
+    m_uRow.resize(dstWidth);
+    m_vRow.resize(dstWidth);
+
+    m_srcWidth = srcWidth;
+    m_srcHeight = srcHeight;
+    m_dstWidth = dstWidth;
+    m_dstHeight = dstHeight;
+    return true;
+}
+
+void YuvConverter::scaleRow(const PlaneMap& map, const uint8_t* plane, int stride, int dy, uint8_t* out)
+{
+    const uint8_t* row = plane + static_cast<ptrdiff_t>(map.yIndex[dy]) * stride;
+    int fy = map.yFrac[dy];
+    if (fy != 0) {
+        uint8_t* blended = m_blendRow.data();
+        blendRows(row, row + stride, fy, blended, map.srcWidth);
+        row = blended;
+    }
+
+    const int* xIndex = map.xIndex.constData();
+    const uint8_t* xFrac = map.xFrac.constData();
+    for (int dx = 0; dx < m_dstWidth; ++dx) {
+        int sx = xIndex[dx];
+        int fx = xFrac[dx];
+        out[dx] = static_cast<uint8_t>((row[sx] * (256 - fx) + row[sx + 1] * fx + 128) >> 8);
+    }
+}
+
+void YuvConverter::convert(const AVFrame* frame, uint8_t* dst, int dstStride)
+{
+    if (m_dstWidth <= 0 || frame->width != m_srcWidth || frame->height != m_srcHeight)
+        return;
+
+    const YuvCoefficients& c = coefficientsFor(frame);
+    uint8_t* yRow = m_yRow.data();
+    uint8_t* uRow = m_uRow.data();
+    uint8_t* vRow = m_vRow.data();
+    for (int dy = 0; dy < m_dstHeight; ++dy) {
+        scaleRow(m_lumaMap, frame->data[0], frame->linesize[0], dy, yRow);
+        scaleRow(m_chromaMap, frame->data[1], frame->linesize[1], dy, uRow);
+        scaleRow(m_chromaMap, frame->data[2], frame->linesize[2], dy, vRow);
+        convertRow(yRow, uRow, vRow, dst + static_cast<ptrdiff_t>(dy) * dstStride, m_dstWidth, c);
+    }
+}
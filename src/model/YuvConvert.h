@@ -0,0 +1,51 @@
+#pragma once
+#include <QVector>
+#include <cstdint>
+
+struct AVFrame;
+
+// YUV420P -> RGB32 缩放转换器：缩放与色彩转换融合为逐行处理，不产生中间帧
+// • 每个输出行：先垂直混合两行源数据，再按预计算的坐标表水平双线性插值
+// • 色彩转换使用SIMD内核（SSE2/NEON，不支持时退化为标量实现）
+// • 输出字节序为B,G,R,0xFF，与小端平台上的QImage::Format_RGB32一致，界面端无需再次转换
+// 仅支持YUV420P/YUVJ420P，其它像素格式由调用方回退到sws_scale
+class YuvConverter {
+public:
+    YuvConverter();
+
+    // 是否支持该源像素格式（AVPixelFormat）
+    static bool isSupported(int pixelFormat);
+    // 当前编译启用的SIMD指令集名称
+    static const char* simdName();
+
+    // 按源尺寸和目标尺寸准备坐标表和行缓冲区，尺寸未变化时直接返回
+    bool configure(int srcWidth, int srcHeight, int dstWidth, int dstHeight);
+    // 转换一帧到dst（dst须至少容纳dstHeight行，每行dstStride字节）
+    void convert(const AVFrame* frame, uint8_t* dst, int dstStride);
+
+private:
+    // 单个平面的缩放坐标表
+    struct PlaneMap {
+        int srcWidth = 0;
+        int srcHeight = 0;
+        QVector<int> xIndex;       // 输出列对应的源列（左侧采样点）
+        QVector<uint8_t> xFrac;    // 输出列的水平插值权重（0~255）
+        QVector<int> yIndex;       // 输出行对应的源行（上方采样点）
+        QVector<uint8_t> yFrac;    // 输出行的垂直插值权重（0~255）
+    };
+
+    static void buildMap(PlaneMap& map, int srcWidth, int srcHeight, int dstWidth, int dstHeight);
+    // 缩放平面中的第dy个输出行到out（长度为目标宽度）
+    void scaleRow(const PlaneMap& map, const uint8_t* plane, int stride, int dy, uint8_t* out);
+
+    int m_srcWidth;
+    int m_srcHeight;
+    int m_dstWidth;
+    int m_dstHeight;
+    PlaneMap m_lumaMap;            // 亮度平面坐标表
+    PlaneMap m_chromaMap;          // 色度平面坐标表（源尺寸为亮度的一半，输出按像素展开）
+    QVector<uint8_t> m_blendRow;   // 垂直混合后的源行
+    QVector<uint8_t> m_yRow;       // 缩放后的Y行
+    QVector<uint8_t> m_uRow;       // 缩放后的U行
+    QVector<uint8_t> m_vRow;       // 缩放后的V行
+};
@@ -1,4 +1,5 @@
 #include "model.h"
+#include <QDateTime>
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -7,8 +8,18 @@ extern "C" {
 }
 
 Model::Model(QObject* parent)
-    : QThread(parent), m_stop(false), pendingFrames(0)
+    : QThread(parent), m_stop(false), m_abortRequested(0),
+      m_health(static_cast<int>(StreamHealth::Idle)),
+      m_decoderOptionsChanged(0), m_decodeTimeUs(0), m_scaleTimeUs(0),
+      m_packetCount(0), m_byteCount(0), m_decodedFrameCount(0), m_droppedFrameCount(0), m_reconnectCount(0),
+      m_decodePolicy(static_cast<int>(DecodePolicy::Full)), m_decodeInterval(2),
+      m_resyncRequested(0), m_decoderFailed(0), m_framePool(4)
 {
+    qRegisterMetaType<FrameHandle>("FrameHandle"); // 注册池化帧句柄，用于跨线程信号
+    qRegisterMetaType<DecoderOptions>("DecoderOptions");
+    qRegisterMetaType<OpenOptions>("OpenOptions");
+    m_ioTimer.start(); // IO截止时间的时间基准
+    setStackSize(512 * 1024); // 线程只负责读包，解码在解码引擎中进行，不需要默认大小的栈
 }
 
 Model::~Model()
@@ -23,6 +34,7 @@ void Model::startStream(const QString& url)
     QMutexLocker locker(&m_mutex); // 加锁，保证线程安全
     m_url = url;                   // 设置RTSP流地址
     m_stop = false;                // 标记为未停止
+    m_abortRequested.storeRelease(0);
     if (!isRunning())              // 如果线程未运行，则启动线程
         start();
     else                           // 如果线程已在运行，则唤醒等待的线程
@@ -34,7 +46,38 @@ void Model::stopStream()
 {
     QMutexLocker locker(&m_mutex); // 加锁，保证线程安全
     m_stop = true;                 // 标记为停止
-    m_wait.wakeOne();              // 唤醒线程以便及时退出
+    m_abortRequested.storeRelease(1); // 中断正在阻塞的网络IO（打开、探测、读包）
+    m_wait.wakeAll();              // 唤醒暂停或重连等待中的线程以便及时退出
+}
+
+// FFmpeg阻塞IO的中断回调（在解码线程中调用）：请求停止或超过截止时间时返回1中断IO
+int Model::interruptCallback(void* opaque)
+{
+    Model* model = static_cast<Model*>(opaque);
+    if (model->m_abortRequested.loadAcquire())
+        return 1;
+    return (model->m_ioDeadlineMs >= 0 && model->m_ioTimer.elapsed() > model->m_ioDeadlineMs) ? 1 : 0;
+}
+
+// 设置下一次阻塞IO的截止时间
+void Model::armIoDeadline(int timeoutMs)
+{
+    m_ioDeadlineMs = m_ioTimer.elapsed() + qMax(1, timeoutMs);
+}
+
+// 取消IO截止时间
+void Model::disarmIoDeadline()
+{
+    m_ioDeadlineMs = -1;
+}
+
+// 可被stopStream()打断的等待，返回false表示已请求停止
+bool Model::sleepInterruptible(int ms)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_stop)
+        m_wait.wait(&m_mutex, static_cast<unsigned long>(ms));
+    return !m_stop;
 }
 
 // 暂停视频流
@@ -54,19 +97,60 @@ void Model::resumeStream()
 
 // 打开RTSP流，获取AVFormatContext
 bool Model::openStream(const QString& url, AVFormatContext*& fmt_ctx) {
-    // 尝试打开输入流
-    if (avformat_open_input(&fmt_ctx, url.toStdString().c_str(), nullptr, nullptr) != 0) {
-        emit frameReady(QImage()); // 打开失败，发送空帧
-        QThread::msleep(1000);     // 等待1秒后重试
+    OpenOptions options = openOptions();
+    
+    // 组装打开参数：减小探测量和缓冲以缩短首帧时间、降低延迟
+    AVDictionary* opts = nullptr;
+    if (url.startsWith("rtsp://", Qt::CaseInsensitive)) {
+        av_dict_set(&opts, "rtsp_transport", options.rtspTransport.toUtf8().constData(), 0);
+        if (options.reorderQueueSize >= 0)
+            av_dict_set_int(&opts, "reorder_queue_size", options.reorderQueueSize, 0);
+        // 网络超时（微秒），FFmpeg 5.0起stimeout更名为timeout
+#if LIBAVFORMAT_VERSION_MAJOR >= 59
+        av_dict_set_int(&opts, "timeout", static_cast<int64_t>(options.timeoutMs) * 1000, 0);
+#else
+        av_dict_set_int(&opts, "stimeout", static_cast<int64_t>(options.timeoutMs) * 1000, 0);
+#endif
+    }
+    if (options.probeSize > 0)
+        av_dict_set_int(&opts, "probesize", options.probeSize, 0);
+    if (options.analyzeDurationMs > 0)
+        av_dict_set_int(&opts, "analyzeduration", static_cast<int64_t>(options.analyzeDurationMs) * 1000, 0);
+    if (options.maxDelayMs >= 0)
+        av_dict_set_int(&opts, "max_delay", static_cast<int64_t>(options.maxDelayMs) * 1000, 0);
+    if (options.noBuffer)
+        av_dict_set(&opts, "fflags", "nobuffer", 0);
+    
+    // 开始计时，首帧解码后上报
+    m_openTimer.start();
+    m_firstFrameReported = false;
+    
+    // 预先分配上下文以注册中断回调，使打开过程可被stopStream()或超时打断
+    fmt_ctx = avformat_alloc_context();
+    if (!fmt_ctx) {
+        av_dict_free(&opts);
         return false;
     }
-    // 查找流信息
+    fmt_ctx->interrupt_callback.callback = &Model::interruptCallback;
+    fmt_ctx->interrupt_callback.opaque = this;
+    
+    // 尝试打开输入流（失败时FFmpeg会释放fmt_ctx）
+    armIoDeadline(options.timeoutMs);
+    int ret = avformat_open_input(&fmt_ctx, url.toStdString().c_str(), nullptr, &opts);
+    av_dict_free(&opts); // 释放未被使用的参数
+    if (ret != 0) {
+        disarmIoDeadline();
+        return false;              // 打开失败，由重连调度器决定何时重试
+    }
+    // 查找流信息（探测量和时长受probesize/analyzeduration限制）
+    armIoDeadline(options.timeoutMs + options.analyzeDurationMs);
     if (avformat_find_stream_info(fmt_ctx, nullptr) < 0) {
+        disarmIoDeadline();
         avformat_close_input(&fmt_ctx);
-        emit frameReady(QImage());
-        QThread::msleep(1000);
         return false;
     }
+    disarmIoDeadline();
+    m_openElapsedMs = m_openTimer.elapsed();
     return true;
 }
 
@@ -80,12 +164,29 @@ int Model::findVideoStream(AVFormatContext* fmt_ctx) {
     return -1; // 未找到视频流
 }
 
-// 打开解码器，获取AVCodecContext
-bool Model::openDecoder(AVFormatContext* fmt_ctx, int videoStream, AVCodecContext*& codec_ctx) {
-    AVCodecParameters* codecpar = fmt_ctx->streams[videoStream]->codecpar;
+// 按流参数打开解码器，获取AVCodecContext
+bool Model::openDecoder(const AVCodecParameters* codecpar, AVCodecContext*& codec_ctx) {
     const AVCodec* codec = avcodec_find_decoder(codecpar->codec_id); // 查找解码器
+    if (!codec)
+        return false;
     codec_ctx = avcodec_alloc_context3(codec);                 // 分配解码器上下文
     avcodec_parameters_to_context(codec_ctx, codecpar);        // 拷贝参数
+    
+    // 应用每路摄像头的解码器配置
+    DecoderOptions options = decoderOptions();
+    // 自动（0）时单线程解码：各路已由解码引擎并行，解码器内部再开线程只会增加线程数和延迟
+    codec_ctx->thread_count = options.threadCount > 0 ? options.threadCount : 1;
+    codec_ctx->thread_type = (options.threadType == DecoderThreadType::Slice) ? FF_THREAD_SLICE : FF_THREAD_FRAME;
+    codec_ctx->skip_loop_filter = options.skipLoopFilter ? AVDISCARD_ALL : AVDISCARD_DEFAULT;
+    codec_ctx->lowres = qBound(0, options.lowres, static_cast<int>(codec->max_lowres)); // 不支持的解码器max_lowres为0
+    if (openOptions().lowDelay) {
+        codec_ctx->flags |= AV_CODEC_FLAG_LOW_DELAY;           // 低延迟模式，不缓存待重排的帧
+        // FFmpeg在low_delay下会关闭帧级多线程，改用片级多线程，设置的线程数才能生效
+        if (codec_ctx->thread_count > 1 && codec_ctx->thread_type == FF_THREAD_FRAME) {
+            codec_ctx->thread_type = FF_THREAD_SLICE;
+        }
+    }
+    
     if (avcodec_open2(codec_ctx, codec, nullptr) < 0) {        // 打开解码器
         avcodec_free_context(&codec_ctx);
         return false;
@@ -93,56 +194,192 @@ bool Model::openDecoder(AVFormatContext* fmt_ctx, int videoStream, AVCodecContex
     return true;
 }
 
-// 读取并解码视频帧，转换为QImage并发送信号
-void Model::readAndDecodeFrames(AVFormatContext* fmt_ctx, AVCodecContext* codec_ctx, int videoStream) {
-    AVFrame* frame = av_frame_alloc();      // 原始帧
-    AVFrame* rgbFrame = av_frame_alloc();   // RGB帧
-    
-    // 检查帧分配是否成功
-    if (!frame || !rgbFrame) {
-        if (frame) av_frame_free(&frame);
-        if (rgbFrame) av_frame_free(&rgbFrame);
+// 取出最新解码帧（界面线程调用），没有新帧时返回false
+bool Model::takeLatestFrame(FrameHandle& frame)
+{
+    return m_mailbox.take(frame);
+}
+
+// 设置输出尺寸（视频标签的显示区域大小），解码线程在下一帧时按该尺寸直接缩放
+void Model::setOutputSize(const QSize& size)
+{
+    QMutexLocker locker(&m_mutex); // 加锁，保证线程安全
+    m_outputSize = size;
+}
+
+// 获取当前设置的输出尺寸
+QSize Model::outputSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_outputSize;
+}
+
+// 设置解码策略，解码线程在下一个数据包时生效
+void Model::setDecodePolicy(DecodePolicy policy, int interval)
+{
+    m_decodeInterval.storeRelease(qMax(1, interval));
+    m_decodePolicy.storeRelease(static_cast<int>(policy));
+}
+
+// 设置解码器配置，解码线程在下一个数据包前重建解码器
+void Model::setDecoderOptions(const DecoderOptions& options)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_decoderOptions == options)
         return;
+    m_decoderOptions = options;
+    m_decoderOptionsChanged.storeRelease(1);
+}
+
+// 获取解码器配置
+DecoderOptions Model::decoderOptions() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_decoderOptions;
+}
+
+// 设置RTSP打开参数，下次打开（或重连）时生效
+void Model::setOpenOptions(const OpenOptions& options)
+{
+    QMutexLocker locker(&m_mutex);
+    m_openOptions = options;
+}
+
+// 获取RTSP打开参数
+OpenOptions Model::openOptions() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_openOptions;
+}
+
+// 应用解码策略到解码器
+bool Model::applyDecodePolicy(AVCodecContext* codec_ctx, DecodePolicy oldPolicy, DecodePolicy newPolicy)
+{
+    // 解码器层面的丢帧：关键帧模式丢弃非关键帧，间隔模式丢弃不被参考的帧（不影响后续解码）
+    switch (newPolicy) {
+    case DecodePolicy::KeyframesOnly: codec_ctx->skip_frame = AVDISCARD_NONKEY; break;
+    case DecodePolicy::EveryNth:      codec_ctx->skip_frame = AVDISCARD_NONREF; break;
+    default:                          codec_ctx->skip_frame = AVDISCARD_DEFAULT; break;
     }
-    
-    // 创建图像转换上下文
-    SwsContext* sws_ctx = sws_getContext(codec_ctx->width, codec_ctx->height, codec_ctx->pix_fmt,
-                                         codec_ctx->width, codec_ctx->height, AV_PIX_FMT_RGB24,
-                                         SWS_BILINEAR, nullptr, nullptr, nullptr);
-    if (!sws_ctx) {
-        av_frame_free(&frame);
-        av_frame_free(&rgbFrame);
-        return;
+
+    // 从只解关键帧或不解码恢复时参考帧已缺失，清空解码器并从下一个关键帧开始，避免花屏
+    bool wasReduced = (oldPolicy == DecodePolicy::KeyframesOnly || oldPolicy == DecodePolicy::DemuxOnly);
+    bool isReduced = (newPolicy == DecodePolicy::KeyframesOnly || newPolicy == DecodePolicy::DemuxOnly);
+    if (wasReduced && !isReduced) {
+        avcodec_flush_buffers(codec_ctx);
+        return true;
     }
-    
-    int numBytes = av_image_get_buffer_size(AV_PIX_FMT_RGB24, codec_ctx->width, codec_ctx->height, 1);
-    uint8_t* buffer = (uint8_t*)av_malloc(numBytes * sizeof(uint8_t)); // 分配RGB缓冲区
-    if (!buffer) {
-        av_frame_free(&frame);
-        av_frame_free(&rgbFrame);
-        sws_freeContext(sws_ctx);
-        return;
+    return false;
+}
+
+// 按源帧尺寸和目标显示尺寸准备图像转换上下文及帧池
+bool Model::prepareOutput(const AVFrame* frame, SwsContext*& sws_ctx, YuvConverter& converter)
+{
+    if (frame->width <= 0 || frame->height <= 0)
+        return false;
+
+    // 保持纵横比缩放到显示区域内，且不超过源分辨率（未设置显示尺寸时输出原始分辨率）
+    QSize sourceSize(frame->width, frame->height);
+    QSize targetSize = sourceSize;
+    QSize displaySize = outputSize();
+    if (displaySize.width() > 0 && displaySize.height() > 0) {
+        targetSize = sourceSize.scaled(displaySize, Qt::KeepAspectRatio).boundedTo(sourceSize);
+        targetSize.setWidth(qMax(2, targetSize.width() & ~1));   // 宽高取偶数，便于色度采样对齐
+        targetSize.setHeight(qMax(2, targetSize.height() & ~1));
     }
-    
-    av_image_fill_arrays(rgbFrame->data, rgbFrame->linesize, buffer, AV_PIX_FMT_RGB24,
-                        codec_ctx->width, codec_ctx->height, 1);
+
+    // 输出RGB32，界面端QPixmap::fromImage无需再做一次色彩格式转换
+    // YUV420P走SIMD缩放转换内核，其它格式回退到sws_scale（AV_PIX_FMT_RGB32与Format_RGB32字节序一致）
+    if (YuvConverter::isSupported(frame->format)) {
+        if (!converter.configure(frame->width, frame->height, targetSize.width(), targetSize.height()))
+            return false;
+    } else {
+        // 源尺寸、像素格式或目标尺寸不变时返回缓存的上下文
+        sws_ctx = sws_getCachedContext(sws_ctx,
+                                       frame->width, frame->height, static_cast<AVPixelFormat>(frame->format),
+                                       targetSize.width(), targetSize.height(), AV_PIX_FMT_RGB32,
+                                       SWS_BILINEAR, nullptr, nullptr, nullptr);
+        if (!sws_ctx)
+            return false;
+    }
+
+    // 按目标尺寸分配帧池（尺寸未变化时复用）
+    return m_framePool.reset(targetSize.width(), targetSize.height(), QImage::Format_RGB32);
+}
+
+// 打开解码器并准备解码会话
+bool Model::beginDecodeSession(AVFormatContext* fmt_ctx, int videoStream)
+{
+    DecodeSession& session = m_session;
+    session.codecpar = avcodec_parameters_alloc();
+    session.frame = av_frame_alloc();
+    if (!session.codecpar || !session.frame
+        || avcodec_parameters_copy(session.codecpar, fmt_ctx->streams[videoStream]->codecpar) < 0
+        || !openDecoder(session.codecpar, session.codecCtx)) {
+        endDecodeSession();
+        return false;
+    }
+    // 新打开的解码器按Full状态起步，再切换到当前策略
+    session.policy = decodePolicy();
+    applyDecodePolicy(session.codecCtx, DecodePolicy::Full, session.policy);
+    session.waitKeyframe = false;
+    session.frameCounter = 0;
+    session.averageDecodeUs = 0.0;
+    session.averageScaleUs = 0.0;
+    session.reportTimer.start();
+    m_resyncRequested.storeRelease(0);
+    m_decoderFailed.storeRelease(0);
+    return true;
+}
+
+// 结束解码会话（解复用线程调用）
+void Model::endDecodeSession()
+{
+    // 返回后解码工作线程不会再执行本Model的切片
+    DecodeEngine::instance().cancel(this);
+
+    m_packetMutex.lock();
+    while (!m_packetQueue.isEmpty()) {
+        QueuedPacket queued = m_packetQueue.dequeue();
+        av_packet_free(&queued.packet);
+    }
+    m_packetMutex.unlock();
+
+    DecodeSession& session = m_session;
+    cleanup(nullptr, session.codecCtx, session.frame, session.swsCtx);
+    session.codecCtx = nullptr;
+    session.frame = nullptr;
+    session.swsCtx = nullptr;
+    avcodec_parameters_free(&session.codecpar);
+}
+
+// 读取视频包放入队列，由解码引擎的工作线程解码
+void Model::demuxPackets(AVFormatContext* fmt_ctx, int videoStream) {
     AVPacket pkt;
     int readResult = 0;
     
-    // 读取视频帧主循环
-    while (!m_stop) {
+    // 单次读包的超时时间，摄像头无响应时由中断回调打断
+    const int readTimeoutMs = openOptions().timeoutMs;
+    
+    // 读包主循环
+    while (!m_stop && !m_decoderFailed.loadAcquire()) {
+        armIoDeadline(readTimeoutMs);
         readResult = av_read_frame(fmt_ctx, &pkt);
+        disarmIoDeadline();
+        qint64 packetTimeNs = FrameHandle::monotonicNs(); // 读包时刻，用于统计端到端延迟
         
         // 如果读取失败（推流端断开或其他错误）
         if (readResult < 0) {
-            // 检查是否是EOF或连接断开
+            // 检查是否是EOF、连接断开、超时或被主动中断
             if (readResult == AVERROR_EOF || readResult == AVERROR(EIO) || 
-                readResult == AVERROR(EPIPE) || readResult == AVERROR(ECONNRESET)) {
+                readResult == AVERROR(EPIPE) || readResult == AVERROR(ECONNRESET) ||
+                readResult == AVERROR(ETIMEDOUT) || readResult == AVERROR_EXIT) {
                 // 流结束或连接断开，正常退出循环，准备重连
                 break;
             }
             // 其他错误，稍作延迟后继续尝试
-            QThread::msleep(100);
+            if (!sleepInterruptible(100))
+                break;
             continue;
         }
         
@@ -152,47 +389,185 @@ void Model::readAndDecodeFrames(AVFormatContext* fmt_ctx, AVCodecContext* codec_
         }
         m_mutex.unlock();
         
-        if (pkt.stream_index == videoStream) {
-            // 发送包到解码器
-            if (avcodec_send_packet(codec_ctx, &pkt) == 0) {
-                // 接收解码帧
-                while (avcodec_receive_frame(codec_ctx, frame) == 0) {
-                    // 转换为RGB格式
-                    sws_scale(sws_ctx, frame->data, frame->linesize, 0, codec_ctx->height,
-                              rgbFrame->data, rgbFrame->linesize);
-                    // 构造QImage并发送信号
-                    QImage img(rgbFrame->data[0], codec_ctx->width, codec_ctx->height,
-                               rgbFrame->linesize[0], QImage::Format_RGB888);
-
-                    // 控制事件队列中的QImage积压，如果渲染不及时直接丢帧，防止内存泄漏和卡顿
-                    if (pendingFrames.loadAcquire() < 3) {
-                        pendingFrames.fetchAndAddRelease(1);
-                        emit frameReady(img);
-                    }
-                }
+        // 只有视频包需要解码
+        if (pkt.stream_index != videoStream) {
+            av_packet_unref(&pkt);
+            continue;
+        }
+        
+        // 统计视频包数量和字节数（用于解复用速率和码率）
+        m_packetCount.fetchAndAddRelaxed(1);
+        m_byteCount.fetchAndAddRelaxed(static_cast<quint32>(pkt.size));
+        
+        // 放入预录缓冲（只增加引用计数），隐藏或不解码的流同样可以保存报警片段
+        m_packetBuffer.push(&pkt, packetTimeNs / 1000000);
+        
+        // 不解码模式只保持读取，不占用解码线程；恢复解码时解码端从关键帧开始
+        if (decodePolicy() == DecodePolicy::DemuxOnly) {
+            m_resyncRequested.storeRelease(1);
+            av_packet_unref(&pkt);
+            continue;
+        }
+        
+        // 移交数据包所有权到队列；解码跟不上时丢弃积压，从下一个关键帧恢复，避免延迟越积越大
+        QueuedPacket queued;
+        queued.packet = av_packet_alloc();
+        queued.timeNs = packetTimeNs;
+        if (!queued.packet) {
+            av_packet_unref(&pkt);
+            continue;
+        }
+        av_packet_move_ref(queued.packet, &pkt);
+        m_packetMutex.lock();
+        if (m_packetQueue.size() >= MaxQueuedPackets) {
+            while (!m_packetQueue.isEmpty()) {
+                QueuedPacket dropped = m_packetQueue.dequeue();
+                av_packet_free(&dropped.packet);
+                m_droppedFrameCount.fetchAndAddRelaxed(1);
             }
+            m_resyncRequested.storeRelease(1);
         }
-        av_packet_unref(&pkt); // 释放包
+        m_packetQueue.enqueue(queued);
+        m_packetMutex.unlock();
+        DecodeEngine::instance().schedule(this);
+    }
+}
+
+// 解码一段队列中的数据包（解码引擎工作线程调用）
+bool Model::runDecodeSlice()
+{
+    for (int i = 0; i < PacketsPerSlice; ++i) {
+        m_packetMutex.lock();
+        if (m_packetQueue.isEmpty()) {
+            m_packetMutex.unlock();
+            return false;
+        }
+        QueuedPacket queued = m_packetQueue.dequeue();
+        m_packetMutex.unlock();
         
-        m_mutex.lock();
-        if (m_stop) {
-            m_mutex.unlock();
-            break; // 如果需要停止，跳出循环
+        if (!m_decoderFailed.loadAcquire()) {
+            decodePacket(queued.packet, queued.timeNs);
         }
-        m_mutex.unlock();
+        av_packet_free(&queued.packet);
     }
+    QMutexLocker locker(&m_packetMutex);
+    return !m_packetQueue.isEmpty();
+}
+
+// 解码一个视频包，转换到帧池中的RGB缓冲区并投递到邮箱
+void Model::decodePacket(AVPacket* pkt, qint64 packetTimeNs) {
+    DecodeSession& session = m_session;
+    
+    // 解码器配置变化时只重建解码器，保留已建立的网络连接
+    if (m_decoderOptionsChanged.testAndSetAcquire(1, 0)) {
+        avcodec_free_context(&session.codecCtx);
+        if (!openDecoder(session.codecpar, session.codecCtx)) {
+            m_decoderFailed.storeRelease(1); // 解码器无法打开，由解复用线程按断线处理并重连
+            return;
+        }
+        applyDecodePolicy(session.codecCtx, DecodePolicy::Full, session.policy);
+        session.waitKeyframe = true; // 新解码器需要从关键帧开始
+        session.averageDecodeUs = 0.0;
+    }
+    AVCodecContext* codec_ctx = session.codecCtx;
+    
+    // 解码策略变化时更新解码器设置
+    DecodePolicy newPolicy = decodePolicy();
+    if (newPolicy != session.policy) {
+        if (applyDecodePolicy(codec_ctx, session.policy, newPolicy))
+            session.waitKeyframe = true;
+        session.policy = newPolicy;
+        session.frameCounter = 0;
+    }
+    DecodePolicy policy = session.policy;
     
-    // 释放帧和转换上下文等资源（注意：不在这里释放fmt_ctx和codec_ctx）
-    if (buffer) av_free(buffer);
-    if (rgbFrame) av_frame_free(&rgbFrame);
-    if (frame) av_frame_free(&frame);
-    if (sws_ctx) sws_freeContext(sws_ctx);
+    // 解复用端丢弃过数据包（不解码模式或积压），参考帧已缺失
+    if (m_resyncRequested.testAndSetAcquire(1, 0)) {
+        avcodec_flush_buffers(codec_ctx);
+        session.waitKeyframe = true;
+    }
+    
+    bool isKeyPacket = (pkt->flags & AV_PKT_FLAG_KEY) != 0;
+    if (session.waitKeyframe && isKeyPacket)
+        session.waitKeyframe = false;
+    
+    // 关键帧模式不送入非关键帧；恢复解码时等到关键帧再送入
+    bool sendToDecoder = policy != DecodePolicy::DemuxOnly
+                         && !(policy == DecodePolicy::KeyframesOnly && !isKeyPacket)
+                         && !session.waitKeyframe;
+    if (!sendToDecoder)
+        return;
+    
+    AVFrame* frame = session.frame;
+    QElapsedTimer decodeTimer;
+    QElapsedTimer scaleTimer;
+    
+    // 发送包到解码器
+    decodeTimer.start();
+    int sendResult = avcodec_send_packet(codec_ctx, pkt);
+    qint64 decodeNs = decodeTimer.nsecsElapsed();
+    if (sendResult == 0) {
+        // 接收解码帧
+        while (true) {
+            decodeTimer.restart();
+            int receiveResult = avcodec_receive_frame(codec_ctx, frame);
+            decodeNs += decodeTimer.nsecsElapsed();
+            if (receiveResult != 0)
+                break;
+            m_decodedFrameCount.fetchAndAddRelaxed(1);
+            // 间隔模式下只输出每N帧中的一帧，省去转换和界面绘制开销
+            if (policy == DecodePolicy::EveryNth
+                && (session.frameCounter++ % m_decodeInterval.loadAcquire()) != 0) {
+                continue;
+            }
+            // 按当前显示尺寸准备转换上下文和帧池
+            if (!prepareOutput(frame, session.swsCtx, session.converter)) {
+                continue;
+            }
+            // 从帧池获取空闲缓冲区；全部被占用说明渲染跟不上，直接丢帧，防止积压和卡顿
+            FrameHandle handle = m_framePool.acquire();
+            if (handle.isNull()) {
+                m_droppedFrameCount.fetchAndAddRelaxed(1);
+                continue;
+            }
+            // 直接缩放转换到池化缓冲区，界面端持有句柄期间该缓冲区不会被覆盖
+            uint8_t* dstData[4] = { handle.bits(), nullptr, nullptr, nullptr };
+            int dstLinesize[4] = { handle.bytesPerLine(), 0, 0, 0 };
+            scaleTimer.start();
+            if (YuvConverter::isSupported(frame->format)) {
+                session.converter.convert(frame, handle.bits(), handle.bytesPerLine());
+            } else {
+                sws_scale(session.swsCtx, frame->data, frame->linesize, 0, frame->height,
+                          dstData, dstLinesize);
+            }
+            double scaleUs = scaleTimer.nsecsElapsed() / 1000.0;
+            session.averageScaleUs = (session.averageScaleUs <= 0.0) ? scaleUs : session.averageScaleUs * 0.95 + scaleUs * 0.05;
+            m_scaleTimeUs.storeRelease(static_cast<int>(session.averageScaleUs));
+            handle.setTimestampNs(packetTimeNs);
+            // 投递到最新帧邮箱，界面线程按刷新节奏取走；覆盖了未显示的旧帧时计为丢帧
+            if (m_mailbox.publish(handle)) {
+                m_droppedFrameCount.fetchAndAddRelaxed(1);
+            }
+            if (!m_firstFrameReported) {
+                m_firstFrameReported = true;
+                setHealth(StreamHealth::Online);
+                emit firstFrameDecoded(m_openElapsedMs, m_openTimer.elapsed());
+            }
+        }
+    }
+    
+    // 更新平均解码耗时（指数滑动平均），定期上报
+    double sampleUs = decodeNs / 1000.0;
+    session.averageDecodeUs = (session.averageDecodeUs <= 0.0) ? sampleUs : session.averageDecodeUs * 0.95 + sampleUs * 0.05;
+    m_decodeTimeUs.storeRelease(static_cast<int>(session.averageDecodeUs));
+    if (session.reportTimer.elapsed() >= 2000) {
+        session.reportTimer.restart();
+        emit decodeTimeUpdated(session.averageDecodeUs / 1000.0);
+    }
 }
 
 // 释放所有相关资源
-void Model::cleanup(AVFormatContext* fmt_ctx, AVCodecContext* codec_ctx, AVFrame* frame, AVFrame* rgbFrame, uint8_t* buffer, SwsContext* sws_ctx) {
-    if (buffer) av_free(buffer);           // 释放RGB缓冲区
-    if (rgbFrame) av_frame_free(&rgbFrame);// 释放RGB帧
+void Model::cleanup(AVFormatContext* fmt_ctx, AVCodecContext* codec_ctx, AVFrame* frame, SwsContext* sws_ctx) {
     if (frame) av_frame_free(&frame);      // 释放原始帧
     if (codec_ctx) avcodec_free_context(&codec_ctx); // 释放解码器上下文
     if (fmt_ctx) avformat_close_input(&fmt_ctx);     // 关闭输入流
@@ -203,6 +578,8 @@ void Model::cleanup(AVFormatContext* fmt_ctx, AVCodecContext* codec_ctx, AVFrame
 void Model::run()
 {
     avformat_network_init(); // 初始化网络模块
+    ReconnectScheduler& scheduler = ReconnectScheduler::instance();
+    int attempt = 0;         // 连续失败次数（出画面后清零）
     while (true)
     {
         // 获取当前url和停止标志
@@ -212,50 +589,95 @@ void Model::run()
         m_mutex.unlock();
         if (stop)
             break; // 需要停止时退出主循环
-        AVFormatContext* fmt_ctx = nullptr;
+        
+        // 失败后按指数退避（含抖动）等待，避免所有摄像头同时重连
+        if (attempt > 0) {
+            int delayMs = scheduler.backoffDelayMs(attempt);
+            setHealth(StreamHealth::Backoff);
+            emit streamDisconnected(url, attempt, QDateTime::currentDateTime().addMSecs(delayMs));
+            if (!sleepInterruptible(delayMs))
+                break; // 等待期间请求停止
+            m_reconnectCount.fetchAndAddRelaxed(1);
+            emit streamReconnecting(url, attempt);
+        }
+        
+        // 获取打开许可，限制同时打开/探测的流数量
+        setHealth(StreamHealth::Connecting);
+        bool slotAcquired = false;
+        while (!(slotAcquired = scheduler.tryAcquireOpenSlot(100))) {
+            if (m_abortRequested.loadAcquire())
+                break;
+        }
+        if (!slotAcquired)
+            break;
+        
         // 打开流
-        if (!openStream(url, fmt_ctx))
+        AVFormatContext* fmt_ctx = nullptr;
+        bool opened = openStream(url, fmt_ctx);
+        scheduler.releaseOpenSlot();
+        if (!opened) {
+            m_mailbox.clear(); // 打开失败，清空邮箱中的旧帧
+            ++attempt;
             continue;
+        }
         // 查找视频流索引
         int videoStream = findVideoStream(fmt_ctx);
         if (videoStream == -1) {
-            cleanup(fmt_ctx, nullptr, nullptr, nullptr, nullptr, nullptr);
-            emit frameReady(QImage());
-            QThread::msleep(1000);
+            cleanup(fmt_ctx, nullptr, nullptr, nullptr);
+            m_mailbox.clear();
+            ++attempt;
             continue;
         }
         // 打开解码器
-        AVCodecContext* codec_ctx = nullptr;
-        if (!openDecoder(fmt_ctx, videoStream, codec_ctx)) {
-            cleanup(fmt_ctx, codec_ctx, nullptr, nullptr, nullptr, nullptr);
-            emit frameReady(QImage());
-            QThread::msleep(1000);
+        if (!beginDecodeSession(fmt_ctx, videoStream)) {
+            cleanup(fmt_ctx, nullptr, nullptr, nullptr);
+            m_mailbox.clear();
+            ++attempt;
             continue;
         }
-        // 读取并解码帧
-        readAndDecodeFrames(fmt_ctx, codec_ctx, videoStream);
+        // 读包并交给解码引擎解码；预录缓冲随每次打开重新开始（流参数可能变化）
+        m_packetBuffer.begin(fmt_ctx->streams[videoStream]);
+        demuxPackets(fmt_ctx, videoStream);
+        m_packetBuffer.end();
         
-        // 释放资源（fmt_ctx和codec_ctx在这里释放）
-        if (codec_ctx) avcodec_free_context(&codec_ctx);
+        // 等待解码切片结束后释放解码器，再关闭输入流
+        // 关闭时的RTSP TEARDOWN同样受截止时间约束，已请求停止时立即中断
+        endDecodeSession();
+        armIoDeadline(500);
         if (fmt_ctx) avformat_close_input(&fmt_ctx);
+        disarmIoDeadline();
         
         // 检查是否需要停止
         m_mutex.lock();
         bool shouldStop = m_stop;
-        QString currentUrl = m_url;
         m_mutex.unlock();
         
         if (shouldStop) {
             break; // 如果需要停止，退出主循环
         }
         
-        // 如果不是主动停止，说明是连接断开
-        emit streamDisconnected(currentUrl);
-        
-        // 等待一段时间后尝试重连
-        QThread::msleep(2000); // 等待2秒后重连
-        
-        // 发出重连信号
-        emit streamReconnecting(currentUrl);
+        // 不是主动停止，说明是连接断开：出过画面则从第1次重试开始，否则继续累加
+        attempt = m_firstFrameReported ? 1 : attempt + 1;
     }
-} 
\ No newline at end of file
+    setHealth(StreamHealth::Idle);
+}
+
+// 获取累计性能计数器（任意线程调用）
+StreamCounters Model::counters() const
+{
+    StreamCounters counters;
+    counters.packets = m_packetCount.loadAcquire();
+    counters.bytes = m_byteCount.loadAcquire();
+    counters.decodedFrames = m_decodedFrameCount.loadAcquire();
+    counters.droppedFrames = m_droppedFrameCount.loadAcquire();
+    counters.reconnects = m_reconnectCount.loadAcquire();
+    counters.decodeTimeUs = m_decodeTimeUs.loadAcquire();
+    counters.scaleTimeUs = m_scaleTimeUs.loadAcquire();
+    return counters;
+}
+
+// 更新健康状态
+void Model::setHealth(StreamHealth health)
+{
+    m_health.storeRelease(static_cast<int>(health));
+}
@@ -5,6 +5,18 @@
 #include <QMutex>
 #include <QWaitCondition>
 #include <QAtomicInt>
+#include <QSize>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QQueue>
+#include "DecodeEngine.h"
+#include "FramePool.h"
+#include "FrameMailbox.h"
+#include "PacketRingBuffer.h"
+#include "StreamConfig.h"
+#include "ReconnectScheduler.h"
+#include "StreamStats.h"
+#include "YuvConvert.h"
 
 extern "C" {
 #include <libavcodec/avcodec.h>
@@ -13,7 +25,16 @@ extern "C" {
 #include <libswscale/swscale.h>
 }
 
-class Model : public QThread {
+// 解码策略：根据画面是否可见、布局大小降低解码开销
+enum class DecodePolicy {
+    Full,           // 全部解码并输出
+    EveryNth,       // 跳过非参考帧，且每N帧输出一帧
+    KeyframesOnly,  // 只解码关键帧
+    DemuxOnly       // 只接收数据保持连接，不解码（恢复时等待关键帧）
+};
+
+// 视频流：每路一个解复用线程（阻塞读包、断线重连），解码和图像转换交给共享的解码引擎
+class Model : public QThread, public DecodeJob {
     Q_OBJECT
 
 public:
@@ -24,30 +45,121 @@ public:
     void pauseStream();                        // 暂停视频流
     void resumeStream();                       // 恢复视频流
     bool isPaused() const { return m_pause; }  // 获取暂停状态
-    QAtomicInt pendingFrames; // 用于检测积压的帧数
+    StreamHealth health() const { return static_cast<StreamHealth>(m_health.loadAcquire()); } // 获取健康状态
+    bool takeLatestFrame(FrameHandle& frame);  // 取出最新解码帧（仅界面线程轮询调用），没有新帧时返回false
+    void setOutputSize(const QSize& size);     // 设置输出尺寸（显示区域大小），解码端直接缩放到该尺寸
+    QSize outputSize() const;                  // 获取输出尺寸
+    // 设置解码策略，interval为EveryNth模式下的输出间隔（每interval帧输出一帧）
+    void setDecodePolicy(DecodePolicy policy, int interval = 2);
+    DecodePolicy decodePolicy() const { return static_cast<DecodePolicy>(m_decodePolicy.loadAcquire()); }
+    // 设置解码器配置（线程数、线程模式等），运行中修改时只重建解码器，不断开流
+    void setDecoderOptions(const DecoderOptions& options);
+    DecoderOptions decoderOptions() const;
+    // 设置RTSP打开参数（传输方式、探测大小等），下次打开流时生效
+    void setOpenOptions(const OpenOptions& options);
+    OpenOptions openOptions() const;
+    // 获取平均解码耗时（微秒，指数滑动平均，包含送包和取帧）
+    int averageDecodeTimeUs() const { return m_decodeTimeUs.loadAcquire(); }
+    // 获取累计性能计数器（包数、字节数、解码帧数、丢帧数、重连次数及平均耗时）
+    StreamCounters counters() const;
+    // 压缩数据包预录缓冲（最近一段时间的视频包，不解码时同样保存），用于报警片段
+    PacketRingBuffer& packetBuffer() { return m_packetBuffer; }
 
 signals:
-    void frameReady(const QImage& img);        // 视频帧准备好时发出信号，传递QImage
-    void streamDisconnected(const QString& url); // 视频流断开信号
-    void streamReconnecting(const QString& url); // 视频流重连信号
+    // 视频流断开（或连接失败）信号，attempt为连续失败次数，nextRetry为下次重试时间
+    void streamDisconnected(const QString& url, int attempt, const QDateTime& nextRetry);
+    void streamReconnecting(const QString& url, int attempt); // 视频流开始第attempt次重连信号
+    void decodeTimeUpdated(double averageMs);    // 平均解码耗时更新信号（毫秒，定期发出）
+    void firstFrameDecoded(qint64 openMs, qint64 firstFrameMs); // 每次打开流后的首帧耗时（打开+探测耗时，首帧总耗时）
 
 protected:
-    void run() override;                       // 线程主函数，处理视频流解码
+    void run() override;                       // 线程主函数，打开视频流并读包
 
 private:
+    // FFmpeg阻塞IO中断回调，请求停止或超过截止时间时中断
+    static int interruptCallback(void* opaque);
+    void armIoDeadline(int timeoutMs);         // 设置下一次阻塞IO的截止时间
+    void disarmIoDeadline();                   // 取消IO截止时间
+    bool sleepInterruptible(int ms);           // 可被stopStream()打断的等待，返回false表示已请求停止
+    void setHealth(StreamHealth health);       // 更新健康状态
     // 打开RTSP流，获取AVFormatContext
     bool openStream(const QString& url, AVFormatContext*& fmt_ctx);
     // 查找视频流索引
     int findVideoStream(AVFormatContext* fmt_ctx);
-    // 打开解码器，获取AVCodecContext
-    bool openDecoder(AVFormatContext* fmt_ctx, int videoStream, AVCodecContext*& codec_ctx);
-    // 读取并解码视频帧，转换为QImage并发送信号
-    void readAndDecodeFrames(AVFormatContext* fmt_ctx, AVCodecContext* codec_ctx, int videoStream);
+    // 按流参数打开解码器，获取AVCodecContext
+    bool openDecoder(const AVCodecParameters* codecpar, AVCodecContext*& codec_ctx);
+    // 按源帧和输出尺寸准备图像转换上下文（YUV420P快速路径或sws_scale）及帧池
+    bool prepareOutput(const AVFrame* frame, SwsContext*& sws_ctx, YuvConverter& converter);
+    // 应用解码策略到解码器，返回恢复解码时是否需要等待关键帧
+    bool applyDecodePolicy(AVCodecContext* codec_ctx, DecodePolicy oldPolicy, DecodePolicy newPolicy);
+    // 打开解码器并准备解码会话（解复用线程调用，会话开始前工作线程不会访问会话状态）
+    bool beginDecodeSession(AVFormatContext* fmt_ctx, int videoStream);
+    // 结束解码会话：等待正在执行的解码切片结束，清空包队列并释放解码器
+    void endDecodeSession();
+    // 读取视频包放入队列并调度解码（解复用线程），断线、停止或解码器失败时返回
+    void demuxPackets(AVFormatContext* fmt_ctx, int videoStream);
+    // 解码一段队列中的数据包（解码引擎工作线程调用），返回队列中是否还有数据包
+    bool runDecodeSlice() override;
+    // 解码一个数据包，转换到帧池缓冲区并投递到邮箱；修改解码器配置时会重建解码器
+    void decodePacket(AVPacket* pkt, qint64 packetTimeNs);
     // 释放所有相关资源
-    void cleanup(AVFormatContext* fmt_ctx, AVCodecContext* codec_ctx, AVFrame* frame, AVFrame* rgbFrame, uint8_t* buffer, SwsContext* sws_ctx);
+    void cleanup(AVFormatContext* fmt_ctx, AVCodecContext* codec_ctx, AVFrame* frame, SwsContext* sws_ctx);
+
+    // 队列中待解码的数据包
+    struct QueuedPacket {
+        AVPacket* packet;
+        qint64 timeNs;                     // 读包时刻（单调时钟），用于统计端到端延迟
+    };
+    // 解码会话：一次打开流期间的解码器及转换状态，只在解码工作线程中访问（同一时刻只有一个）
+    struct DecodeSession {
+        AVCodecParameters* codecpar = nullptr; // 视频流参数副本，重建解码器时使用
+        AVCodecContext* codecCtx = nullptr;
+        AVFrame* frame = nullptr;          // 解码输出帧
+        SwsContext* swsCtx = nullptr;      // 非YUV420P源的转换上下文，按输出尺寸自动重建
+        YuvConverter converter;            // YUV420P快速转换路径
+        DecodePolicy policy = DecodePolicy::Full; // 当前生效的解码策略
+        bool waitKeyframe = false;         // 是否需要等待关键帧才能继续解码
+        int frameCounter = 0;              // 间隔模式下的帧计数
+        double averageDecodeUs = 0.0;      // 解码耗时滑动平均
+        double averageScaleUs = 0.0;       // 转换耗时滑动平均
+        QElapsedTimer reportTimer;         // 解码耗时上报计时
+    };
+    static const int MaxQueuedPackets = 120; // 包队列上限（约4秒），解码跟不上时丢弃积压从关键帧恢复
+    static const int PacketsPerSlice = 8;    // 每个解码切片最多处理的包数，保证各路轮流解码
+
     QString m_url;             // RTSP流地址
     bool m_stop;               // 停止标志
     bool m_pause = false;      // 暂停标志
-    QMutex m_mutex;            // 互斥锁，保证多线程安全
+    QAtomicInt m_abortRequested; // 中断请求标志（由stopStream()设置，中断回调读取）
+    QAtomicInt m_health;       // 健康状态（StreamHealth）
+    QElapsedTimer m_ioTimer;   // IO截止时间的时间基准
+    qint64 m_ioDeadlineMs = -1; // 当前阻塞IO的截止时间（仅解复用线程访问，-1表示不限）
+    mutable QMutex m_mutex;    // 互斥锁，保证多线程安全
     QWaitCondition m_wait;     // 条件变量，用于线程等待和唤醒
+    QSize m_outputSize;        // 输出尺寸（无效时按源分辨率输出）
+    OpenOptions m_openOptions;       // RTSP打开参数（受m_mutex保护）
+    // 打开计时和首帧标志：解复用线程在beginDecodeSession之前写入，之后才调度解码切片，
+    // 解码引擎工作线程读取时无需加锁；首帧标志由工作线程写入，解复用线程在endDecodeSession等待切片结束后读取
+    QElapsedTimer m_openTimer;       // 本次打开流的计时
+    qint64 m_openElapsedMs = 0;      // 本次打开和探测流的耗时
+    bool m_firstFrameReported = false; // 本次打开后是否已上报首帧耗时
+    DecoderOptions m_decoderOptions; // 解码器配置（受m_mutex保护）
+    QAtomicInt m_decoderOptionsChanged; // 解码器配置已修改，需要重建解码器
+    QAtomicInt m_decodeTimeUs; // 平均解码耗时（微秒）
+    QAtomicInt m_scaleTimeUs;  // 平均缩放转换耗时（微秒）
+    QAtomicInteger<quint32> m_packetCount;       // 累计视频包数
+    QAtomicInteger<quint32> m_byteCount;         // 累计视频字节数
+    QAtomicInteger<quint32> m_decodedFrameCount; // 累计解码帧数
+    QAtomicInteger<quint32> m_droppedFrameCount; // 累计丢帧数
+    QAtomicInteger<quint32> m_reconnectCount;    // 累计重连次数
+    QAtomicInt m_decodePolicy; // 解码策略（DecodePolicy）
+    QAtomicInt m_decodeInterval; // EveryNth模式的输出间隔
+    DecodeSession m_session;   // 解码会话（解码工作线程访问）
+    QMutex m_packetMutex;      // 保护包队列
+    QQueue<QueuedPacket> m_packetQueue; // 待解码的数据包（解复用线程入队，解码工作线程取出）
+    QAtomicInt m_resyncRequested; // 解复用端丢弃过数据包，解码端需清空解码器并从关键帧恢复
+    QAtomicInt m_decoderFailed;   // 解码器重建失败，解复用线程按断线处理
+    FramePool m_framePool;     // RGB帧池（仅解码工作线程分配，句柄释放后自动归还）
+    FrameMailbox m_mailbox;    // 最新帧邮箱（解码线程投递，界面线程轮询取走）
+    PacketRingBuffer m_packetBuffer; // 视频包预录缓冲（解复用线程写入）
 }; 
@@ -78,6 +78,15 @@ void AddCameraDialog::setupUI() {
   urlLabel->setStyleSheet("font-weight: bold; color: #333333;");
   formLayout->addRow(urlLabel, rtspUrlLineEdit);
 
+  // 子码流地址（多画面布局时自动切换到子码流，降低解码负载）
+  subRtspUrlLineEdit = new QLineEdit(this);
+  subRtspUrlLineEdit->setMinimumHeight(30);
+  subRtspUrlLineEdit->setPlaceholderText("子码流地址（可选）");
+
+  QLabel *subUrlLabel = new QLabel("子码流地址:", this);
+  subUrlLabel->setStyleSheet("font-weight: bold; color: #333333;");
+  formLayout->addRow(subUrlLabel, subRtspUrlLineEdit);
+
   // 3. 摄像头名称输入
   cameraNameLineEdit = new QLineEdit(this);
   cameraNameLineEdit->setMinimumHeight(30);
@@ -92,11 +101,16 @@ void AddCameraDialog::setupUI() {
 
   mainLayout->addLayout(formLayout);
 
+  // 4. 连接参数（影响首帧时间和延迟）
+  mainLayout->addWidget(createOpenOptionsGroup());
+  setOpenOptions(OpenOptions());
+
   // 添加提示信息
   QLabel *hintLabel =
       new QLabel("提示：\n"
-                 "• 摄像头位置对应显示网格中的位置编号（1-16）\n"
+                 "• 摄像头位置对应显示网格中的位置编号，超过一屏时翻页显示\n"
                  "• RTSP地址格式：rtsp://用户名:密码@IP地址:端口/路径\n"
+                 "• 填写子码流地址后，9/16画面时自动使用子码流，全屏或选中时切回主码流\n"
                  "• 摄像头名称可自定义，留空则使用默认名称",
                  this);
   hintLabel->setStyleSheet("QLabel {"
@@ -215,10 +229,93 @@ void AddCameraDialog::setupUI() {
                 "}");
 }
 
+QGroupBox *AddCameraDialog::createOpenOptionsGroup() {
+  QGroupBox *group = new QGroupBox("连接参数", this);
+  group->setCheckable(true);
+  group->setChecked(false); // 默认折叠，高级用户展开调整
+  QFormLayout *optionsLayout = new QFormLayout();
+  optionsLayout->setSpacing(8);
+  optionsLayout->setLabelAlignment(Qt::AlignRight | Qt::AlignVCenter);
+
+  transportComboBox = new QComboBox(group);
+  transportComboBox->addItem("TCP（稳定）", "tcp");
+  transportComboBox->addItem("UDP（低延迟，可能丢包）", "udp");
+  optionsLayout->addRow("传输方式:", transportComboBox);
+
+  probeSizeSpinBox = new QSpinBox(group);
+  probeSizeSpinBox->setRange(32, 10240);
+  probeSizeSpinBox->setSuffix(" KB");
+  optionsLayout->addRow("探测数据量:", probeSizeSpinBox);
+
+  analyzeDurationSpinBox = new QSpinBox(group);
+  analyzeDurationSpinBox->setRange(0, 10000);
+  analyzeDurationSpinBox->setSingleStep(100);
+  analyzeDurationSpinBox->setSuffix(" ms");
+  optionsLayout->addRow("探测时长:", analyzeDurationSpinBox);
+
+  maxDelaySpinBox = new QSpinBox(group);
+  maxDelaySpinBox->setRange(0, 5000);
+  maxDelaySpinBox->setSingleStep(100);
+  maxDelaySpinBox->setSuffix(" ms");
+  optionsLayout->addRow("最大延迟:", maxDelaySpinBox);
+
+  reorderQueueSpinBox = new QSpinBox(group);
+  reorderQueueSpinBox->setRange(-1, 1000);
+  reorderQueueSpinBox->setSpecialValueText("默认");
+  optionsLayout->addRow("重排队列:", reorderQueueSpinBox);
+
+  timeoutSpinBox = new QSpinBox(group);
+  timeoutSpinBox->setRange(1, 60);
+  timeoutSpinBox->setSuffix(" 秒");
+  optionsLayout->addRow("网络超时:", timeoutSpinBox);
+
+  noBufferCheckBox = new QCheckBox("不缓存探测数据（nobuffer）", group);
+  optionsLayout->addRow("", noBufferCheckBox);
+  lowDelayCheckBox = new QCheckBox("低延迟解码（low_delay）", group);
+  lowDelayCheckBox->setToolTip("开启后解码设置中的帧级多线程会改为片级多线程"
+                               "（FFmpeg在low_delay下不支持帧级多线程）");
+  optionsLayout->addRow("", lowDelayCheckBox);
+
+  // 折叠时隐藏参数控件
+  QWidget *optionsWidget = new QWidget(group);
+  optionsWidget->setLayout(optionsLayout);
+  optionsWidget->setVisible(false);
+  QVBoxLayout *groupLayout = new QVBoxLayout(group);
+  groupLayout->addWidget(optionsWidget);
+  connect(group, &QGroupBox::toggled, optionsWidget, &QWidget::setVisible);
+  return group;
+}
+
+OpenOptions AddCameraDialog::getOpenOptions() const {
+  OpenOptions options;
+  options.rtspTransport = transportComboBox->currentData().toString();
+  options.probeSize = probeSizeSpinBox->value() * 1024;
+  options.analyzeDurationMs = analyzeDurationSpinBox->value();
+  options.noBuffer = noBufferCheckBox->isChecked();
+  options.lowDelay = lowDelayCheckBox->isChecked();
+  options.maxDelayMs = maxDelaySpinBox->value();
+  options.reorderQueueSize = reorderQueueSpinBox->value();
+  options.timeoutMs = timeoutSpinBox->value() * 1000;
+  return options;
+}
+
+void AddCameraDialog::setOpenOptions(const OpenOptions &options) {
+  transportComboBox->setCurrentIndex(
+      qMax(0, transportComboBox->findData(options.rtspTransport)));
+  probeSizeSpinBox->setValue(options.probeSize / 1024);
+  analyzeDurationSpinBox->setValue(options.analyzeDurationMs);
+  noBufferCheckBox->setChecked(options.noBuffer);
+  lowDelayCheckBox->setChecked(options.lowDelay);
+  maxDelaySpinBox->setValue(options.maxDelayMs);
+  reorderQueueSpinBox->setValue(options.reorderQueueSize);
+  timeoutSpinBox->setValue(options.timeoutMs / 1000);
+}
+
 void AddCameraDialog::onCameraIdChanged(int index) {
   if (index >= 0 && index < availableCameraIds.size()) {
     selectedCameraId = availableCameraIds[index];
     updateNamePlaceholder();
+    emit cameraIdSelected(selectedCameraId);
   }
 }
 
@@ -246,6 +343,14 @@ void AddCameraDialog::onAccepted() {
     return;
   }
 
+  subRtspUrl = subRtspUrlLineEdit->text().trimmed();
+  if (!subRtspUrl.isEmpty() &&
+      !subRtspUrl.startsWith("rtsp://", Qt::CaseInsensitive)) {
+    QMessageBox::warning(this, "格式错误", "子码流地址必须以 rtsp:// 开头！");
+    subRtspUrlLineEdit->setFocus();
+    return;
+  }
+
   // 获取摄像头名称（如果为空，使用默认名称）
   cameraName = cameraNameLineEdit->text().trimmed();
   if (cameraName.isEmpty()) {
@@ -260,6 +365,12 @@ int AddCameraDialog::getSelectedCameraId() const { return selectedCameraId; }
 
 QString AddCameraDialog::getRtspUrl() const { return rtspUrl; }
 
+QString AddCameraDialog::getSubRtspUrl() const { return subRtspUrl; }
+
+void AddCameraDialog::setSubRtspUrl(const QString &url) {
+  subRtspUrlLineEdit->setText(url);
+}
+
 QString AddCameraDialog::getCameraName() const { return cameraName; }
 
 void AddCameraDialog::onAutoDiscoveryClicked() {
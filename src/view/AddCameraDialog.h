@@ -1,14 +1,18 @@
 #pragma once
 
+#include <QCheckBox>
 #include <QComboBox>
 #include <QDialog>
 #include <QFormLayout>
+#include <QGroupBox>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QLineEdit>
 #include <QList>
 #include <QPushButton>
+#include <QSpinBox>
 #include <QVBoxLayout>
+#include "StreamConfig.h"
 
 // 前向声明
 struct DiscoveredDevice;
@@ -26,7 +30,16 @@ public:
   // 获取用户输入的信息
   int getSelectedCameraId() const;
   QString getRtspUrl() const;
+  QString getSubRtspUrl() const; // 子码流地址（未填写时为空）
+  void setSubRtspUrl(const QString &url);
   QString getCameraName() const;
+  // 获取/设置RTSP打开参数（连接参数分组）
+  OpenOptions getOpenOptions() const;
+  void setOpenOptions(const OpenOptions &options);
+
+signals:
+  // 选择的摄像头ID变化，由controller重新预填该位置已保存的配置
+  void cameraIdSelected(int cameraId);
 
 private slots:
   void onCameraIdChanged(int index);
@@ -36,17 +49,30 @@ private slots:
 
 private:
   void setupUI();
+  QGroupBox *createOpenOptionsGroup(); // 创建连接参数分组
   void updateNamePlaceholder();
 
   QComboBox *cameraIdComboBox;
   QLineEdit *rtspUrlLineEdit;
+  QLineEdit *subRtspUrlLineEdit; // 子码流地址（可选）
   QLineEdit *cameraNameLineEdit;
   QPushButton *okButton;
   QPushButton *cancelButton;
   QPushButton *autoDiscoveryButton; // 自动发现按钮
 
+  // 连接参数控件
+  QComboBox *transportComboBox;     // 传输方式
+  QSpinBox *probeSizeSpinBox;       // 探测数据量（KB）
+  QSpinBox *analyzeDurationSpinBox; // 探测时长（毫秒）
+  QCheckBox *noBufferCheckBox;      // 不缓存探测数据
+  QCheckBox *lowDelayCheckBox;      // 低延迟解码
+  QSpinBox *maxDelaySpinBox;        // 最大解复用延迟（毫秒）
+  QSpinBox *reorderQueueSpinBox;    // 乱序重排队列长度
+  QSpinBox *timeoutSpinBox;         // 网络超时（秒）
+
   QList<int> availableCameraIds;
   int selectedCameraId;
   QString rtspUrl;
+  QString subRtspUrl;
   QString cameraName;
 };
@@ -0,0 +1,140 @@
+#include "DecoderOptionsDialog.h"
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+
+DecoderOptionsDialog::DecoderOptionsDialog(int cameraId,
+                                           const DecoderOptions &options,
+                                           QWidget *parent)
+    : QDialog(parent), cameraId(cameraId), options(options) {
+  setupUI();
+}
+
+void DecoderOptionsDialog::setupUI() {
+  setWindowTitle(QString("解码设置 - 位置 %1").arg(cameraId));
+  setMinimumWidth(380);
+
+  QVBoxLayout *mainLayout = new QVBoxLayout(this);
+  mainLayout->setSpacing(15);
+  mainLayout->setContentsMargins(20, 20, 20, 20);
+
+  QFormLayout *formLayout = new QFormLayout();
+  formLayout->setSpacing(12);
+  formLayout->setLabelAlignment(Qt::AlignRight | Qt::AlignVCenter);
+
+  // 1. 解码线程数（0为自动）
+  threadCountSpinBox = new QSpinBox(this);
+  threadCountSpinBox->setMinimumHeight(30);
+  threadCountSpinBox->setRange(0, 16);
+  threadCountSpinBox->setSpecialValueText("自动");
+  threadCountSpinBox->setValue(options.threadCount);
+  formLayout->addRow("解码线程数:", threadCountSpinBox);
+
+  // 2. 线程模式
+  threadTypeComboBox = new QComboBox(this);
+  threadTypeComboBox->setMinimumHeight(30);
+  threadTypeComboBox->addItem("帧级多线程", static_cast<int>(DecoderThreadType::Frame));
+  threadTypeComboBox->addItem("片级多线程（低延迟）", static_cast<int>(DecoderThreadType::Slice));
+  threadTypeComboBox->setCurrentIndex(
+      threadTypeComboBox->findData(static_cast<int>(options.threadType)));
+  formLayout->addRow("线程模式:", threadTypeComboBox);
+
+  // 3. 跳过环路滤波
+  skipLoopFilterCheckBox = new QCheckBox("跳过环路滤波（画质略降，解码更快）", this);
+  skipLoopFilterCheckBox->setChecked(options.skipLoopFilter);
+  formLayout->addRow("", skipLoopFilterCheckBox);
+
+  // 4. 低分辨率解码
+  lowresComboBox = new QComboBox(this);
+  lowresComboBox->setMinimumHeight(30);
+  lowresComboBox->addItem("关闭", 0);
+  lowresComboBox->addItem("1/2 分辨率", 1);
+  lowresComboBox->addItem("1/4 分辨率", 2);
+  lowresComboBox->setCurrentIndex(qMax(0, lowresComboBox->findData(options.lowres)));
+  formLayout->addRow("低分辨率解码:", lowresComboBox);
+
+  // 5. 当前解码耗时
+  decodeTimeLabel = new QLabel("暂无数据", this);
+  formLayout->addRow("平均解码耗时:", decodeTimeLabel);
+
+  mainLayout->addLayout(formLayout);
+
+  // 低延迟解码与帧级多线程冲突时提示（线程数为自动时单线程解码，不冲突）
+  lowDelayHintLabel =
+      new QLabel("⚠️ 该摄像头已开启低延迟解码（连接参数），帧级多线程会被FFmpeg关闭，"
+                 "将改用片级多线程",
+                 this);
+  lowDelayHintLabel->setStyleSheet("QLabel { color: #cc6600; font-size: 11px; }");
+  lowDelayHintLabel->setWordWrap(true);
+  lowDelayHintLabel->setVisible(false);
+  mainLayout->addWidget(lowDelayHintLabel);
+  connect(threadCountSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this,
+          &DecoderOptionsDialog::updateLowDelayHint);
+  connect(threadTypeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+          this, &DecoderOptionsDialog::updateLowDelayHint);
+
+  QLabel *hintLabel =
+      new QLabel("提示：\n"
+                 "• 修改后只重建解码器，不会断开视频流\n"
+                 "• 线程数为自动时单线程解码，由共享的解码线程池在各路之间并行\n"
+                 "• 低分辨率解码仅部分编码格式支持，不支持时自动忽略",
+                 this);
+  hintLabel->setStyleSheet("QLabel {"
+                           "  color: #666666;"
+                           "  font-size: 11px;"
+                           "  background-color: #f0f0f0;"
+                           "  border: 1px solid #cccccc;"
+                           "  border-radius: 4px;"
+                           "  padding: 10px;"
+                           "}");
+  hintLabel->setWordWrap(true);
+  mainLayout->addWidget(hintLabel);
+
+  QHBoxLayout *buttonLayout = new QHBoxLayout();
+  buttonLayout->addStretch();
+
+  cancelButton = new QPushButton("取消", this);
+  cancelButton->setMinimumSize(80, 32);
+  okButton = new QPushButton("确定", this);
+  okButton->setMinimumSize(80, 32);
+  okButton->setDefault(true);
+
+  buttonLayout->addWidget(cancelButton);
+  buttonLayout->addSpacing(10);
+  buttonLayout->addWidget(okButton);
+  mainLayout->addLayout(buttonLayout);
+
+  connect(okButton, &QPushButton::clicked, this, &QDialog::accept);
+  connect(cancelButton, &QPushButton::clicked, this, &QDialog::reject);
+}
+
+DecoderOptions DecoderOptionsDialog::getDecoderOptions() const {
+  DecoderOptions result;
+  result.threadCount = threadCountSpinBox->value();
+  result.threadType =
+      static_cast<DecoderThreadType>(threadTypeComboBox->currentData().toInt());
+  result.skipLoopFilter = skipLoopFilterCheckBox->isChecked();
+  result.lowres = lowresComboBox->currentData().toInt();
+  return result;
+}
+
+void DecoderOptionsDialog::setLowDelay(bool lowDelay) {
+  this->lowDelay = lowDelay;
+  updateLowDelayHint();
+}
+
+void DecoderOptionsDialog::updateLowDelayHint() {
+  bool frameThreads =
+      threadCountSpinBox->value() > 1 &&
+      static_cast<DecoderThreadType>(threadTypeComboBox->currentData().toInt()) ==
+          DecoderThreadType::Frame;
+  lowDelayHintLabel->setVisible(lowDelay && frameThreads);
+}
+
+void DecoderOptionsDialog::setDecodeTime(double averageMs) {
+  if (averageMs < 0) {
+    decodeTimeLabel->setText("暂无数据");
+  } else {
+    decodeTimeLabel->setText(QString("%1 ms").arg(averageMs, 0, 'f', 2));
+  }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDialog>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include "StreamConfig.h"
+
+// 解码器设置对话框：修改单路摄像头的解码线程等配置，确定后立即生效
+class DecoderOptionsDialog : public QDialog {
+  Q_OBJECT
+
+public:
+  explicit DecoderOptionsDialog(int cameraId, const DecoderOptions &options,
+                                QWidget *parent = nullptr);
+
+  // 获取用户设置的解码器配置
+  DecoderOptions getDecoderOptions() const;
+  // 显示当前平均解码耗时（毫秒，负数表示暂无数据）
+  void setDecodeTime(double averageMs);
+  // 该摄像头的连接参数是否开启了低延迟解码（开启时帧级多线程改为片级，界面给出提示）
+  void setLowDelay(bool lowDelay);
+
+private:
+  void setupUI();
+  void updateLowDelayHint();
+
+  bool lowDelay = false;
+
+  int cameraId;
+  DecoderOptions options;
+
+  QSpinBox *threadCountSpinBox;
+  QComboBox *threadTypeComboBox;
+  QCheckBox *skipLoopFilterCheckBox;
+  QComboBox *lowresComboBox;
+  QLabel *decodeTimeLabel;
+  QLabel *lowDelayHintLabel; // 低延迟解码与帧级多线程冲突的提示
+  QPushButton *okButton;
+  QPushButton *cancelButton;
+};
@@ -0,0 +1,163 @@
+#include "EventLogModel.h"
+#include <QColor>
+
+EventLogModel::EventLogModel(int capacity, QObject* parent)
+    : QAbstractListModel(parent), m_capacity(qMax(1, capacity)), m_head(0), m_count(0),
+      m_droppedPending(0), m_flushTimer(this)
+{
+    m_entries.resize(m_capacity);
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(FlushIntervalMs);
+    connect(&m_flushTimer, &QTimer::timeout, this, &EventLogModel::flush);
+}
+
+void EventLogModel::append(const QString& type, const QString& message, int cameraId)
+{
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+    if (m_pending.size() >= MaxPerFlush) {
+        ++m_droppedPending; // 本次刷新的消息已达上限
+        return;
+    }
+    Entry entry;
+    entry.time = QDateTime::currentDateTime();
+    entry.type = type;
+    entry.message = message;
+    entry.cameraId = cameraId;
+    m_pending.append(entry);
+
+    if (cameraId >= 0 && !m_cameras.contains(cameraId)) {
+        m_cameras.insert(cameraId);
+        emit cameraSeen(cameraId);
+    }
+}
+
+void EventLogModel::clear()
+{
+    // 尚未显示的消息一并丢弃，否则清空后下次刷新又会出现
+    m_flushTimer.stop();
+    m_pending.clear();
+    m_droppedPending = 0;
+    beginResetModel();
+    for (Entry& entry : m_entries) {
+        entry = Entry();
+    }
+    m_head = 0;
+    m_count = 0;
+    endResetModel();
+}
+
+void EventLogModel::flush()
+{
+    if (m_droppedPending > 0) {
+        Entry entry;
+        entry.time = QDateTime::currentDateTime();
+        entry.type = "warning";
+        entry.message = QString("消息过多，已丢弃%1条").arg(m_droppedPending);
+        m_pending.append(entry);
+        m_droppedPending = 0;
+    }
+    if (m_pending.isEmpty()) {
+        return;
+    }
+    QVector<Entry> batch;
+    batch.swap(m_pending);
+    if (batch.size() > m_capacity) {
+        batch.erase(batch.begin(), batch.end() - m_capacity);
+    }
+
+    // 先移除放不下的最早消息，再在末尾一次插入整批
+    int overflow = m_count + batch.size() - m_capacity;
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        for (int i = 0; i < overflow; ++i) {
+            m_entries[m_head] = Entry(); // 释放字符串
+            m_head = (m_head + 1) % m_capacity;
+        }
+        m_count -= overflow;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), m_count, m_count + batch.size() - 1);
+    for (const Entry& entry : batch) {
+        m_entries[(m_head + m_count) % m_capacity] = entry;
+        ++m_count;
+    }
+    endInsertRows();
+}
+
+QString EventLogModel::typeLabel(const QString& type)
+{
+    if (type == "error") return "[错误]";
+    if (type == "warning") return "[警告]";
+    if (type == "success") return "[成功]";
+    if (type == "info") return "[信息]";
+    if (type == "alarm") return "[报警]";
+    if (type == "receive") return "[接收]";
+    if (type == "send") return "[发送]";
+    return "[消息]";
+}
+
+int EventLogModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_count;
+}
+
+QVariant EventLogModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_count) {
+        return QVariant();
+    }
+    const Entry& entry = entryAt(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        return QString("[%1] %2 %3").arg(entry.time.toString("yyyy-MM-dd hh:mm:ss"))
+                                    .arg(typeLabel(entry.type)).arg(entry.message);
+    case Qt::ToolTipRole:
+        return entry.message; // 左侧面板较窄，完整内容在提示中查看
+    case Qt::ForegroundRole:
+        // 根据消息类型设置颜色
+        if (entry.type == "error") return QColor("#cc0000");
+        if (entry.type == "warning") return QColor("#ff8800");
+        if (entry.type == "success") return QColor("#008000");
+        if (entry.type == "info") return QColor("#0066cc");
+        if (entry.type == "alarm") return QColor("#d4006a");
+        return QColor("#333333");
+    case TypeRole:
+        return entry.type;
+    case CameraRole:
+        return entry.cameraId;
+    default:
+        return QVariant();
+    }
+}
+
+EventLogFilterModel::EventLogFilterModel(QObject* parent)
+    : QSortFilterProxyModel(parent), m_cameraId(AllCameras)
+{
+}
+
+void EventLogFilterModel::setTypeFilter(const QString& type)
+{
+    m_type = type;
+    invalidateFilter();
+}
+
+void EventLogFilterModel::setCameraFilter(int cameraId)
+{
+    m_cameraId = cameraId;
+    invalidateFilter();
+}
+
+bool EventLogFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
+{
+    if (m_type.isEmpty() && m_cameraId == AllCameras) {
+        return true;
+    }
+    QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
+    if (!m_type.isEmpty() && index.data(EventLogModel::TypeRole).toString() != m_type) {
+        return false;
+    }
+    return m_cameraId == AllCameras || index.data(EventLogModel::CameraRole).toInt() == m_cameraId;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <QAbstractListModel>
+#include <QSortFilterProxyModel>
+#include <QDateTime>
+#include <QSet>
+#include <QTimer>
+#include <QVector>
+
+// 事件日志模型：固定容量的环形缓冲，超出容量时丢弃最早的消息，内存和显示代价不随运行时间增长
+// • append()只进入待显示队列，每FlushIntervalMs统一插入一次（一次行插入通知），消息再多也不会逐条重排
+// • 每次刷新最多插入MaxPerFlush条，超出部分丢弃并插入一条提示
+// • 行的文本按需生成（只为可见的行格式化），配合QListView的统一行高只布局可见区域
+class EventLogModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Roles {
+        TypeRole = Qt::UserRole + 1,   // 消息类型（info/success/warning/error/alarm/receive/send）
+        CameraRole                     // 摄像头ID（-1表示不属于某个摄像头）
+    };
+    static const int FlushIntervalMs = 100;
+    static const int MaxPerFlush = 200;
+
+    explicit EventLogModel(int capacity = 5000, QObject* parent = nullptr);
+
+    void append(const QString& type, const QString& message, int cameraId = -1);
+    void clear();
+    static QString typeLabel(const QString& type); // 消息类型的显示前缀，如"[警告]"
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+signals:
+    void cameraSeen(int cameraId); // 第一次出现某个摄像头的消息（用于更新筛选列表）
+
+private:
+    struct Entry {
+        QDateTime time;
+        QString type;
+        QString message;
+        int cameraId = -1;
+    };
+
+    void flush();                            // 把待显示的消息插入环形缓冲
+    const Entry& entryAt(int row) const { return m_entries[(m_head + row) % m_capacity]; }
+
+    int m_capacity;
+    QVector<Entry> m_entries;                // 环形缓冲（大小达到容量后不再增长）
+    int m_head;                              // 最早一条消息的位置
+    int m_count;                             // 缓冲中的消息数
+    QVector<Entry> m_pending;                // 等待下次刷新的消息
+    int m_droppedPending;                    // 本次刷新因超出MaxPerFlush丢弃的消息数
+    QSet<int> m_cameras;                     // 出现过的摄像头ID
+    QTimer m_flushTimer;
+};
+
+// 按消息类型和摄像头筛选
+class EventLogFilterModel : public QSortFilterProxyModel {
+    Q_OBJECT
+
+public:
+    explicit EventLogFilterModel(QObject* parent = nullptr);
+
+    void setTypeFilter(const QString& type); // 空表示全部类型
+    void setCameraFilter(int cameraId);      // AllCameras表示全部摄像头
+    static const int AllCameras = -2;
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+
+private:
+    QString m_type;
+    int m_cameraId;
+};
@@ -0,0 +1,90 @@
+#include "EventLogView.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QScrollBar>
+
+EventLogView::EventLogView(int capacity, QWidget* parent)
+    : QWidget(parent), m_model(new EventLogModel(capacity, this)), m_filter(new EventLogFilterModel(this)),
+      m_listView(new QListView(this)), m_typeCombo(new QComboBox(this)), m_cameraCombo(new QComboBox(this)),
+      m_followTail(true)
+{
+    m_filter->setSourceModel(m_model);
+    m_listView->setModel(m_filter);
+    m_listView->setUniformItemSizes(true);   // 行高一致，不需要逐行计算尺寸
+    m_listView->setWordWrap(false);
+    m_listView->setTextElideMode(Qt::ElideRight);
+    m_listView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_listView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_listView->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    m_listView->setStyleSheet(
+        "QListView {"
+        "  font-family: 'Consolas', 'Monaco', monospace;"
+        "  font-size: 12px;"
+        "  background-color: #ffffff;"
+        "  border: 1px solid #cccccc;"
+        "  border-radius: 5px;"
+        "  padding: 5px;"
+        "  selection-background-color: #3399ff;"
+        "}"
+    );
+
+    // 筛选：消息类型
+    m_typeCombo->addItem("全部类型", QString());
+    const QStringList types = { "info", "success", "warning", "error", "alarm", "receive", "send" };
+    for (const QString& type : types) {
+        m_typeCombo->addItem(EventLogModel::typeLabel(type), type);
+    }
+    // 筛选：摄像头（出现新摄像头的消息时加入）
+    m_cameraCombo->addItem("全部摄像头", EventLogFilterModel::AllCameras);
+
+    QHBoxLayout* filterLayout = new QHBoxLayout();
+    filterLayout->setContentsMargins(0, 0, 0, 0);
+    filterLayout->setSpacing(3);
+    filterLayout->addWidget(m_typeCombo);
+    filterLayout->addWidget(m_cameraCombo);
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(3);
+    layout->addLayout(filterLayout);
+    layout->addWidget(m_listView);
+
+    connect(m_typeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+        m_filter->setTypeFilter(m_typeCombo->itemData(index).toString());
+        m_listView->scrollToBottom();
+    });
+    connect(m_cameraCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+        m_filter->setCameraFilter(m_cameraCombo->itemData(index).toInt());
+        m_listView->scrollToBottom();
+    });
+    connect(m_model, &EventLogModel::cameraSeen, this, &EventLogView::addCameraFilter);
+
+    // 自动滚动：只在插入前已位于底部时跟随最新消息
+    connect(m_filter, &QAbstractItemModel::rowsAboutToBeInserted, this, [this]() {
+        QScrollBar* bar = m_listView->verticalScrollBar();
+        m_followTail = bar->value() >= bar->maximum();
+    });
+    connect(m_filter, &QAbstractItemModel::rowsInserted, this, [this]() {
+        if (m_followTail) {
+            m_listView->scrollToBottom();
+        }
+    });
+}
+
+void EventLogView::addMessage(const QString& type, const QString& message, int cameraId)
+{
+    m_model->append(type, message, cameraId);
+}
+
+void EventLogView::clear()
+{
+    m_model->clear();
+}
+
+void EventLogView::addCameraFilter(int cameraId)
+{
+    int row = 1;
+    while (row < m_cameraCombo->count() && m_cameraCombo->itemData(row).toInt() < cameraId) {
+        ++row;
+    }
+    m_cameraCombo->insertItem(row, cameraId == 0 ? QString("主画面") : QString("摄像头%1").arg(cameraId), cameraId);
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <QWidget>
+#include <QListView>
+#include <QComboBox>
+#include "EventLogModel.h"
+
+// 事件日志控件：可按类型和摄像头筛选的列表视图
+// • 统一行高、不换行，只布局和绘制可见的行
+// • 滚动条在底部时新消息到达后自动滚到底部，用户向上翻看时保持位置
+class EventLogView : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit EventLogView(int capacity = 5000, QWidget* parent = nullptr);
+
+    // 添加一条消息（在下次刷新时显示），cameraId为-1表示不属于某个摄像头
+    void addMessage(const QString& type, const QString& message, int cameraId = -1);
+    void clear();
+    QListView* listView() const { return m_listView; }
+
+private:
+    void addCameraFilter(int cameraId); // 筛选列表中加入新出现的摄像头（按ID排序）
+
+    EventLogModel* m_model;
+    EventLogFilterModel* m_filter;
+    QListView* m_listView;
+    QComboBox* m_typeCombo;
+    QComboBox* m_cameraCombo;
+    bool m_followTail;                  // 插入前滚动条是否在底部
+};
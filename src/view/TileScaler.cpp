@@ -0,0 +1,125 @@
+#include "TileScaler.h"
+#include <QRunnable>
+#include <QThread>
+
+// 单次缩放任务：在工作线程中平滑缩放，完成后回到界面线程投递结果
+class TileScaleJob : public QRunnable {
+public:
+    TileScaleJob(TileScaler* scaler, int streamId, const QImage& frame, const QSize& tileSize, quint64 generation)
+        : m_scaler(scaler), m_streamId(streamId), m_frame(frame), m_tileSize(tileSize), m_generation(generation)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        QImage scaled = m_frame.scaled(m_tileSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        m_frame = QImage(); // 尽早释放源帧
+
+        // TileScaler析构时会等待所有任务结束，投递时对象一定有效
+        TileScaler* scaler = m_scaler;
+        int streamId = m_streamId;
+        quint64 generation = m_generation;
+        QSize tileSize = m_tileSize;
+        QMetaObject::invokeMethod(scaler, [scaler, streamId, generation, scaled, tileSize]() {
+            scaler->onJobFinished(streamId, generation, scaled, tileSize);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    TileScaler* m_scaler;
+    int m_streamId;
+    QImage m_frame;
+    QSize m_tileSize;
+    quint64 m_generation;
+};
+
+TileScaler::TileScaler(QObject* parent)
+    : QObject(parent)
+{
+    // 解码线程已占用大部分核心，缩放只需少量线程
+    m_pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 4));
+}
+
+TileScaler::~TileScaler()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void TileScaler::submit(int streamId, const QImage& frame, const QSize& tileSize)
+{
+    if (frame.isNull() || tileSize.isEmpty()) {
+        return;
+    }
+    TileState& tile = m_tiles[streamId];
+    if (tile.busy) {
+        // 上一帧尚未缩放完成，只保留最新一帧等待
+        tile.pendingFrame = frame;
+        tile.pendingSize = tileSize;
+        return;
+    }
+    tile.busy = true;
+    startJob(streamId, frame, tileSize, tile.generation);
+}
+
+void TileScaler::invalidate(int streamId)
+{
+    auto it = m_tiles.find(streamId);
+    if (it == m_tiles.end()) {
+        return;
+    }
+    ++it->generation;
+    it->pendingFrame = QImage();
+    it->pendingSize = QSize();
+}
+
+void TileScaler::remove(int streamId)
+{
+    auto it = m_tiles.find(streamId);
+    if (it == m_tiles.end()) {
+        return;
+    }
+    if (!it->busy) {
+        m_tiles.erase(it);
+        return;
+    }
+    // 任务仍在执行，等结果回到界面线程时再删除
+    ++it->generation;
+    it->pendingFrame = QImage();
+    it->pendingSize = QSize();
+    it->removed = true;
+}
+
+void TileScaler::startJob(int streamId, const QImage& frame, const QSize& tileSize, quint64 generation)
+{
+    m_pool.start(new TileScaleJob(this, streamId, frame, tileSize, generation));
+}
+
+void TileScaler::onJobFinished(int streamId, quint64 generation, const QImage& image, const QSize& tileSize)
+{
+    auto it = m_tiles.find(streamId);
+    if (it == m_tiles.end()) {
+        return;
+    }
+    it->busy = false;
+    if (it->removed) {
+        m_tiles.erase(it);
+        return;
+    }
+    quint64 currentGeneration = it->generation;
+
+    // 启动等待中的任务
+    if (!it->pendingFrame.isNull()) {
+        QImage frame = it->pendingFrame;
+        QSize size = it->pendingSize;
+        it->pendingFrame = QImage();
+        it->pendingSize = QSize();
+        it->busy = true;
+        startJob(streamId, frame, size, currentGeneration);
+    }
+
+    if (generation == currentGeneration) {
+        emit frameScaled(streamId, image, tileSize);
+    }
+}
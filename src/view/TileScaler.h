@@ -0,0 +1,47 @@
+#pragma once
+#include <QObject>
+#include <QImage>
+#include <QSize>
+#include <QHash>
+#include <QThreadPool>
+
+// 视频块缩放线程池：帧尺寸与视频块显示尺寸不一致时，在工作线程中平滑缩放
+// • 按(streamId, 视频块尺寸)管理任务，每路最多一个任务在执行、一个任务等待（新帧覆盖等待中的旧帧）
+// • 视频块尺寸变化时调用invalidate()，只丢弃该路尚未完成的结果
+// • 结果为可直接绘制的RGB32图像（QPixmap只能在界面线程创建，绘制RGB32的QImage无需转换）
+class TileScaler : public QObject {
+    Q_OBJECT
+
+public:
+    explicit TileScaler(QObject* parent = nullptr);
+    ~TileScaler();
+
+    // 提交缩放任务（仅界面线程调用），frame必须持有自己的像素数据
+    void submit(int streamId, const QImage& frame, const QSize& tileSize);
+    // 使该路尚未完成的缩放结果失效（视频块尺寸变化时调用）
+    void invalidate(int streamId);
+    // 删除该路的任务状态（视频流删除时调用），正在执行的任务完成后丢弃结果
+    void remove(int streamId);
+
+signals:
+    // 缩放完成信号（界面线程发出），tileSize为提交任务时的视频块尺寸
+    void frameScaled(int streamId, const QImage& image, const QSize& tileSize);
+
+private:
+    // 每路视频块的任务状态（仅界面线程访问）
+    struct TileState {
+        bool busy = false;         // 是否有任务正在执行
+        quint64 generation = 0;    // 失效计数，结果的代数不一致时丢弃
+        QImage pendingFrame;       // 等待中的帧（执行期间收到的最新帧）
+        QSize pendingSize;         // 等待中的帧对应的视频块尺寸
+        bool removed = false;      // 视频流已删除，任务完成后删除状态
+    };
+
+    void startJob(int streamId, const QImage& frame, const QSize& tileSize, quint64 generation);
+    void onJobFinished(int streamId, quint64 generation, const QImage& image, const QSize& tileSize);
+
+    QThreadPool m_pool;                // 缩放工作线程
+    QHash<int, TileState> m_tiles;     // streamId -> 任务状态
+
+    friend class TileScaleJob;
+};
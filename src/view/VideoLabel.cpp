@@ -3,12 +3,15 @@
 #include <QDebug>
 #include <QCursor>
 #include <QEvent>
+#include <QResizeEvent>
+#include <QFontMetrics>
+#include <cstring>
 
 // 构造函数，初始化成员变量
 VideoLabel::VideoLabel(QWidget* parent)
     : QLabel(parent), m_isDrawing(false), m_hasRectangle(false), 
       m_showButtons(false), m_rectangleConfirmed(false), m_drawingEnabled(false),
-      m_hoverControlEnabled(false), m_isHovered(false), m_isPaused(false), 
+      m_hoverControlEnabled(false), m_isHovered(false), m_isPaused(false), m_isRecording(false),
       m_cameraId(-1), m_boundIp(""), m_streamId(-1)
 {
     setMouseTracking(true); // 启用鼠标跟踪，便于捕捉鼠标移动事件
@@ -75,12 +78,24 @@ void VideoLabel::setPaused(bool paused)
 
 void VideoLabel::paintEvent(QPaintEvent* event)
 {
-    // 先调用父类的paintEvent绘制视频图像
-    QLabel::paintEvent(event);
+    if (m_frame.isNull()) {
+        // 没有视频帧时由父类绘制文字提示（或旧代码通过setPixmap设置的图像）
+        QLabel::paintEvent(event);
+    } else {
+        // 有视频帧时只绘制背景和边框，文字提示被画面取代
+        QFrame::paintEvent(event);
+    }
+    
+    // 视频帧和所有叠加层在同一次绘制中完成
+    QPainter painter(this);
+    if (!m_frame.isNull()) {
+        // 尺寸不一致只出现在布局刚切换、缩放结果尚未返回的短暂期间，使用快速缩放过渡
+        painter.drawImage(imageRect(), m_frame);
+    }
     
-    // 然后在视频上绘制矩形框
+    // 在视频上绘制矩形框
     if (m_isDrawing || m_hasRectangle) {
-        QPainter painter(this);
+        painter.save();
         painter.setRenderHint(QPainter::Antialiasing);
         drawRectangle(painter);
         
@@ -88,14 +103,73 @@ void VideoLabel::paintEvent(QPaintEvent* event)
         if (m_hasRectangle && !m_rectangleConfirmed && m_showButtons) {
             drawButtons(painter);
         }
+        painter.restore();
+    }
+    
+    // 绘制性能统计叠加层（左下角）
+    if (!m_statsText.isEmpty()) {
+        painter.save();
+        drawStatsOverlay(painter);
+        painter.restore();
+    }
+    
+    // 绘制录像标记（右上角）
+    if (m_isRecording) {
+        painter.save();
+        drawRecordingIndicator(painter);
+        painter.restore();
     }
     
     // 绘制悬停控制条（多路显示时）- 仅在鼠标悬停时显示
     if (m_hoverControlEnabled && m_isHovered) {
-        QPainter painter(this);
+        painter.save();
         painter.setRenderHint(QPainter::Antialiasing);
         drawHoverControl(painter);
+        painter.restore();
+    }
+}
+
+// 设置视频帧：尺寸和格式不变时复用已有缓冲区，只拷贝像素
+void VideoLabel::setFrame(const QImage& frame)
+{
+    if (frame.isNull()) {
+        clearFrame();
+        return;
+    }
+    if (!m_frame.isNull() && m_frame.size() == frame.size() && m_frame.format() == frame.format()) {
+        int bytes = qMin(m_frame.bytesPerLine(), frame.bytesPerLine());
+        for (int y = 0; y < frame.height(); ++y) {
+            memcpy(m_frame.scanLine(y), frame.constScanLine(y), static_cast<size_t>(bytes));
+        }
+    } else {
+        m_frame = frame.copy(); // 深拷贝，帧池缓冲区可以立即归还
+    }
+}
+
+// 清除视频帧
+void VideoLabel::clearFrame()
+{
+    if (!m_frame.isNull()) {
+        m_frame = QImage();
+        update();
+    }
+}
+
+// 计算视频帧的显示区域：与显示区域相差不超过2像素时按原尺寸居中显示，否则保持纵横比缩放
+QRect VideoLabel::imageRect() const
+{
+    if (m_frame.isNull()) {
+        return QRect();
+    }
+    QRect area = contentsRect();
+    QSize size = m_frame.size();
+    QSize fitted = size.scaled(area.size(), Qt::KeepAspectRatio);
+    if (qAbs(fitted.width() - size.width()) > 2 || qAbs(fitted.height() - size.height()) > 2) {
+        size = fitted;
     }
+    QRect rect(QPoint(0, 0), size);
+    rect.moveCenter(area.center());
+    return rect;
 }
 
 void VideoLabel::mousePressEvent(QMouseEvent* event)
@@ -423,6 +497,59 @@ void VideoLabel::mouseDoubleClickEvent(QMouseEvent* event)
     QLabel::mouseDoubleClickEvent(event);
 }
 
+// 尺寸变化事件
+void VideoLabel::resizeEvent(QResizeEvent* event)
+{
+    QLabel::resizeEvent(event);
+    if (m_streamId >= 0) {
+        // 通知解码端按新的内容区域尺寸缩放输出
+        emit displaySizeChanged(m_streamId, displaySize());
+    }
+}
+
+// 绘制性能统计叠加层
+void VideoLabel::drawStatsOverlay(QPainter& painter)
+{
+    // 根据控件高度自适应字体大小，16路时也能看清
+    QFont font = painter.font();
+    font.setPixelSize(qMax(9, qMin(13, height() / 20)));
+    painter.setFont(font);
+    
+    QFontMetrics metrics(font);
+    QRect textRect = metrics.boundingRect(QRect(0, 0, width() - 8, height()), Qt::AlignLeft | Qt::TextWordWrap, m_statsText);
+    QRect backgroundRect(4, height() - textRect.height() - 12, textRect.width() + 8, textRect.height() + 8);
+    
+    // 半透明背景，避免遮挡画面
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, 160));
+    painter.drawRect(backgroundRect);
+    
+    painter.setPen(QColor(0, 255, 136));
+    painter.drawText(backgroundRect.adjusted(4, 4, -4, -4), Qt::AlignLeft | Qt::TextWordWrap, m_statsText);
+}
+
+// 绘制录像标记
+void VideoLabel::drawRecordingIndicator(QPainter& painter)
+{
+    QFont font = painter.font();
+    font.setPixelSize(qMax(9, qMin(13, height() / 20)));
+    font.setBold(true);
+    painter.setFont(font);
+    painter.setRenderHint(QPainter::Antialiasing);
+    
+    QFontMetrics metrics(font);
+    int dot = metrics.height() / 2;
+    int textWidth = metrics.horizontalAdvance("REC");
+    QRect backgroundRect(width() - textWidth - dot - 20, 4, textWidth + dot + 16, metrics.height() + 6);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, 160));
+    painter.drawRoundedRect(backgroundRect, 3, 3);
+    painter.setBrush(QColor(255, 59, 48));
+    painter.drawEllipse(QRect(backgroundRect.left() + 6, backgroundRect.center().y() - dot / 2, dot, dot));
+    painter.setPen(Qt::white);
+    painter.drawText(backgroundRect.adjusted(dot + 10, 0, 0, 0), Qt::AlignLeft | Qt::AlignVCenter, "REC");
+}
+
 // 绘制悬停控制条
 void VideoLabel::drawHoverControl(QPainter& painter)
 {
@@ -3,6 +3,7 @@
 #include <QPainter>
 #include <QMouseEvent>
 #include <QRect>
+#include <QImage>
 #include "common.h"
 
 
@@ -36,6 +37,11 @@ public:
     void setHoverControlEnabled(bool enabled);
     bool isHoverControlEnabled() const { return m_hoverControlEnabled; }
     
+    // 获取视频流ID（-1表示占位符）
+    int streamId() const { return m_streamId; }
+    // 获取视频内容的显示尺寸（去除边框后的区域）
+    QSize displaySize() const { return contentsRect().size(); }
+    
     // 设置/获取暂停状态
     void setPaused(bool paused);
     bool isPaused() const { return m_isPaused; }
@@ -43,6 +49,23 @@ public:
     // 设置/获取绑定的IP地址
     void setBoundIp(const QString& ip) { m_boundIp = ip; update(); }
     QString getBoundIp() const { return m_boundIp; }
+    
+    // 设置性能统计叠加文本（为空时不显示）
+    void setStatsText(const QString& text) { m_statsText = text; update(); }
+    
+    // 设置/获取连续录像状态（右上角显示录像标记）
+    void setRecording(bool recording) { m_isRecording = recording; update(); }
+    bool isRecording() const { return m_isRecording; }
+    
+    // 设置视频帧（拷贝像素到自有缓冲区，不触发重绘，由View按帧时钟统一刷新）
+    void setFrame(const QImage& frame);
+    // 清除视频帧，恢复显示文字提示
+    void clearFrame();
+    bool hasFrame() const { return !m_frame.isNull(); }
+    // 获取当前视频帧
+    const QImage& currentFrame() const { return m_frame; }
+    // 获取视频帧在控件中的实际显示区域（保持纵横比居中，去除黑边）
+    QRect imageRect() const;
 
 protected:
     // 重写QLabel的绘图事件，用于自定义绘制（如绘制矩形框和按钮）
@@ -59,6 +82,8 @@ protected:
     void leaveEvent(QEvent* event) override;
     // 重写鼠标双击事件，用于选中视频流
     void mouseDoubleClickEvent(QMouseEvent* event) override;
+    // 重写尺寸变化事件，用于通知解码端按新的显示尺寸输出
+    void resizeEvent(QResizeEvent* event) override;
 
 signals:
     // 矩形框绘制完成信号（用于通知外部矩形框已绘制完成）
@@ -76,6 +101,9 @@ signals:
     
     // 视频流选中信号
     void streamDoubleClicked(int streamId);   // 双击视频流选中信号
+    
+    // 显示尺寸变化信号（内容区域大小，不含边框）
+    void displaySizeChanged(int streamId, const QSize& size);
 
 private:
     // 绘框相关成员变量
@@ -96,9 +124,12 @@ private:
     bool m_hoverControlEnabled;    // 是否启用悬停控制条
     bool m_isHovered;              // 鼠标是否悬停在VideoLabel上
     bool m_isPaused;               // 视频流是否暂停
+    bool m_isRecording;            // 是否正在连续录像
     int m_cameraId;                // 摄像头ID
     QString m_cameraName;          // 摄像头名称
     QString m_boundIp;             // 绑定的IP地址
+    QString m_statsText;           // 性能统计叠加文本
+    QImage m_frame;                // 当前视频帧（与paintEvent中的叠加层一起绘制）
     int m_streamId;                // 视频流ID
     QRect m_hoverControlRect;      // 悬停控制条区域
     QRect m_addButtonRect;         // 添加按钮区域
@@ -115,6 +146,10 @@ private:
     // 判断点是否在按钮区域内
     bool isPointInButton(const QPoint& pos, const QRect& buttonRect) const;
     
+    // 绘制性能统计叠加层
+    void drawStatsOverlay(QPainter& painter);
+    // 绘制录像标记
+    void drawRecordingIndicator(QPainter& painter);
     // 绘制悬停控制条
     void drawHoverControl(QPainter& painter);
     // 绘制单个悬停控制按钮
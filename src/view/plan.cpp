@@ -1,5 +1,6 @@
 #include "plan.h"
 #include "detectlist.h"
+#include "view.h"
 #include <QApplication>
 #include <QHeaderView>
 #include <QDir>
@@ -168,7 +169,7 @@ void Plan::initUI()
     configLayout->addWidget(new QLabel("目标摄像头:"), 0, 0);
     m_cameraIdComboBox = new QComboBox();
     m_cameraIdComboBox->addItem("主流（ID: 0）", 0);
-    for (int i = 1; i <= 16; ++i) {
+    for (int i = 1; i <= View::MaxCameraCount; ++i) {
         m_cameraIdComboBox->addItem(QString("子流%1（ID: %2）").arg(i).arg(i), i);
     }
     m_cameraIdComboBox->setStyleSheet(
@@ -216,8 +217,14 @@ void Plan::initUI()
     m_rtspEdit->setPlaceholderText("rtsp://192.168.1.158/live/0");
     configLayout->addWidget(m_rtspEdit, 2, 1);
     
+    // 子码流地址（可选，多画面布局时使用）
+    configLayout->addWidget(new QLabel("子码流地址:"), 3, 0);
+    m_subRtspEdit = new QLineEdit();
+    m_subRtspEdit->setPlaceholderText("子码流地址（可选）");
+    configLayout->addWidget(m_subRtspEdit, 3, 1);
+    
     // 功能使能
-    configLayout->addWidget(new QLabel("功能配置:"), 3, 0);
+    configLayout->addWidget(new QLabel("功能配置:"), 4, 0);
     QVBoxLayout* checkBoxLayout = new QVBoxLayout();
     
     m_aiCheckBox = new QCheckBox("AI识别功能");
@@ -230,10 +237,10 @@ void Plan::initUI()
     
     QWidget* checkBoxWidget = new QWidget();
     checkBoxWidget->setLayout(checkBoxLayout);
-    configLayout->addWidget(checkBoxWidget, 3, 1);
+    configLayout->addWidget(checkBoxWidget, 4, 1);
     
     // 对象列表
-    configLayout->addWidget(new QLabel("对象列表:"), 4, 0, Qt::AlignTop);
+    configLayout->addWidget(new QLabel("对象列表:"), 5, 0, Qt::AlignTop);
     QVBoxLayout* objectLayout = new QVBoxLayout();
     
     m_objectListEdit = new QTextEdit();
@@ -261,7 +268,7 @@ void Plan::initUI()
     
     QWidget* objectWidget = new QWidget();
     objectWidget->setLayout(objectLayout);
-    configLayout->addWidget(objectWidget, 4, 1);
+    configLayout->addWidget(objectWidget, 5, 1);
     
     rightLayout->addWidget(configGroup);
     
@@ -359,6 +366,7 @@ void Plan::initUI()
     connect(m_cameraIdComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &Plan::onFormDataChanged);
     connect(m_nameEdit, &QLineEdit::textChanged, this, &Plan::onFormDataChanged);
     connect(m_rtspEdit, &QLineEdit::textChanged, this, &Plan::onFormDataChanged);
+    connect(m_subRtspEdit, &QLineEdit::textChanged, this, &Plan::onFormDataChanged);
     connect(m_aiCheckBox, &QCheckBox::toggled, this, &Plan::onFormDataChanged);
     connect(m_regionCheckBox, &QCheckBox::toggled, this, &Plan::onFormDataChanged);
     connect(m_objectCheckBox, &QCheckBox::toggled, this, &Plan::onFormDataChanged);
@@ -379,6 +387,7 @@ void Plan::initUI()
     
     m_nameEdit->setStyleSheet(lineEditStyle);
     m_rtspEdit->setStyleSheet(lineEditStyle);
+    m_subRtspEdit->setStyleSheet(lineEditStyle);
     
     QString checkBoxStyle =
         "QCheckBox {"
@@ -526,6 +535,21 @@ bool Plan::createPlanTable()
             QMessageBox::information(this, "数据库升级", 
                 "检测到旧版本数据库，已自动升级完成！\n所有旧方案已迁移为主流方案。");
         }
+        
+        // 检查是否有sub_rtsp_url字段（子码流地址），旧表直接补充
+        query.exec("PRAGMA table_info(plans)");
+        bool hasSubRtspUrl = false;
+        while (query.next()) {
+            if (query.value(1).toString() == "sub_rtsp_url") {
+                hasSubRtspUrl = true;
+                break;
+            }
+        }
+        if (!hasSubRtspUrl && !query.exec("ALTER TABLE plans ADD COLUMN sub_rtsp_url TEXT DEFAULT ''")) {
+            QMessageBox::critical(this, "数据库迁移错误", 
+                QString("添加子码流字段失败：%1").arg(query.lastError().text()));
+            return false;
+        }
     } else {
         // 表不存在，直接创建新表
         QString createTableSql = R"(
@@ -534,6 +558,7 @@ bool Plan::createPlanTable()
                 camera_id INTEGER DEFAULT 0,
                 name TEXT NOT NULL,
                 rtsp_url TEXT NOT NULL,
+                sub_rtsp_url TEXT DEFAULT '',
                 ai_enabled INTEGER DEFAULT 0,
                 region_enabled INTEGER DEFAULT 0,
                 object_enabled INTEGER DEFAULT 0,
@@ -563,7 +588,7 @@ bool Plan::loadPlansFromDatabase()
     QSqlQuery query(m_database);
     
     // 执行SELECT语句从数据库查询所有方案数据，按camera_id和id排序
-    if (!query.exec("SELECT id, camera_id, name, rtsp_url, ai_enabled, region_enabled, object_enabled, object_list FROM plans ORDER BY camera_id, id")) {
+    if (!query.exec("SELECT id, camera_id, name, rtsp_url, ai_enabled, region_enabled, object_enabled, object_list, sub_rtsp_url FROM plans ORDER BY camera_id, id")) {
         // 查询失败时显示警告
         QMessageBox::warning(this, "数据库错误", 
             QString("加载方案失败：%1").arg(query.lastError().text()));
@@ -583,6 +608,7 @@ bool Plan::loadPlansFromDatabase()
         plan.objectEnabled = query.value(6).toBool();  // 第6列：object_enabled (转为bool)
         // 第7列：object_list (JSON字符串转为QSet<int>)
         plan.objectList = objectListFromJson(query.value(7).toString());
+        plan.subRtspUrl = query.value(8).toString();   // 第8列：sub_rtsp_url
         
         // 将转换后的方案对象添加到内存列表
         m_plans.append(plan);
@@ -601,8 +627,8 @@ bool Plan::savePlanToDatabase(const PlanData& plan)
         // 新增方案 - 当ID为-1时表示是新方案，需要插入到数据库
         // 使用预处理语句防止SQL注入攻击
         query.prepare(R"(
-            INSERT INTO plans (camera_id, name, rtsp_url, ai_enabled, region_enabled, object_enabled, object_list) 
-            VALUES (?, ?, ?, ?, ?, ?, ?)
+            INSERT INTO plans (camera_id, name, rtsp_url, ai_enabled, region_enabled, object_enabled, object_list, sub_rtsp_url) 
+            VALUES (?, ?, ?, ?, ?, ?, ?, ?)
         )");
         // 按顺序绑定参数值
         query.addBindValue(plan.cameraId);                                // 摄像头ID
@@ -612,11 +638,12 @@ bool Plan::savePlanToDatabase(const PlanData& plan)
         query.addBindValue(plan.regionEnabled ? 1 : 0);                  // 区域识别开关（布尔转整数）
         query.addBindValue(plan.objectEnabled ? 1 : 0);                  // 对象识别开关（布尔转整数）
         query.addBindValue(objectListToJson(plan.objectList));           // 对象列表（转换为JSON字符串）
+        query.addBindValue(plan.subRtspUrl);                              // 子码流地址
     } else {
         // 更新现有方案 - 当ID大于0时表示是已存在的方案，需要更新数据库记录
         query.prepare(R"(
             UPDATE plans 
-            SET camera_id=?, name=?, rtsp_url=?, ai_enabled=?, region_enabled=?, object_enabled=?, object_list=?, updated_time=CURRENT_TIMESTAMP 
+            SET camera_id=?, name=?, rtsp_url=?, ai_enabled=?, region_enabled=?, object_enabled=?, object_list=?, sub_rtsp_url=?, updated_time=CURRENT_TIMESTAMP 
             WHERE id=?
         )");
         // 按顺序绑定更新的参数值
@@ -627,6 +654,7 @@ bool Plan::savePlanToDatabase(const PlanData& plan)
         query.addBindValue(plan.regionEnabled ? 1 : 0);                  // 区域识别开关（布尔转整数）
         query.addBindValue(plan.objectEnabled ? 1 : 0);                  // 对象识别开关（布尔转整数）
         query.addBindValue(objectListToJson(plan.objectList));           // 对象列表（转换为JSON字符串）
+        query.addBindValue(plan.subRtspUrl);                              // 子码流地址
         query.addBindValue(plan.id);                                     // WHERE条件：方案ID
     }
     
@@ -715,6 +743,7 @@ void Plan::updateFormFromPlan(const PlanData& plan)
     m_cameraIdComboBox->blockSignals(true);
     m_nameEdit->blockSignals(true);
     m_rtspEdit->blockSignals(true);
+    m_subRtspEdit->blockSignals(true);
     m_aiCheckBox->blockSignals(true);
     m_regionCheckBox->blockSignals(true);
     m_objectCheckBox->blockSignals(true);
@@ -723,6 +752,7 @@ void Plan::updateFormFromPlan(const PlanData& plan)
     m_cameraIdComboBox->setCurrentIndex(plan.cameraId);  // 设置摄像头ID（索引即为ID）
     m_nameEdit->setText(plan.name);                     // 设置方案名称
     m_rtspEdit->setText(plan.rtspUrl);                  // 设置RTSP地址
+    m_subRtspEdit->setText(plan.subRtspUrl);            // 设置子码流地址
     m_aiCheckBox->setChecked(plan.aiEnabled);           // 设置AI功能开关状态
     m_regionCheckBox->setChecked(plan.regionEnabled);   // 设置区域识别开关状态
     m_objectCheckBox->setChecked(plan.objectEnabled);   // 设置对象识别开关状态
@@ -746,6 +776,7 @@ void Plan::updateFormFromPlan(const PlanData& plan)
     m_cameraIdComboBox->blockSignals(false);
     m_nameEdit->blockSignals(false);
     m_rtspEdit->blockSignals(false);
+    m_subRtspEdit->blockSignals(false);
     m_aiCheckBox->blockSignals(false);
     m_regionCheckBox->blockSignals(false);
     m_objectCheckBox->blockSignals(false);
@@ -761,6 +792,7 @@ void Plan::updatePlanFromForm(PlanData& plan)
     plan.cameraId = m_cameraIdComboBox->currentData().toInt(); // 获取选中的摄像头ID（从userData获取）
     plan.name = m_nameEdit->text().trimmed();              // 获取方案名称并去除首尾空格
     plan.rtspUrl = m_rtspEdit->text().trimmed();           // 获取RTSP地址并去除首尾空格
+    plan.subRtspUrl = m_subRtspEdit->text().trimmed();     // 获取子码流地址
     plan.aiEnabled = m_aiCheckBox->isChecked();            // 获取AI功能开关状态
     plan.regionEnabled = m_regionCheckBox->isChecked();    // 获取区域识别开关状态
     plan.objectEnabled = m_objectCheckBox->isChecked();    // 获取对象识别开关状态
@@ -774,6 +806,7 @@ void Plan::clearForm()
     m_cameraIdComboBox->setCurrentIndex(0);
     m_nameEdit->clear();
     m_rtspEdit->clear();
+    m_subRtspEdit->clear();
     m_aiCheckBox->setChecked(false);
     m_regionCheckBox->setChecked(false);
     m_objectCheckBox->setChecked(false);
@@ -788,6 +821,7 @@ void Plan::enableFormControls(bool enabled)
     m_cameraIdComboBox->setEnabled(enabled);
     m_nameEdit->setEnabled(enabled);
     m_rtspEdit->setEnabled(enabled);
+    m_subRtspEdit->setEnabled(enabled);
     m_aiCheckBox->setEnabled(enabled);
     m_regionCheckBox->setEnabled(enabled);
     m_objectCheckBox->setEnabled(enabled);
@@ -27,7 +27,8 @@ struct PlanData {
     int id;                    // 方案ID（数据库主键）
     int cameraId;              // 摄像头ID（0表示主流，1-N表示子流）
     QString name;              // 方案名称
-    QString rtspUrl;           // RTSP地址
+    QString rtspUrl;           // RTSP地址（主码流）
+    QString subRtspUrl;        // 子码流地址（可选，多画面布局时使用）
     bool aiEnabled;            // AI识别功能使能
     bool regionEnabled;        // 区域识别功能使能
     bool objectEnabled;        // 对象识别功能使能
@@ -92,6 +93,7 @@ private:
     QComboBox* m_cameraIdComboBox;  // 摄像头ID选择（0=主流，1-N=子流）
     QLineEdit* m_nameEdit;          // 方案名称
     QLineEdit* m_rtspEdit;          // RTSP地址
+    QLineEdit* m_subRtspEdit;       // 子码流地址
     QCheckBox* m_aiCheckBox;        // AI功能
     QCheckBox* m_regionCheckBox;    // 区域识别
     QCheckBox* m_objectCheckBox;    // 对象识别
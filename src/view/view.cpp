@@ -15,21 +15,30 @@
 #include <QPoint>
 #include <QDebug>
 #include <QToolTip>
-#include <QTextBrowser>
 #include <QDateTime>
-#include <QScrollBar>
+#include <QTimer>
+#include <QMenu>
 
 View::View(QWidget* parent)
     : QWidget(parent)
     , m_hasRectangle(false)
     , m_currentLayoutMode(1)
+    , m_currentPage(0)
     , m_fullScreenStreamId(-1)
     , m_selectedStreamId(-1)
     , videoContainer(nullptr)
     , videoGridLayout(nullptr)
     , videoDisplayArea(nullptr)
     , selectedStreamLabel(nullptr)
+    , prevPageButton(nullptr)
+    , nextPageButton(nullptr)
+    , pageLabel(nullptr)
+    , m_compositorEnabled(true)
+    , m_tileScaler(new TileScaler(this))
 {  
+    // 缩放线程池的结果回到界面线程显示
+    connect(m_tileScaler, &TileScaler::frameScaled, this, &View::onTileFrameScaled);
+
     // 创建主水平布局
     QHBoxLayout* mainLayout = new QHBoxLayout(this);
     mainLayout->setContentsMargins(3, 3, 3, 3);  // 减少主布局边距适配嵌入式屏幕
@@ -113,26 +122,15 @@ void View::initleft()
     );
     eventLabel->setAlignment(Qt::AlignCenter);
     
-    // 创建事件消息文本浏览器
-    eventBrowser = new QTextBrowser(leftPanel);
-    eventBrowser->setStyleSheet(
-        "QTextBrowser {"
-        "  font-family: 'Consolas', 'Monaco', monospace;"
-        "  font-size: 12px;"
-        "  background-color: #ffffff;"
-        "  border: 1px solid #cccccc;"
-        "  border-radius: 5px;"
-        "  padding: 5px;"
-        "  selection-background-color: #3399ff;"
-        "}"
-    );
-    eventBrowser->setMinimumHeight(200);
-    eventBrowser->setMinimumWidth(140); // 减少文本浏览器宽度适配嵌入式屏幕
+    // 创建事件消息列表（固定容量，按类型和摄像头筛选）
+    eventLog = new EventLogView(5000, leftPanel);
+    eventLog->setMinimumHeight(200);
+    eventLog->setMinimumWidth(140); // 减少列表宽度适配嵌入式屏幕
     
     
     // 将控件添加到左侧布局
     leftLayout->addWidget(eventLabel);
-    leftLayout->addWidget(eventBrowser);
+    leftLayout->addWidget(eventLog);
     //leftLayout->addStretch(); // 添加弹性空间
 }
 
@@ -208,8 +206,8 @@ void View::initFunButtons()
         }
     )");
 
-    // 功能按钮文本 (新增第六个可选按钮: 报警保存)
-    QStringList btnNames = {"AI功能", "区域识别", "对象识别", "对象列表", "方案预选", "报警保存"};
+    // 功能按钮文本 (新增第六个可选按钮: 报警保存，第七个可选按钮: 性能统计)
+    QStringList btnNames = {"AI功能", "区域识别", "对象识别", "对象列表", "方案预选", "报警保存", "性能统计"};
     // 图标路径(临时复用 对象列表 图标)
     QStringList tabIconPaths = {
         ":icon/AI.png",
@@ -217,7 +215,8 @@ void View::initFunButtons()
         ":icon/object.png",
         ":icon/list.png",
         ":icon/list.png", // 方案预选 暂用
-        ":icon/AI.png"    // 报警保存 暂用 (可以后续替换为专用图标)
+        ":icon/AI.png",   // 报警保存 暂用 (可以后续替换为专用图标)
+        ":icon/list.png"  // 性能统计 暂用
     };
 
     // 功能按钮样式 - 减少padding适配嵌入式屏幕
@@ -259,8 +258,8 @@ void View::initFunButtons()
         btn->setIconSize(QSize(24, 24));                             // 减少图标大小适配嵌入式屏幕
         btn->setLayoutDirection(Qt::LeftToRight);                    // 图标在左，文字在右
         // 设置按钮的可选属性
-        if (i < 3 || i == 5) {
-            // 前三个按钮（AI功能、区域识别、对象识别）和第六个按钮（报警保存）为可选按钮
+        if (i < 3 || i == 5 || i == 6) {
+            // 前三个按钮（AI功能、区域识别、对象识别）和第六、七个按钮（报警保存、性能统计）为可选按钮
             btn->setCheckable(true);
             btn->setChecked(false);
         } else {
@@ -501,6 +500,10 @@ void View::onRectangleDrawn(const RectangleBox& rect)
 // 辅助函数：计算VideoLabel中实际图像显示区域（去除黑边）
 QRect View::getActualImageRect(VideoLabel* label) const
 {
+    // 多路视频块自行绘制视频帧，直接使用其显示区域
+    if (label && label->hasFrame()) {
+        return label->imageRect();
+    }
     if (!label || !label->pixmap()) {
         return QRect();
     }
@@ -630,46 +633,11 @@ bool View::isDrawingEnabled() const
     return false;
 }
 
-// 添加事件消息到文本浏览器
-void View::addEventMessage(const QString& type, const QString& message)
+// 添加事件消息（批量刷新到事件列表，超出容量时丢弃最早的消息）
+void View::addEventMessage(const QString& type, const QString& message, int cameraId)
 {
-    if (!eventBrowser) return;
-    
-    QString color;
-    QString prefix;
-    
-    // 根据消息类型设置颜色和前缀
-    if (type == "error") {
-        color = "#cc0000";
-        prefix = "[错误]";
-    } else if (type == "warning") {
-        color = "#ff8800";
-        prefix = "[警告]";
-    } else if (type == "success") {
-        color = "#008000";
-        prefix = "[成功]";
-    } else if (type == "info") {
-        color = "#0066cc";
-        prefix = "[信息]";
-    } else {
-        color = "#333333";
-        prefix = "[消息]";
-    }
-    
-    QString timeStamp = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
-    QString formattedMessage = QString("<span style='color: #666; font-size: 13px;'>[%1]</span> "
-                                      "<span style='color: %2; font-weight: bold;'>%3</span> "
-                                      "<span style='color: %4;'>%5</span>")
-                               .arg(timeStamp)
-                               .arg(color)
-                               .arg(prefix)
-                               .arg(color)
-                               .arg(message);
-    
-    eventBrowser->append(formattedMessage);
-    
-    // 自动滚动到底部显示最新消息
-    eventBrowser->verticalScrollBar()->setValue(eventBrowser->verticalScrollBar()->maximum());
+    if (!eventLog) return;
+    eventLog->addMessage(type, message, cameraId);
 }
 
 // 初始化多路视频流控制面板
@@ -801,6 +769,33 @@ void View::initMultiStreamControl()
     
     mainLayout->addWidget(layoutBtnWidget);
     
+    // ========== 翻页（摄像头超过一屏时） ==========
+    prevPageButton = new QPushButton("◀", multiStreamPanel);
+    prevPageButton->setStyleSheet(layoutBtnStyle);
+    prevPageButton->setToolTip("上一页");
+    connect(prevPageButton, &QPushButton::clicked, this, [this]() { showPage(m_currentPage - 1); });
+    mainLayout->addWidget(prevPageButton);
+    
+    pageLabel = new QLabel("1/1", multiStreamPanel);
+    pageLabel->setAlignment(Qt::AlignCenter);
+    pageLabel->setStyleSheet(R"(
+        QLabel {
+            font-family: "Microsoft YaHei";
+            font-size: 11px;
+            color: #333333;
+            background: transparent;
+            border: none;
+            min-width: 36px;
+        }
+    )");
+    mainLayout->addWidget(pageLabel);
+    
+    nextPageButton = new QPushButton("▶", multiStreamPanel);
+    nextPageButton->setStyleSheet(layoutBtnStyle);
+    nextPageButton->setToolTip("下一页");
+    connect(nextPageButton, &QPushButton::clicked, this, [this]() { showPage(m_currentPage + 1); });
+    mainLayout->addWidget(nextPageButton);
+    
     // 添加间距
     mainLayout->addSpacing(5); // 减少间距
     
@@ -937,9 +932,9 @@ void View::addVideoStream(int streamId, const QString& name, int cameraId)
         return;
     }
     
-    // 检查摄像头ID是否在有效范围内 (1-16)
-    if (cameraId < 1 || cameraId > 16) {
-        qWarning() << "摄像头ID" << cameraId << "超出有效范围 (1-16)";
+    // 检查摄像头ID是否在有效范围内
+    if (cameraId < 1 || cameraId > MaxCameraCount) {
+        qWarning() << "摄像头ID" << cameraId << "超出有效范围 (1-" << MaxCameraCount << ")";
         return;
     }
     
@@ -986,7 +981,7 @@ void View::addVideoStream(int streamId, const QString& name, int cameraId)
     });
     connect(label, &VideoLabel::closeStreamClicked, this, [this](int sid) {
         qDebug() << "悬停控制条：请求关闭流（ID:" << sid << "）";
-        removeVideoStream(sid);
+        emit streamCloseRequested(sid); // 由Controller停止解码并移除画面
     });
     
     // 连接双击选中信号
@@ -999,6 +994,25 @@ void View::addVideoStream(int streamId, const QString& name, int cameraId)
     connect(label, &VideoLabel::rectangleDrawn, this, &View::onRectangleDrawn);
     connect(label, &VideoLabel::rectangleConfirmed, this, &View::onRectangleConfirmed);
     connect(label, &VideoLabel::rectangleCancelled, this, &View::onRectangleCancelled);
+    
+    // 转发显示尺寸变化，解码端据此直接缩放到显示尺寸
+    connect(label, &VideoLabel::displaySizeChanged, this, &View::streamDisplaySizeChanged);
+    // 尺寸变化时只丢弃该视频块尚未完成的缩放结果
+    connect(label, &VideoLabel::displaySizeChanged, m_tileScaler, &TileScaler::invalidate);
+    
+    // 右键菜单：解码设置、连续录像
+    label->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(label, &VideoLabel::customContextMenuRequested, this, [this, label, streamId](const QPoint& pos) {
+        QMenu menu(label);
+        QAction* decoderAction = menu.addAction("解码设置...");
+        QAction* recordAction = menu.addAction(label->isRecording() ? "停止录像" : "开始录像");
+        QAction* chosen = menu.exec(label->mapToGlobal(pos));
+        if (chosen == decoderAction) {
+            emit streamDecoderSettingsRequested(streamId);
+        } else if (chosen == recordAction) {
+            emit streamRecordRequested(streamId);
+        }
+    });
     qDebug() << "已为视频流" << streamId << "（摄像头" << cameraId << "）连接绘框信号";
     
     // 保存映射关系
@@ -1012,7 +1026,10 @@ void View::addVideoStream(int streamId, const QString& name, int cameraId)
         streamSelectCombox->addItem(QString("%1 (位置:%2)").arg(name).arg(cameraId), streamId);
     }
     
-    // 更新布局
+    // 翻到新视频流所在的页并更新布局
+    if (m_fullScreenStreamId == -1) {
+        m_currentPage = pageForCamera(cameraId);
+    }
     updateVideoLayout();
     
     qDebug() << "添加视频流:" << streamId << name << "摄像头ID:" << cameraId;
@@ -1034,6 +1051,7 @@ void View::removeVideoStream(int streamId)
     }
     
     // 删除VideoLabel
+    m_tileScaler->remove(streamId);
     VideoLabel* label = videoLabels.take(streamId);
     videoGridLayout->removeWidget(label);
     label->deleteLater();
@@ -1062,15 +1080,81 @@ void View::removeVideoStream(int streamId)
 }
 
 // 更新视频帧
+// 合成模式下只保存帧并记录脏区域，由presentVideoFrames()在帧时钟末尾统一重绘
 void View::updateVideoFrame(int streamId, const QImage& frame)
 {
-    // 统一使用videoLabels中的label显示视频帧
-    VideoLabel* label = videoLabels.value(streamId, nullptr);
-    if (label && label->isVisible()) {
-        QPixmap pixmap = QPixmap::fromImage(frame);
-        label->setPixmap(pixmap.scaled(label->size(), 
-                                       Qt::KeepAspectRatio, 
-                                       Qt::SmoothTransformation));
+    VideoLabel* label = videoLabelForFrame(streamId);
+    if (!label || !label->isVisible() || frame.isNull()) {
+        return;
+    }
+    
+    // 解码端通常已按显示尺寸缩放，直接显示；尺寸不匹配（如布局刚切换、源分辨率低于显示区域）时
+    // 交给缩放线程池，界面线程继续显示上一帧，不在界面线程做平滑缩放
+    QSize tileSize = label->displaySize();
+    QSize fitted = frame.size().scaled(tileSize, Qt::KeepAspectRatio);
+    if (qAbs(fitted.width() - frame.width()) > 2 || qAbs(fitted.height() - frame.height()) > 2) {
+        m_tileScaler->submit(streamId, frame.copy(), tileSize); // 深拷贝，帧池缓冲区可以立即归还
+        return;
+    }
+    showVideoFrame(label, frame);
+}
+
+// 缩放线程池完成：视频块尺寸未再变化时显示
+void View::onTileFrameScaled(int streamId, const QImage& image, const QSize& tileSize)
+{
+    VideoLabel* label = videoLabelForFrame(streamId);
+    if (label && label->isVisible() && label->displaySize() == tileSize) {
+        showVideoFrame(label, image);
+    }
+}
+
+// 获取显示指定流视频帧的VideoLabel（MainVideoStreamId对应单路显示的videoLabel）
+VideoLabel* View::videoLabelForFrame(int streamId) const
+{
+    if (streamId == MainVideoStreamId) {
+        return videoLabel;
+    }
+    return videoLabels.value(streamId, nullptr);
+}
+
+// 保存帧到VideoLabel并安排重绘
+void View::showVideoFrame(VideoLabel* label, const QImage& frame)
+{
+    label->setFrame(frame);
+    if (m_compositorEnabled && label->parentWidget() == videoContainer) {
+        m_dirtyVideoRegion += label->geometry();
+    } else {
+        label->update();
+    }
+}
+
+// 统一重绘本次帧时钟内有新帧的视频区域：所有视频块及其叠加层在同一次绘制中完成
+void View::presentVideoFrames()
+{
+    if (m_dirtyVideoRegion.isEmpty() || !videoContainer) {
+        return;
+    }
+    videoContainer->update(m_dirtyVideoRegion);
+    m_dirtyVideoRegion = QRegion();
+}
+
+// 启用/禁用合成模式（禁用时每路收到新帧立即各自重绘）
+void View::setCompositorEnabled(bool enabled)
+{
+    m_compositorEnabled = enabled;
+    if (!enabled) {
+        presentVideoFrames();
+    }
+}
+
+// 推送所有可见视频流的显示尺寸（布局切换后由事件循环延迟调用，确保尺寸已生效）
+void View::pushStreamDisplaySizes()
+{
+    for (auto it = videoLabels.constBegin(); it != videoLabels.constEnd(); ++it) {
+        VideoLabel* label = it.value();
+        if (label && label->isVisible()) {
+            emit streamDisplaySizeChanged(it.key(), label->displaySize());
+        }
     }
 }
 
@@ -1113,7 +1197,10 @@ void View::switchToLayoutMode(int mode)
         addEventMessage("info", "已切换到多路显示，绘框信息已清除");
     }
     
+    // 保持当前页第一个位置可见
+    int firstIndex = m_currentPage * m_currentLayoutMode;
     m_currentLayoutMode = mode;
+    m_currentPage = firstIndex / mode;
     m_fullScreenStreamId = -1; // 退出全屏
     
     // 如果退出全屏，重置下拉框为"无-多路显示"
@@ -1156,6 +1243,7 @@ void View::switchToFullScreen(int streamId)
     // 切换到1路模式并更新布局（只显示选中的流）
     int oldMode = m_currentLayoutMode;
     m_currentLayoutMode = 1;
+    m_currentPage = pageForCamera(getCameraIdForStream(streamId)); // 退出全屏时回到该视频流所在的页
     
     // 同步更新布局按钮状态
     if (!layoutButtons.isEmpty()) {
@@ -1215,6 +1303,11 @@ void View::updateVideoLayout()
         videoGridLayout->addWidget(fullscreenLabel, 0, 0);
         fullscreenLabel->show();
         
+        // 布局生效后推送新的显示尺寸
+        QTimer::singleShot(0, this, &View::pushStreamDisplaySizes);
+        updatePageControls();
+        emit videoLayoutUpdated();
+        
         qDebug() << "全屏模式：显示视频流" << m_fullScreenStreamId;
         return;
     }
@@ -1229,6 +1322,8 @@ void View::updateVideoLayout()
     }
     
     int maxSlots = rows * cols;
+    m_currentPage = qBound(0, m_currentPage, getPageCount() - 1);
+    int firstCameraId = m_currentPage * maxSlots + 1; // 当前页的第一个位置
     
     // 清理旧的占位符
     for (VideoLabel* placeholder : placeholderLabels) {
@@ -1250,22 +1345,18 @@ void View::updateVideoLayout()
         videoGridLayout->setColumnStretch(i, 1);
     }
     
-    // 按照摄像头ID (1-16) 显射到网格位置（从上到下、左到右）
-    // 位置1 -> (0,0), 位置2 -> (0,1), 位置3 -> (0,2), 位置4 -> (0,3)
-    // 位置5 -> (1,0), ... 位置16 -> (3,3)
+    // 按照摄像头ID映射到当前页的网格位置（从上到下、左到右）
+    // 如16路第1页：位置17 -> (0,0), 位置18 -> (0,1), ... 位置32 -> (3,3)
     
     // 先创建n×n的虚线框架，并根据摄像头ID放置视频流
-    for (int cameraId = 1; cameraId <= maxSlots; ++cameraId) {
-        // 计算该摄像头ID对应的网格位置（从上到下、左到右）
-        int index = cameraId - 1;  // 转换为0-based索引
-        int row = index / 4;  // 始终按4列布局计算位置
-        int col = index % 4;
-        
-        // 对于小于4x4的布局，需要调整行列
-        if (m_currentLayoutMode < 16) {
-            row = index / cols;
-            col = index % cols;
+    for (int index = 0; index < maxSlots; ++index) {
+        int cameraId = firstCameraId + index;
+        if (cameraId > MaxCameraCount) {
+            break; // 最后一页不足一屏
         }
+        // 计算该摄像头ID对应的网格位置（从上到下、左到右）
+        int row = index / cols;
+        int col = index % cols;
         
         // 检查该摄像头ID是否有视频流
         if (cameraIdMap.contains(cameraId)) {
@@ -1307,10 +1398,10 @@ void View::updateVideoLayout()
         }
     }
     
-    // 隐藏超出当前布局模式范围的视频流
+    // 隐藏不在当前页的视频流（Controller据此降低或停止其解码）
     for (int streamId : videoLabels.keys()) {
         int cameraId = streamToCameraMap.value(streamId, -1);
-        if (cameraId > maxSlots) {
+        if (cameraId < firstCameraId || cameraId >= firstCameraId + maxSlots) {
             VideoLabel* label = videoLabels.value(streamId);
             if (label) {
                 label->hide();
@@ -1318,7 +1409,12 @@ void View::updateVideoLayout()
         }
     }
     
-    qDebug() << "更新视频布局:" << m_currentLayoutMode << "路, 显示" 
+    // 布局生效后推送新的显示尺寸
+    QTimer::singleShot(0, this, &View::pushStreamDisplaySizes);
+    updatePageControls();
+    emit videoLayoutUpdated();
+    
+    qDebug() << "更新视频布局:" << m_currentLayoutMode << "路, 第" << m_currentPage + 1 << "页, 显示" 
              << videoLabels.size() << "个流，占位符" << placeholderLabels.size() << "个";
 }
 
@@ -1353,6 +1449,7 @@ void View::clearAllStreams()
     // 重置状态
     m_fullScreenStreamId = -1;
     m_currentLayoutMode = 1;
+    m_currentPage = 0;
     
     // 更新布局，显示默认的1路占位符
     updateVideoLayout();
@@ -1366,11 +1463,11 @@ bool View::isCameraIdOccupied(int cameraId) const
     return cameraIdMap.contains(cameraId);
 }
 
-// 获取可用的摄像头ID列表（1-16）
+// 获取可用的摄像头ID列表（1-MaxCameraCount）
 QList<int> View::getAvailableCameraIds() const
 {
     QList<int> availableIds;
-    for (int id = 1; id <= 16; ++id) {
+    for (int id = 1; id <= MaxCameraCount; ++id) {
         if (!cameraIdMap.contains(id)) {
             availableIds.append(id);
         }
@@ -1378,12 +1475,79 @@ QList<int> View::getAvailableCameraIds() const
     return availableIds;
 }
 
+// 获取页数：覆盖已使用的最大位置，并多留一个空闲位置用于添加
+int View::getPageCount() const
+{
+    int highestCameraId = cameraIdMap.isEmpty() ? 0 : cameraIdMap.lastKey();
+    int positions = qMin(highestCameraId + 1, static_cast<int>(MaxCameraCount));
+    return qMax(1, (positions + m_currentLayoutMode - 1) / m_currentLayoutMode);
+}
+
+// 摄像头位置在当前布局下所在的页
+int View::pageForCamera(int cameraId) const
+{
+    return qMax(0, cameraId - 1) / m_currentLayoutMode;
+}
+
+// 切换到指定页（全屏时先退出全屏）
+void View::showPage(int page)
+{
+    page = qBound(0, page, getPageCount() - 1);
+    if (page == m_currentPage && m_fullScreenStreamId == -1) {
+        return;
+    }
+    m_currentPage = page;
+    if (m_fullScreenStreamId != -1) {
+        switchToLayoutMode(m_currentLayoutMode);
+    } else {
+        updateVideoLayout();
+    }
+    addEventMessage("info", QString("切换到第 %1/%2 页").arg(m_currentPage + 1).arg(getPageCount()));
+}
+
+// 更新翻页按钮和页码（全屏时不可翻页）
+void View::updatePageControls()
+{
+    if (!pageLabel) {
+        return;
+    }
+    int pageCount = getPageCount();
+    bool fullScreen = (m_fullScreenStreamId != -1);
+    pageLabel->setText(QString("%1/%2").arg(m_currentPage + 1).arg(pageCount));
+    prevPageButton->setEnabled(!fullScreen && m_currentPage > 0);
+    nextPageButton->setEnabled(!fullScreen && m_currentPage < pageCount - 1);
+}
+
 // 获取视频流对应的摄像头ID
 int View::getCameraIdForStream(int streamId) const
 {
     return streamToCameraMap.value(streamId, -1);
 }
 
+// 设置视频流的性能统计叠加文本
+void View::setStreamStatsText(int streamId, const QString& text)
+{
+    VideoLabel* label = videoLabels.value(streamId, nullptr);
+    if (label) {
+        label->setStatsText(text);
+    }
+}
+
+void View::setStreamRecording(int streamId, bool recording)
+{
+    VideoLabel* label = videoLabels.value(streamId, nullptr);
+    if (label) {
+        label->setRecording(recording);
+    }
+}
+
+// 视频流在当前布局中是否显示（使用显式隐藏状态，窗口尚未显示时也能正确判断）
+bool View::isStreamShown(int streamId) const
+{
+    VideoLabel* label = videoLabels.value(streamId, nullptr);
+    return label && !label->isHidden();
+}
+
 // 获取视频流名称
 QString View::getStreamName(int streamId) const
 {
@@ -1532,14 +1696,13 @@ QImage View::getCurrentFrameForCamera(int cameraId)
     
     // 获取该流的VideoLabel
     VideoLabel* label = getVideoLabelForStream(streamId);
-    if (!label || label->pixmap() == nullptr) {
+    if (!label || !label->hasFrame()) {
         qDebug() << "警告：摄像头" << cameraId << "的VideoLabel没有图像";
         return QImage();
     }
     
-    // 从QPixmap转换为QImage
-    QPixmap pixmap = *label->pixmap();
-    QImage image = pixmap.toImage();
+    // 当前帧（隐式共享，VideoLabel写入下一帧时自动分离）
+    QImage image = label->currentFrame();
     
     qDebug() << "获取摄像头" << cameraId << "的当前帧图像，尺寸:" << image.size();
     return image;
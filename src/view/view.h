@@ -8,10 +8,12 @@
 #include <QPainter>
 #include <QMouseEvent>
 #include <QRect>
-#include <QTextBrowser>
+#include <QRegion>
 #include <QGridLayout>
 #include <QMap>
 #include "VideoLabel.h"
+#include "TileScaler.h"
+#include "EventLogView.h"
 #include "common.h"
 
 class View : public QWidget {
@@ -37,19 +39,31 @@ public:
     bool isDrawingEnabled() const;
     
     // 事件消息相关方法
-    void addEventMessage(const QString& type, const QString& message);
+    // 类型：info/success/warning/error/alarm；cameraId为消息所属的摄像头（-1表示无，用于筛选）
+    void addEventMessage(const QString& type, const QString& message, int cameraId = -1);
     
     // ========== 多路视频流管理方法 ==========
     void addVideoStream(int streamId, const QString& name, int cameraId);     // 添加视频流（指定摄像头ID）
     void removeVideoStream(int streamId);                       // 删除视频流
     bool isCameraIdOccupied(int cameraId) const;                // 检查摄像头ID是否已被占用
-    QList<int> getAvailableCameraIds() const;                   // 获取可用的摄像头ID列表（1-16）
-    void updateVideoFrame(int streamId, const QImage& frame);   // 更新视频帧
+    static const int MaxCameraCount = 256;                      // 摄像头位置数量（超过一屏时分页显示）
+    QList<int> getAvailableCameraIds() const;                   // 获取可用的摄像头ID列表（1-MaxCameraCount）
+    static const int MainVideoStreamId = -1;                    // 单路显示videoLabel对应的流ID（用于updateVideoFrame）
+    void updateVideoFrame(int streamId, const QImage& frame);   // 更新视频帧（合成模式下延迟到presentVideoFrames()统一重绘）
+    void presentVideoFrames();                                  // 统一重绘本次帧时钟内更新的视频块（每次屏幕刷新调用一次）
+    void setCompositorEnabled(bool enabled);                    // 启用/禁用合成模式
+    bool isCompositorEnabled() const { return m_compositorEnabled; }
     VideoLabel* getVideoLabelForStream(int streamId);           // 获取指定流的VideoLabel
     void switchToLayoutMode(int mode);                          // 切换布局模式
     void switchToFullScreen(int streamId);                      // 切换到单路全屏
     void clearAllStreams();                                     // 清除所有视频流
     int getCurrentLayoutMode() const { return m_currentLayoutMode; } // 获取当前布局模式
+    // 分页：每页按布局模式显示连续的摄像头位置（如16路时第2页为位置17-32）
+    void showPage(int page);                                    // 切换到指定页（从0开始）
+    int getCurrentPage() const { return m_currentPage; }        // 获取当前页
+    int getPageCount() const;                                   // 获取页数（已用的最大位置之后多留一个空闲位置）
+    int pageForCamera(int cameraId) const;                      // 摄像头位置在当前布局下所在的页
+    bool isStreamShown(int streamId) const;                     // 视频流在当前布局中是否显示
     int getCameraIdForStream(int streamId) const;               // 获取视频流对应的摄像头ID
     QString getStreamName(int streamId) const;                  // 获取视频流名称
     void selectVideoStream(int streamId);                       // 选中视频流
@@ -59,6 +73,8 @@ public:
     void setStreamBoundIp(int streamId, const QString& ip);     // 设置视频流绑定的IP地址
     void setCameraBoundIp(int cameraId, const QString& ip);     // 设置摄像头绑定的IP地址（通过摄像头ID）
     QImage getCurrentFrameForCamera(int cameraId);              // 获取指定摄像头的当前帧图像
+    void setStreamStatsText(int streamId, const QString& text); // 设置视频流的性能统计叠加文本（为空时隐藏）
+    void setStreamRecording(int streamId, bool recording);      // 设置视频流的连续录像状态（显示录像标记）
 
 signals:
     void rectangleConfirmed(const RectangleBox& rect); // 矩形框确认信号
@@ -67,12 +83,18 @@ signals:
     void streamSelected(int streamId); // 视频流选中信号
     void streamPauseRequested(int streamId); // 请求暂停流
     void streamScreenshotRequested(int streamId); // 请求截图流
+    void streamCloseRequested(int streamId); // 请求关闭流
     void addCameraWithIdRequested(int cameraId); // 请求添加指定ID的摄像头
+    void streamDisplaySizeChanged(int streamId, const QSize& size); // 视频流显示尺寸变化（用于解码端直接缩放）
+    void videoLayoutUpdated(); // 视频布局已更新（各路可见性或布局模式发生变化）
+    void streamDecoderSettingsRequested(int streamId); // 请求修改视频流解码设置
+    void streamRecordRequested(int streamId); // 请求开始/停止视频流的连续录像
 
 private slots:
     void onRectangleDrawn(const RectangleBox& rect); // 处理矩形框绘制完成
     void onRectangleConfirmed(const RectangleBox& rect); // 处理矩形框确认
     void onRectangleCancelled(); // 处理矩形框取消
+    void onTileFrameScaled(int streamId, const QImage& image, const QSize& tileSize); // 缩放线程池完成
 
 private:
     void initleft();       // 初始化左边面板
@@ -86,7 +108,11 @@ private:
     void initMultiStreamControl(); // 初始化多路视频流控制面板
     void initVideoContainer();     // 初始化多路视频容器
     void updateVideoLayout();      // 更新视频布局
+    void pushStreamDisplaySizes(); // 推送所有可见视频流的显示尺寸
+    void updatePageControls();     // 更新翻页按钮和页码
     QRect getActualImageRect(VideoLabel* label) const; // 计算VideoLabel中实际图像显示区域（去除黑边）
+    VideoLabel* videoLabelForFrame(int streamId) const; // 获取显示指定流视频帧的VideoLabel
+    void showVideoFrame(VideoLabel* label, const QImage& frame); // 保存帧到VideoLabel并安排重绘
 
     QList<QPushButton*> tabButtons;  // 存储所有标签按钮的列表
     QList<QPushButton*> ServoButtons;// 存储舵机所有按钮的列表
@@ -98,7 +124,7 @@ private:
     QSlider* stepSlider;       //步进滑块
     QComboBox* stepCombox;     //步进下拉框
     QLabel* eventLabel;        //事件消息框标签
-    QTextBrowser* eventBrowser; //事件消息显示框
+    EventLogView* eventLog; //事件消息列表
 
     QWidget* leftPanel;    //左边整体面板
     QWidget* funPanel;     //中上方功能面板
@@ -110,6 +136,9 @@ private:
     QWidget* multiStreamPanel; // 多路视频流控制面板
     QComboBox* streamSelectCombox; // 视频流选择下拉框
     QLabel* selectedStreamLabel;   // 显示当前选中的视频流标签
+    QPushButton* prevPageButton;   // 上一页按钮
+    QPushButton* nextPageButton;   // 下一页按钮
+    QLabel* pageLabel;             // 页码标签
     int m_selectedStreamId;        // 当前选中的视频流ID (-1表示未选中)
 
     // ========== 多路视频流相关成员 ==========
@@ -117,12 +146,16 @@ private:
     QGridLayout* videoGridLayout;      // 网格布局
     QMap<int, VideoLabel*> videoLabels;// 视频流ID -> VideoLabel映射
     QMap<int, QString> streamNames;    // 视频流ID -> 名称映射
-    QMap<int, int> cameraIdMap;        // 摄像头ID (1-16) -> 视频流ID的映射
-    QMap<int, int> streamToCameraMap;  // 视频流ID -> 摄像头ID (1-16) 的映射
+    QMap<int, int> cameraIdMap;        // 摄像头ID (1-MaxCameraCount) -> 视频流ID的映射
+    QMap<int, int> streamToCameraMap;  // 视频流ID -> 摄像头ID (1-MaxCameraCount) 的映射
     QList<VideoLabel*> placeholderLabels;  // 占位符标签列表（显示虚线框架，使用VideoLabel支持悬停控制条）
     int m_currentLayoutMode;           // 当前布局模式 (1,4,9,16)
+    int m_currentPage;                 // 当前页（从0开始）
     int m_fullScreenStreamId;          // 全屏显示的流ID (-1表示无)
     QWidget* videoDisplayArea;         // 视频显示区域（放置videoLabel或videoContainer）
+    bool m_compositorEnabled;          // 合成模式：按帧时钟统一重绘所有有新帧的视频块
+    QRegion m_dirtyVideoRegion;        // 本次帧时钟内有新帧的区域（videoContainer坐标）
+    TileScaler* m_tileScaler;          // 视频块缩放线程池（帧尺寸与显示尺寸不一致时使用）
 
     // 绘框相关成员变量
     RectangleBox m_rectangle;      // 当前绘制的矩形框